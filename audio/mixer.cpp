@@ -21,6 +21,7 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/config-manager.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 
@@ -197,12 +198,16 @@ private:
 #pragma mark -
 
 MixerImpl::MixerImpl(uint sampleRate, bool stereo, uint outBufSize)
-	: _mutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize),
+	  _resamplerQuality(MAX(ConfMan.getInt("resampler_quality"), 0)), _mixerReady(false), _handleSeed(0), _soundTypeSettings(),
+	  _commandHead(0), _commandTail(0) {
 
 	assert(sampleRate > 0);
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
+	for (int i = 0; i != NUM_CHANNELS; i++) {
 		_channels[i] = nullptr;
+		_status[i].handle = 0xFFFFFFFF;
+	}
 }
 
 MixerImpl::~MixerImpl() {
@@ -228,6 +233,10 @@ uint MixerImpl::getOutputBufSize() const {
 	return _outBufSize;
 }
 
+int MixerImpl::getResamplerQuality() const {
+	return _resamplerQuality;
+}
+
 void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	int index = -1;
 	for (int i = 0; i != NUM_CHANNELS; i++) {
@@ -251,6 +260,118 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	_handleSeed++;
 	if (handle)
 		*handle = chanHandle;
+
+	Common::StackLock commandLock(_commandMutex);
+	ChannelStatus &status = _status[index];
+	status.id = chan->getId();
+	status.type = chan->getType();
+	status.volume = chan->getVolume();
+	status.balance = chan->getBalance();
+	status.rate = status.nativeRate = chan->getRate();
+	Common::atomicStore(&status.handle, chanHandle._val);
+}
+
+void MixerImpl::freeChannel(int index) {
+	delete _channels[index];
+	_channels[index] = nullptr;
+	Common::atomicStore(&_status[index].handle, (uint32)0xFFFFFFFF);
+}
+
+int MixerImpl::findStatus(SoundHandle handle) const {
+	const int index = handle._val % NUM_CHANNELS;
+	if (Common::atomicLoad(&_status[index].handle) != handle._val)
+		return -1;
+	return index;
+}
+
+void MixerImpl::queueCommand(CommandType type, SoundHandle handle, uint32 value) {
+	Command cmd;
+	cmd.type = type;
+	cmd.handle = handle._val;
+	cmd.value = value;
+
+	{
+		Common::StackLock commandLock(_commandMutex);
+
+		// Simply ignore requests for handles of sounds that already terminated
+		const int index = findStatus(handle);
+		if (index < 0)
+			return;
+
+		if (_commandHead - Common::atomicLoad(&_commandTail) < NUM_COMMANDS) {
+			pushCommand(index, cmd);
+			return;
+		}
+	}
+
+	// The queue is full, so nobody is draining it. Do that ourselves; the
+	// lock order is _mutex before _commandMutex.
+	Common::StackLock lock(_mutex);
+	Common::StackLock commandLock(_commandMutex);
+	processCommands();
+
+	const int index = findStatus(handle);
+	if (index >= 0)
+		pushCommand(index, cmd);
+}
+
+void MixerImpl::pushCommand(int index, const Command &cmd) {
+	_commands[_commandHead % NUM_COMMANDS] = cmd;
+	Common::atomicStore(&_commandHead, _commandHead + 1);
+
+	ChannelStatus &status = _status[index];
+	switch (cmd.type) {
+	case kCommandVolume:
+		Common::atomicStore(&status.volume, (int)cmd.value);
+		break;
+	case kCommandBalance:
+		Common::atomicStore(&status.balance, (int)(int8)cmd.value);
+		break;
+	case kCommandRate:
+		Common::atomicStore(&status.rate, cmd.value);
+		break;
+	case kCommandResetRate:
+		Common::atomicStore(&status.rate, (uint32)status.nativeRate);
+		break;
+	default:
+		break;
+	}
+}
+
+void MixerImpl::processCommands() {
+	const uint32 head = Common::atomicLoad(&_commandHead);
+	uint32 tail = _commandTail;
+
+	while (tail != head) {
+		applyCommand(_commands[tail % NUM_COMMANDS]);
+		tail++;
+	}
+
+	Common::atomicStore(&_commandTail, tail);
+}
+
+void MixerImpl::applyCommand(const Command &cmd) {
+	const int index = cmd.handle % NUM_CHANNELS;
+	Channel *chan = _channels[index];
+	if (!chan || chan->getHandle()._val != cmd.handle)
+		return;
+
+	switch (cmd.type) {
+	case kCommandVolume:
+		chan->setVolume(cmd.value);
+		break;
+	case kCommandBalance:
+		chan->setBalance((int8)cmd.value);
+		break;
+	case kCommandRate:
+		chan->setRate(cmd.value);
+		break;
+	case kCommandResetRate:
+		chan->resetRate();
+		break;
+	default:
+		break;
+	}
 }
 
 void MixerImpl::playStream(
@@ -320,13 +441,15 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 		len >>= 1;
 	}
 
+	// apply the parameter changes queued since the last callback
+	processCommands();
+
 	// mix all channels
 	int res = 0, tmp;
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i]) {
 			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = nullptr;
+				freeChannel(i);
 			} else if (!_channels[i]->isPaused()) {
 				tmp = _channels[i]->mix(buf, len);
 
@@ -341,20 +464,16 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 void MixerImpl::stopAll() {
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = nullptr;
-		}
+		if (_channels[i] != nullptr && !_channels[i]->isPermanent())
+			freeChannel(i);
 	}
 }
 
 void MixerImpl::stopID(int id) {
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = nullptr;
-		}
+		if (_channels[i] != nullptr && _channels[i]->getId() == id)
+			freeChannel(i);
 	}
 }
 
@@ -366,8 +485,7 @@ void MixerImpl::stopHandle(SoundHandle handle) {
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return;
 
-	delete _channels[index];
-	_channels[index] = nullptr;
+	freeChannel(index);
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
@@ -386,67 +504,57 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 }
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setVolume(volume);
+	queueCommand(kCommandVolume, handle, volume);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findStatus(handle);
+	if (index < 0)
 		return 0;
 
-	return _channels[index]->getVolume();
+	const int value = Common::atomicLoad(&_status[index].volume);
+	if (Common::atomicLoad(&_status[index].handle) != handle._val)
+		return 0;
+
+	return value;
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setBalance(balance);
+	queueCommand(kCommandBalance, handle, (uint8)balance);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findStatus(handle);
+	if (index < 0)
+		return 0;
+
+	const int value = Common::atomicLoad(&_status[index].balance);
+	if (Common::atomicLoad(&_status[index].handle) != handle._val)
 		return 0;
 
-	return _channels[index]->getBalance();
+	return value;
 }
 
 void MixerImpl::setChannelRate(SoundHandle handle, uint32 rate) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setRate(rate);
+	// Build the filter for the new rate here rather than in the callback
+	prepareRateConverter(rate, _sampleRate, _resamplerQuality);
+	queueCommand(kCommandRate, handle, rate);
 }
 
 uint32 MixerImpl::getChannelRate(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findStatus(handle);
+	if (index < 0)
 		return 0;
-	
-	return _channels[index]->getRate();
+
+	const uint32 value = Common::atomicLoad(&_status[index].rate);
+	if (Common::atomicLoad(&_status[index].handle) != handle._val)
+		return 0;
+
+	return value;
 }
 
 void MixerImpl::resetChannelRate(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-	
-	_channels[index]->resetRate();
+	queueCommand(kCommandResetRate, handle, 0);
 }
 
 uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
@@ -504,42 +612,46 @@ void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
 }
 
 bool MixerImpl::isSoundIDActive(int id) {
-	Common::StackLock lock(_mutex);
-
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getId() == id)
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		const uint32 handle = Common::atomicLoad(&_status[i].handle);
+		if (handle != 0xFFFFFFFF && Common::atomicLoad(&_status[i].id) == id &&
+		    Common::atomicLoad(&_status[i].handle) == handle)
 			return true;
+	}
 	return false;
 }
 
 int MixerImpl::getSoundID(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-	const int index = handle._val % NUM_CHANNELS;
-	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
-		return _channels[index]->getId();
-	return 0;
+	const int index = findStatus(handle);
+	if (index < 0)
+		return 0;
+
+	const int id = Common::atomicLoad(&_status[index].id);
+	if (Common::atomicLoad(&_status[index].handle) != handle._val)
+		return 0;
+
+	return id;
 }
 
 bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
-	const int index = handle._val % NUM_CHANNELS;
-	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
+	return findStatus(handle) >= 0;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getType() == type)
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		const uint32 handle = Common::atomicLoad(&_status[i].handle);
+		if (handle != 0xFFFFFFFF && Common::atomicLoad(&_status[i].type) == (int)type &&
+		    Common::atomicLoad(&_status[i].handle) == handle)
 			return true;
+	}
 	return false;
 }
 
@@ -582,7 +694,7 @@ Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
 	assert(stream);
 
 	// Get a rate converter instance
-	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), mixer->getOutputStereo(), reverseStereo);
+	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), mixer->getOutputStereo(), reverseStereo, mixer->getResamplerQuality());
 }
 
 Channel::~Channel() {
@@ -220,6 +220,9 @@ public:
 	/**
 	 * Set the channel volume for the given handle.
 	 *
+	 * The change is queued and takes effect asynchronously, at the next
+	 * mixCallback. The getter reports the new value right away.
+	 *
 	 * @param handle  The sound to affect.
 	 * @param volume  The new channel volume, in the range 0 - kMaxChannelVolume.
 	 */
@@ -237,6 +240,9 @@ public:
 	/**
 	 * Set the channel balance for the given handle.
 	 *
+	 * The change is queued and takes effect asynchronously, at the next
+	 * mixCallback. The getter reports the new value right away.
+	 *
 	 * @param handle   The sound to affect.
 	 * @param balance  The new channel balance:
 	 *                 (-127 ... 0 ... 127) corresponds to (left ... center ... right)
@@ -255,6 +261,9 @@ public:
 	/**
 	 * Set the sample rate for the given handle.
 	 *
+	 * The change is queued and takes effect asynchronously, at the next
+	 * mixCallback. The getter reports the new value right away.
+	 *
 	 * @param handle 	The sound to affect.
 	 * @param rate		The new sample rate. Must be less than 131072
 	*/
@@ -273,6 +282,8 @@ public:
 	 * Reset the sample rate of the channel back to its
 	 * AudioStream's native rate.
 	 *
+	 * Like setChannelRate, this takes effect at the next mixCallback.
+	 *
 	 * @param handle 	The sound to affect.
 	*/
 	virtual void resetChannelRate(SoundHandle handle) = 0;
@@ -345,6 +356,14 @@ public:
 	 * @return The number of samples processed at each audio callback.
 	 */
 	virtual uint getOutputBufSize() const = 0;
+
+	/**
+	 * Return the quality rate converters are created with, as read from
+	 * the "resampler_quality" config key when the mixer was created.
+	 *
+	 * @return 0 for linear interpolation, 1 to 3 for windowed sinc filters.
+	 */
+	virtual int getResamplerQuality() const = 0;
 };
 
 /** @} */
@@ -23,6 +23,7 @@
 #define AUDIO_MIXER_INTERN_H
 
 #include "common/scummsys.h"
+#include "common/atomic.h"
 #include "common/mutex.h"
 #include "audio/mixer.h"
 
@@ -58,7 +59,8 @@ namespace Audio {
 class MixerImpl : public Mixer {
 private:
 	enum {
-		NUM_CHANNELS = 32
+		NUM_CHANNELS = 32,
+		NUM_COMMANDS = 64
 	};
 
 	Common::Mutex _mutex;
@@ -66,6 +68,7 @@ private:
 	const uint _sampleRate;
 	const bool _stereo;
 	const uint _outBufSize;
+	const int _resamplerQuality;
 	bool _mixerReady;
 	uint32 _handleSeed;
 
@@ -79,6 +82,50 @@ private:
 	SoundTypeSettings _soundTypeSettings[4];
 	Channel *_channels[NUM_CHANNELS];
 
+	/**
+	 * Per channel state published for the query methods, so that polling
+	 * the status of a sound never has to wait for the mixer thread.
+	 *
+	 * The handle is 0xFFFFFFFF for free slots. All other fields are only
+	 * meaningful while the handle matches the one being queried. Writers
+	 * hold _commandMutex; freeing a slot only needs _mutex, since the
+	 * fields of a free slot are never looked at.
+	 */
+	struct ChannelStatus {
+		volatile uint32 handle;
+		volatile int id;
+		volatile int type;
+		volatile int volume;
+		volatile int balance;
+		volatile uint32 rate;
+		volatile uint32 nativeRate;
+	};
+
+	ChannelStatus _status[NUM_CHANNELS];
+
+	enum CommandType {
+		kCommandVolume,
+		kCommandBalance,
+		kCommandRate,
+		kCommandResetRate
+	};
+
+	struct Command {
+		CommandType type;
+		uint32 handle;
+		uint32 value;
+	};
+
+	/**
+	 * Single producer, single consumer ring of channel parameter changes.
+	 * Producers serialize on _commandMutex, the consumer is whoever holds
+	 * _mutex, which in practice is mixCallback().
+	 */
+	Command _commands[NUM_COMMANDS];
+	volatile uint32 _commandHead;
+	volatile uint32 _commandTail;
+	Common::Mutex _commandMutex;
+
 
 public:
 
@@ -135,10 +182,40 @@ public:
 	virtual uint getOutputRate() const;
 	virtual bool getOutputStereo() const;
 	virtual uint getOutputBufSize() const;
+	virtual int getResamplerQuality() const;
 
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
 
+private:
+	/**
+	 * Remove the channel in the given slot and mark the slot as free.
+	 * Must be called with _mutex held.
+	 */
+	void freeChannel(int index);
+
+	/**
+	 * Find the published status of a playing sound.
+	 *
+	 * @return the slot index, or -1 if the handle is no longer active.
+	 */
+	int findStatus(SoundHandle handle) const;
+
+	/**
+	 * Queue a parameter change for the given sound and publish its new
+	 * value. Only blocks on the mixer if the queue is full, which happens
+	 * when the mixer callback is not being called.
+	 */
+	void queueCommand(CommandType type, SoundHandle handle, uint32 value);
+	void pushCommand(int index, const Command &cmd);
+
+	/**
+	 * Apply all queued parameter changes. Must be called with _mutex held.
+	 */
+	void processCommands();
+
+	void applyCommand(const Command &cmd);
+
 public:
 	/**
 	 * The mixer callback function, to be called at regular intervals by
@@ -0,0 +1,139 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "audio/rate_intern.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+namespace Audio {
+
+// Computes (x * vol) / kMaxMixerVolume for each lane, rounding towards
+// zero like the C division in the generic code.
+static FORCEINLINE int16x4_t neon_scale(int16x4_t x, int16x4_t vol) {
+	int32x4_t p = vmull_s16(x, vol);
+	p = vaddq_s32(p, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(p, 31)), 24)));
+	return vqmovn_s32(vshrq_n_s32(p, 8));
+}
+
+static FORCEINLINE int16x8_t neon_scale(int16x8_t x, int16x8_t vol) {
+	return vcombine_s16(neon_scale(vget_low_s16(x), vget_low_s16(vol)), neon_scale(vget_high_s16(x), vget_high_s16(vol)));
+}
+
+// Averages the scaled left and right samples of four interleaved frames,
+// again rounding towards zero.
+static FORCEINLINE int16x4_t neon_downmix(int16x8_t x, int16x8_t vol) {
+	const int32x4_t sum = vpaddlq_s16(neon_scale(x, vol));
+	return vmovn_s32(vshrq_n_s32(vaddq_s32(sum, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(sum), 31))), 1));
+}
+
+static FORCEINLINE void neon_accumulate(st_sample_t *out, int16x8_t x) {
+	vst1q_s16(out, vqaddq_s16(vld1q_s16(out), x));
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+static void mixSamplesNEON(st_sample_t *out, const st_sample_t *in, st_size_t frames, st_volume_t volL, st_volume_t volR) {
+	const int16 first = reverseStereo ? volR : volL;
+	const int16 second = reverseStereo ? volL : volR;
+	const int16 volLanes[8] = { first, second, first, second, first, second, first, second };
+	const int16x8_t vol = vld1q_s16(volLanes);
+
+	// Eight output samples per iteration
+	const st_size_t step = outStereo ? 4 : 8;
+	st_size_t i = 0;
+
+	for (; i + step <= frames; i += step) {
+		if (inStereo && outStereo) {
+			int16x8_t x = vld1q_s16(in);
+			if (reverseStereo)
+				x = vrev32q_s16(x);
+			neon_accumulate(out, neon_scale(x, vol));
+			in += 8;
+			out += 8;
+		} else if (!inStereo && outStereo) {
+			const int16x4_t x = vld1_s16(in);
+			const int16x4x2_t dup = vzip_s16(x, x);
+			neon_accumulate(out, neon_scale(vcombine_s16(dup.val[0], dup.val[1]), vol));
+			in += 4;
+			out += 8;
+		} else if (inStereo) {
+			neon_accumulate(out, vcombine_s16(neon_downmix(vld1q_s16(in), vol), neon_downmix(vld1q_s16(in + 8), vol)));
+			in += 16;
+			out += 8;
+		} else {
+			const int16x8x2_t dup = vzipq_s16(vld1q_s16(in), vld1q_s16(in));
+			neon_accumulate(out, vcombine_s16(neon_downmix(dup.val[0], vol), neon_downmix(dup.val[1], vol)));
+			in += 8;
+			out += 8;
+		}
+	}
+
+	mixSamplesGeneric<inStereo, outStereo, reverseStereo>(out, in, frames - i, volL, volR);
+}
+
+const MixSamplesFunc mixSamplesNEONFuncs[kMixLayoutCount] = {
+	mixSamplesNEON<false, false, false>,
+	mixSamplesNEON<false, true, false>,
+	mixSamplesNEON<true, false, false>,
+	mixSamplesNEON<true, true, false>,
+	mixSamplesNEON<true, true, true>
+};
+
+int32 dotProductNEON(const int16 *a, const int16 *b, uint count) {
+	int32x4_t sum = vdupq_n_s32(0);
+	for (uint i = 0; i < count; i += 8) {
+		const int16x8_t x = vld1q_s16(a + i);
+		const int16x8_t y = vld1q_s16(b + i);
+		sum = vmlal_s16(sum, vget_low_s16(x), vget_low_s16(y));
+		sum = vmlal_s16(sum, vget_high_s16(x), vget_high_s16(y));
+	}
+
+	const int32x2_t half = vadd_s32(vget_low_s32(sum), vget_high_s32(sum));
+	return vget_lane_s32(vpadd_s32(half, half), 0);
+}
+
+} // End of namespace Audio
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#endif // SCUMMVM_NEON
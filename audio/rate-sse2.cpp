@@ -0,0 +1,134 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "audio/rate_intern.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace Audio {
+
+// Computes (x * vol) / kMaxMixerVolume for each lane as 32 bit values,
+// rounding towards zero like the C division in the generic code.
+static FORCEINLINE __m128i scaleLo(__m128i x, __m128i vol) {
+	const __m128i p = _mm_unpacklo_epi16(_mm_mullo_epi16(x, vol), _mm_mulhi_epi16(x, vol));
+	return _mm_srai_epi32(_mm_add_epi32(p, _mm_srli_epi32(_mm_srai_epi32(p, 31), 24)), 8);
+}
+
+static FORCEINLINE __m128i scaleHi(__m128i x, __m128i vol) {
+	const __m128i p = _mm_unpackhi_epi16(_mm_mullo_epi16(x, vol), _mm_mulhi_epi16(x, vol));
+	return _mm_srai_epi32(_mm_add_epi32(p, _mm_srli_epi32(_mm_srai_epi32(p, 31), 24)), 8);
+}
+
+static FORCEINLINE __m128i scale(__m128i x, __m128i vol) {
+	return _mm_packs_epi32(scaleLo(x, vol), scaleHi(x, vol));
+}
+
+// Averages the scaled left and right samples of four interleaved frames,
+// again rounding towards zero.
+static FORCEINLINE __m128i downmix(__m128i x, __m128i vol) {
+	const __m128i sum = _mm_madd_epi16(scale(x, vol), _mm_set1_epi16(1));
+	return _mm_srai_epi32(_mm_add_epi32(sum, _mm_srli_epi32(sum, 31)), 1);
+}
+
+static FORCEINLINE void accumulate(st_sample_t *out, __m128i x) {
+	_mm_storeu_si128((__m128i *)out, _mm_adds_epi16(_mm_loadu_si128((const __m128i *)out), x));
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+static void mixSamplesSSE2(st_sample_t *out, const st_sample_t *in, st_size_t frames, st_volume_t volL, st_volume_t volR) {
+	const __m128i vol = reverseStereo ? _mm_set1_epi32((volL << 16) | volR) : _mm_set1_epi32((volR << 16) | volL);
+
+	// Eight output samples per iteration
+	const st_size_t step = outStereo ? 4 : 8;
+	st_size_t i = 0;
+
+	for (; i + step <= frames; i += step) {
+		if (inStereo && outStereo) {
+			__m128i x = _mm_loadu_si128((const __m128i *)in);
+			if (reverseStereo)
+				x = _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+			accumulate(out, scale(x, vol));
+			in += 8;
+			out += 8;
+		} else if (!inStereo && outStereo) {
+			const __m128i x = _mm_loadl_epi64((const __m128i *)in);
+			accumulate(out, scale(_mm_unpacklo_epi16(x, x), vol));
+			in += 4;
+			out += 8;
+		} else if (inStereo) {
+			const __m128i lo = _mm_loadu_si128((const __m128i *)in);
+			const __m128i hi = _mm_loadu_si128((const __m128i *)(in + 8));
+			accumulate(out, _mm_packs_epi32(downmix(lo, vol), downmix(hi, vol)));
+			in += 16;
+			out += 8;
+		} else {
+			const __m128i x = _mm_loadu_si128((const __m128i *)in);
+			accumulate(out, _mm_packs_epi32(downmix(_mm_unpacklo_epi16(x, x), vol), downmix(_mm_unpackhi_epi16(x, x), vol)));
+			in += 8;
+			out += 8;
+		}
+	}
+
+	mixSamplesGeneric<inStereo, outStereo, reverseStereo>(out, in, frames - i, volL, volR);
+}
+
+const MixSamplesFunc mixSamplesSSE2Funcs[kMixLayoutCount] = {
+	mixSamplesSSE2<false, false, false>,
+	mixSamplesSSE2<false, true, false>,
+	mixSamplesSSE2<true, false, false>,
+	mixSamplesSSE2<true, true, false>,
+	mixSamplesSSE2<true, true, true>
+};
+
+int32 dotProductSSE2(const int16 *a, const int16 *b, uint count) {
+	__m128i sum = _mm_setzero_si128();
+	for (uint i = 0; i < count; i += 8)
+		sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(a + i)), _mm_loadu_si128((const __m128i *)(b + i))));
+
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sum);
+}
+
+} // End of namespace Audio
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
@@ -29,7 +29,11 @@
 
 #include "audio/audiostream.h"
 #include "audio/rate.h"
+#include "audio/rate_intern.h"
 #include "audio/mixer.h"
+#include "common/array.h"
+#include "common/mutex.h"
+#include "common/system.h"
 #include "common/util.h"
 
 namespace Audio {
@@ -76,9 +80,19 @@ private:
 	/** Current sample(s) in the input stream (left/right channel) */
 	st_sample_t _inCurL, _inCurR;
 
+	/**
+	 * Resampled input, in the input channel layout, waiting to be mixed
+	 * into the output buffer.
+	 */
+	st_sample_t _resampleBuffer[512];
+
+	/** Kernel scaling and adding the samples to the output buffer */
+	MixSamplesFunc _mixSamples;
+
 	int copyConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
-	int simpleConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
-	int interpolateConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
+	int resampleConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r, bool interpolate);
+	int simpleResample(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples);
+	int interpolateResample(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples);
 
 public:
 	RateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate);
@@ -112,44 +126,53 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::copyConvert(AudioStr
 				return (outBuffer - outStart) / (outStereo ? 2 : 1);
 		}
 
-		// Mix the data into the output buffer
-		st_sample_t inL, inR;
-		inL = *_bufferPos++;
-		inR = (inStereo ? *_bufferPos++ : inL);
-		_bufferSize -= (inStereo ? 2 : 1);
+		// Mix as much of the buffer as fits into the output buffer
+		const st_size_t frames = MIN<st_size_t>(_bufferSize / (inStereo ? 2 : 1), (outEnd - outBuffer) / (outStereo ? 2 : 1));
+		if (frames == 0) {
+			// A stereo stream returned an odd number of samples
+			_bufferSize = 0;
+			continue;
+		}
 
-		st_sample_t outL, outR;
-		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
+		_mixSamples(outBuffer, _bufferPos, frames, volL, volR);
 
-		if (outStereo) {
-			// Output left channel
-			clampedAdd(outBuffer[reverseStereo    ], outL);
+		_bufferPos += frames * (inStereo ? 2 : 1);
+		_bufferSize -= frames * (inStereo ? 2 : 1);
+		outBuffer += frames * (outStereo ? 2 : 1);
+	}
 
-			// Output right channel
-			clampedAdd(outBuffer[reverseStereo ^ 1], outR);
+	return (outBuffer - outStart) / (outStereo ? 2 : 1);
+}
 
-			outBuffer += 2;
-		} else {
-			// Output mono channel
-			clampedAdd(outBuffer[0], (outL + outR) / 2);
+template<bool inStereo, bool outStereo, bool reverseStereo>
+int RateConverter_Impl<inStereo, outStereo, reverseStereo>::resampleConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR, bool interpolate) {
+	const st_size_t chunkSize = ARRAYSIZE(_resampleBuffer) / (inStereo ? 2 : 1);
+	st_size_t done = 0;
 
-			outBuffer += 1;
-		}
+	// Resample into our own buffer first, then mix that in one go
+	while (done < numSamples) {
+		const st_size_t chunk = MIN(numSamples - done, chunkSize);
+		const int frames = interpolate ? interpolateResample(input, _resampleBuffer, chunk) : simpleResample(input, _resampleBuffer, chunk);
+
+		_mixSamples(outBuffer + done * (outStereo ? 2 : 1), _resampleBuffer, frames, volL, volR);
+		done += frames;
+
+		if ((st_size_t)frames < chunk)
+			break;
 	}
 
-	return (outBuffer - outStart) / (outStereo ? 2 : 1);
+	return done;
 }
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
-int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleResample(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples) {
 	// How much to increment _outPos by
 	frac_t outPos_inc = _inRate / _outRate;
 
 	st_sample_t *outStart, *outEnd;
 
 	outStart = outBuffer;
-	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
+	outEnd = outBuffer + numSamples * (inStereo ? 2 : 1);
 
 	while (outBuffer < outEnd) {
 		// Read enough input samples so that _outPos >= 0
@@ -160,7 +183,7 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleConvert(AudioS
 				_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
 
 				if (_bufferSize <= 0)
-					return (outBuffer - outStart) / (outStereo ? 2 : 1);
+					return (outBuffer - outStart) / (inStereo ? 2 : 1);
 			}
 
 			_bufferSize -= (inStereo ? 2 : 1);
@@ -171,43 +194,24 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleConvert(AudioS
 			}
 		} while (_outPos >= 0);
 
-		st_sample_t inL, inR;
-		inL = *_bufferPos++;
-		inR = (inStereo ? *_bufferPos++ : inL);
+		*outBuffer++ = *_bufferPos++;
+		if (inStereo)
+			*outBuffer++ = *_bufferPos++;
 
 		// Increment output position
 		_outPos += outPos_inc;
-
-		st_sample_t outL, outR;
-		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
-
-		if (outStereo) {
-			// output left channel
-			clampedAdd(outBuffer[reverseStereo    ], outL);
-
-			// output right channel
-			clampedAdd(outBuffer[reverseStereo ^ 1], outR);
-
-			outBuffer += 2;
-		} else {
-			// output mono channel
-			clampedAdd(outBuffer[0], (outL + outR) / 2);
-
-			outBuffer += 1;
-		}
 	}
-	return (outBuffer - outStart) / (outStereo ? 2 : 1);
+	return (outBuffer - outStart) / (inStereo ? 2 : 1);
 }
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
-int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateResample(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples) {
 	// How much to increment _outPosFrac by
 	frac_t outPos_inc = (_inRate << FRAC_BITS_LOW) / _outRate;
 
 	st_sample_t *outStart, *outEnd;
 	outStart = outBuffer;
-	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
+	outEnd = outBuffer + numSamples * (inStereo ? 2 : 1);
 
 	while (outBuffer < outEnd) {
 		// Read enough input samples so that _outPosFrac < 0
@@ -218,7 +222,7 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(A
 				_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
 
 				if (_bufferSize <= 0)
-					return (outBuffer - outStart) / (outStereo ? 2 : 1);
+					return (outBuffer - outStart) / (inStereo ? 2 : 1);
 			}
 
 			_bufferSize -= (inStereo ? 2 : 1);
@@ -237,36 +241,15 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(A
 		// still space in the output buffer.
 		while (_outPosFrac < (frac_t)FRAC_ONE_LOW && outBuffer < outEnd) {
 			// Interpolate
-			st_sample_t inL, inR;
-			inL = (st_sample_t)(_inLastL + (((_inCurL - _inLastL) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
-			inR = (inStereo ?
-						(st_sample_t)(_inLastR + (((_inCurR - _inLastR) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
-						inL);
-
-			st_sample_t outL, outR;
-			outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-			outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
-
-			if (outStereo) {
-				// Output left channel
-				clampedAdd(outBuffer[reverseStereo    ], outL);
-
-				// Output right channel
-				clampedAdd(outBuffer[reverseStereo ^ 1], outR);
-
-				outBuffer += 2;
-			} else {
-				// Output mono channel
-				clampedAdd(outBuffer[0], (outL + outR) / 2);
-
-				outBuffer += 1;
-			}
+			*outBuffer++ = (st_sample_t)(_inLastL + (((_inCurL - _inLastL) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
+			if (inStereo)
+				*outBuffer++ = (st_sample_t)(_inLastR + (((_inCurR - _inLastR) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
 
 			// Increment output position
 			_outPosFrac += outPos_inc;
 		}
 	}
-	return (outBuffer - outStart) / (outStereo ? 2 : 1);
+	return (outBuffer - outStart) / (inStereo ? 2 : 1);
 }
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
@@ -280,7 +263,12 @@ RateConverter_Impl<inStereo, outStereo, reverseStereo>::RateConverter_Impl(st_ra
 	_inCurL(0),
 	_inCurR(0),
 	_bufferSize(0),
-	_bufferPos(nullptr) {}
+	_bufferPos(nullptr) {
+	if (inStereo)
+		_mixSamples = getMixSamplesFuncs()[outStereo ? (reverseStereo ? kMixStereoToStereoReversed : kMixStereoToStereo) : kMixStereoToMono];
+	else
+		_mixSamples = getMixSamplesFuncs()[outStereo ? kMixMonoToStereo : kMixMonoToMono];
+}
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
 int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
@@ -290,14 +278,456 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convert(AudioStream
 		return copyConvert(input, outBuffer, numSamples, volL, volR);
 	} else {
 		if ((_inRate % _outRate) == 0 && (_inRate < 65536)) {
-			return simpleConvert(input, outBuffer, numSamples, volL, volR);
+			return resampleConvert(input, outBuffer, numSamples, volL, volR, false);
 		} else {
-			return interpolateConvert(input, outBuffer, numSamples, volL, volR);
+			return resampleConvert(input, outBuffer, numSamples, volL, volR, true);
+		}
+	}
+}
+
+#pragma mark -
+#pragma mark --- Windowed sinc converter ---
+#pragma mark -
+
+/**
+ * Shared table of polyphase filter coefficients. Row p holds the taps for
+ * an output sample p / phases input samples after the centre tap, scaled
+ * to a sum of 1 << SINC_COEF_BITS.
+ */
+struct SincTable {
+	uint32 key;
+	uint taps;
+	uint phaseShift;
+	int16 *coefs;
+};
+
+enum {
+	SINC_COEF_BITS = 14,
+	SINC_MAX_TAPS = 64,
+	/** Cutoff frequencies are rounded to multiples of 1/SINC_CUTOFF_STEPS */
+	SINC_CUTOFF_STEPS = 64
+};
+
+static const struct {
+	uint taps;
+	uint phaseBits;
+	double beta;
+	double bandwidth;
+} sincQualities[] = {
+	{ 16,  8,  6.0, 0.85 },
+	{ 32,  9,  8.0, 0.90 },
+	{ 64, 10, 10.0, 0.95 }
+};
+
+static double besselI0(double x) {
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 32; k++) {
+		term *= (x / (2 * k)) * (x / (2 * k));
+		sum += term;
+	}
+	return sum;
+}
+
+static void buildSincTable(SincTable *table, int quality, int cutoffStep) {
+	const uint taps = sincQualities[quality - 1].taps;
+	const uint phases = 1 << sincQualities[quality - 1].phaseBits;
+	const double beta = sincQualities[quality - 1].beta;
+	const double cutoff = sincQualities[quality - 1].bandwidth * cutoffStep / SINC_CUTOFF_STEPS;
+	const double half = taps / 2;
+
+	table->taps = taps;
+	table->phaseShift = 32 - sincQualities[quality - 1].phaseBits;
+	table->coefs = new int16[phases * taps];
+
+	double window[SINC_MAX_TAPS];
+	for (uint p = 0; p < phases; p++) {
+		int16 *row = table->coefs + p * taps;
+
+		// Tap k sits at input sample k - (taps / 2 - 1) relative to the
+		// centre, and the output sample lies p / phases past the centre
+		double sum = 0.0;
+		for (uint k = 0; k < taps; k++) {
+			const double t = (double)k - (half - 1) - (double)p / phases;
+			const double x = t / half;
+			const double sinc = (t == 0.0) ? 1.0 : sin(M_PI * cutoff * t) / (M_PI * cutoff * t);
+			window[k] = (x * x < 1.0) ? sinc * besselI0(beta * sqrt(1.0 - x * x)) : 0.0;
+			sum += window[k];
+		}
+
+		// Normalise to unity gain, giving the rounding error to the
+		// biggest tap
+		int total = 0;
+		uint biggest = 0;
+		for (uint k = 0; k < taps; k++) {
+			row[k] = (int16)floor(window[k] / sum * (1 << SINC_COEF_BITS) + 0.5);
+			total += row[k];
+			if (row[k] > row[biggest])
+				biggest = k;
 		}
+		row[biggest] += (1 << SINC_COEF_BITS) - total;
+	}
+}
+
+/**
+ * All filter tables built so far. Tables are kept until exit, so that rate
+ * changes on the mixer thread normally only have to look them up; there are
+ * at most ARRAYSIZE(sincQualities) * SINC_CUTOFF_STEPS of them.
+ */
+class SincTableCache {
+public:
+	~SincTableCache();
+
+	/**
+	 * Return the table for the given quality and input/output rates, building
+	 * it if needed. Upsampling always filters at the input Nyquist frequency,
+	 * so all upsampling ratios share one table.
+	 */
+	const SincTable *get(int quality, st_rate_t inRate, st_rate_t outRate);
+
+private:
+	const SincTable *find(uint32 key) const;
+
+	Common::Mutex _mutex;
+	Common::Array<SincTable *> _tables;
+};
+
+SincTableCache::~SincTableCache() {
+	for (uint i = 0; i < _tables.size(); i++) {
+		delete[] _tables[i]->coefs;
+		delete _tables[i];
 	}
 }
 
-RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo) {
+const SincTable *SincTableCache::find(uint32 key) const {
+	for (uint i = 0; i < _tables.size(); i++) {
+		if (_tables[i]->key == key)
+			return _tables[i];
+	}
+	return nullptr;
+}
+
+const SincTable *SincTableCache::get(int quality, st_rate_t inRate, st_rate_t outRate) {
+	int cutoffStep = SINC_CUTOFF_STEPS;
+	if (outRate < inRate)
+		cutoffStep = MAX<int>(1, (uint64)outRate * SINC_CUTOFF_STEPS / inRate);
+	const uint32 key = quality * (SINC_CUTOFF_STEPS + 1) + cutoffStep;
+
+	{
+		Common::StackLock lock(_mutex);
+		const SincTable *table = find(key);
+		if (table)
+			return table;
+	}
+
+	// Build outside of the lock, so that lookups from the mixer thread do
+	// not wait for it
+	SincTable *table = new SincTable();
+	table->key = key;
+	buildSincTable(table, quality, cutoffStep);
+
+	Common::StackLock lock(_mutex);
+	const SincTable *existing = find(key);
+	if (existing) {
+		delete[] table->coefs;
+		delete table;
+		return existing;
+	}
+	_tables.push_back(table);
+	return table;
+}
+
+static SincTableCache &sincTableCache() {
+	static SincTableCache cache;
+	return cache;
+}
+
+/**
+ * Band limited resampler, interpolating with a Kaiser windowed sinc filter.
+ * Filter length and phase resolution depend on the quality level.
+ */
+template<bool inStereo, bool outStereo, bool reverseStereo>
+class SincRateConverter : public RateConverter {
+private:
+	enum {
+		CHANNELS = inStereo ? 2 : 1,
+		HISTORY_FRAMES = 512 + SINC_MAX_TAPS
+	};
+
+	/** Input and output rates */
+	st_rate_t _inRate, _outRate;
+
+	const int _quality;
+	const SincTable *_table;
+
+	/** Input position step per output sample, in 32.32 fixed point */
+	uint32 _stepInt, _stepFrac;
+
+	/** Fractional position of the next output sample */
+	uint32 _frac;
+
+	/** The input cache, see RateConverter_Impl */
+	st_sample_t _buffer[512];
+	const st_sample_t *_bufferPos;
+	int _bufferSize;
+
+	/**
+	 * Deinterleaved input frames. The filter window for the next output
+	 * sample starts at _historyPos.
+	 */
+	st_sample_t _history[CHANNELS][HISTORY_FRAMES];
+	int _historyPos, _historyLength;
+
+	/** Whether the input has ended and the history was padded with silence */
+	bool _padded;
+
+	st_sample_t _resampleBuffer[512];
+	MixSamplesFunc _mixSamples;
+	DotProductFunc _dotProduct;
+
+	void updateRates();
+	bool fillHistory(AudioStream &input);
+	int resample(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples);
+
+public:
+	SincRateConverter(st_rate_t inputRate, st_rate_t outputRate, int quality);
+
+	int convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r) override;
+
+	void setInputRate(st_rate_t inputRate) override { _inRate = inputRate; updateRates(); }
+	void setOutputRate(st_rate_t outputRate) override { _outRate = outputRate; updateRates(); }
+
+	st_rate_t getInputRate() const override { return _inRate; }
+	st_rate_t getOutputRate() const override { return _outRate; }
+
+	bool needsDraining() const override {
+		return _bufferSize != 0 || !_padded || _historyLength - _historyPos >= (int)_table->taps;
+	}
+};
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+SincRateConverter<inStereo, outStereo, reverseStereo>::SincRateConverter(st_rate_t inputRate, st_rate_t outputRate, int quality) :
+	_inRate(inputRate),
+	_outRate(outputRate),
+	_quality(quality),
+	_table(nullptr),
+	_frac(0),
+	_bufferPos(nullptr),
+	_bufferSize(0),
+	_historyPos(0),
+	_padded(false) {
+	updateRates();
+
+	// Start with silence up to the centre tap, so that the first output
+	// sample lines up with the first input sample
+	_historyLength = _table->taps / 2 - 1;
+	for (int c = 0; c < CHANNELS; c++)
+		memset(_history[c], 0, _historyLength * sizeof(st_sample_t));
+
+	if (inStereo)
+		_mixSamples = getMixSamplesFuncs()[outStereo ? (reverseStereo ? kMixStereoToStereoReversed : kMixStereoToStereo) : kMixStereoToMono];
+	else
+		_mixSamples = getMixSamplesFuncs()[outStereo ? kMixMonoToStereo : kMixMonoToMono];
+	_dotProduct = getDotProductFunc();
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+void SincRateConverter<inStereo, outStereo, reverseStereo>::updateRates() {
+	const uint64 step = ((uint64)_inRate << 32) / _outRate;
+	_stepInt = (uint32)(step >> 32);
+	_stepFrac = (uint32)step;
+
+	// Rate changes arrive on the mixer thread. The mixer builds the table
+	// on the calling thread beforehand with prepareRateConverter, so this
+	// is only a lookup.
+	_table = sincTableCache().get(_quality, _inRate, _outRate);
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+bool SincRateConverter<inStereo, outStereo, reverseStereo>::fillHistory(AudioStream &input) {
+	// Drop the frames which left the filter window
+	const int drop = MIN(_historyPos, _historyLength);
+	if (drop > 0) {
+		for (int c = 0; c < CHANNELS; c++)
+			memmove(_history[c], _history[c] + drop, (_historyLength - drop) * sizeof(st_sample_t));
+		_historyLength -= drop;
+		_historyPos -= drop;
+	}
+
+	const int oldLength = _historyLength;
+	while (_historyLength < HISTORY_FRAMES) {
+		// Check if we have to refill the buffer
+		if (_bufferSize <= 0) {
+			_bufferPos = _buffer;
+			_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
+
+			if (_bufferSize <= 0) {
+				_bufferSize = 0;
+				break;
+			}
+		}
+
+		const int frames = MIN(_bufferSize / CHANNELS, HISTORY_FRAMES - _historyLength);
+		if (frames == 0) {
+			// A stereo stream returned an odd number of samples
+			_bufferSize = 0;
+			continue;
+		}
+
+		for (int i = 0; i < frames; i++) {
+			_history[0][_historyLength + i] = *_bufferPos++;
+			if (inStereo)
+				_history[1][_historyLength + i] = *_bufferPos++;
+		}
+		_historyLength += frames;
+		_bufferSize -= frames * CHANNELS;
+	}
+
+	if (_historyLength > oldLength) {
+		_padded = false;
+		return true;
+	}
+
+	// Once the stream ended, flush the samples still in the filter
+	if (!_padded && input.endOfData()) {
+		const int pad = MIN<int>(_table->taps / 2, HISTORY_FRAMES - _historyLength);
+		for (int c = 0; c < CHANNELS; c++)
+			memset(_history[c] + _historyLength, 0, pad * sizeof(st_sample_t));
+		_historyLength += pad;
+		_padded = true;
+		return true;
+	}
+
+	return false;
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+int SincRateConverter<inStereo, outStereo, reverseStereo>::resample(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples) {
+	const int taps = _table->taps;
+	const uint phaseShift = _table->phaseShift;
+	st_size_t produced = 0;
+
+	while (produced < numSamples) {
+		if (_historyLength - _historyPos < taps) {
+			if (!fillHistory(input))
+				break;
+			continue;
+		}
+
+		const int16 *coefs = _table->coefs + (_frac >> phaseShift) * taps;
+		for (int c = 0; c < CHANNELS; c++) {
+			const int32 sum = _dotProduct(_history[c] + _historyPos, coefs, taps);
+			*outBuffer++ = (st_sample_t)CLIP<int32>((sum + (1 << (SINC_COEF_BITS - 1))) >> SINC_COEF_BITS, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+		}
+		produced++;
+
+		// Advance the filter window
+		const uint32 oldFrac = _frac;
+		_frac += _stepFrac;
+		_historyPos += _stepInt + (_frac < oldFrac ? 1 : 0);
+	}
+
+	return produced;
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+int SincRateConverter<inStereo, outStereo, reverseStereo>::convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+	assert(input.isStereo() == inStereo);
+
+	const st_size_t chunkSize = ARRAYSIZE(_resampleBuffer) / CHANNELS;
+	st_size_t done = 0;
+
+	while (done < numSamples) {
+		const st_size_t chunk = MIN(numSamples - done, chunkSize);
+		const int frames = resample(input, _resampleBuffer, chunk);
+
+		_mixSamples(outBuffer + done * (outStereo ? 2 : 1), _resampleBuffer, frames, volL, volR);
+		done += frames;
+
+		if ((st_size_t)frames < chunk)
+			break;
+	}
+
+	return done;
+}
+
+int32 dotProductGeneric(const int16 *a, const int16 *b, uint count) {
+	int32 sum = 0;
+	for (uint i = 0; i < count; i++)
+		sum += a[i] * b[i];
+	return sum;
+}
+
+DotProductFunc dotProductFunc = nullptr;
+
+DotProductFunc getDotProductFunc() {
+	if (dotProductFunc)
+		return dotProductFunc;
+
+	dotProductFunc = dotProductGeneric;
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) dotProductFunc = dotProductNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) dotProductFunc = dotProductSSE2;
+#endif
+	return dotProductFunc;
+}
+
+#pragma mark -
+
+const MixSamplesFunc mixSamplesGenericFuncs[kMixLayoutCount] = {
+	mixSamplesGeneric<false, false, false>,
+	mixSamplesGeneric<false, true, false>,
+	mixSamplesGeneric<true, false, false>,
+	mixSamplesGeneric<true, true, false>,
+	mixSamplesGeneric<true, true, true>
+};
+
+const MixSamplesFunc *mixSamplesFuncs = nullptr;
+
+const MixSamplesFunc *getMixSamplesFuncs() {
+	if (mixSamplesFuncs)
+		return mixSamplesFuncs;
+
+	mixSamplesFuncs = mixSamplesGenericFuncs;
+	// The vector kernels saturate in signed arithmetic
+#ifndef OUTPUT_UNSIGNED_AUDIO
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) mixSamplesFuncs = mixSamplesNEONFuncs;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) mixSamplesFuncs = mixSamplesSSE2Funcs;
+#endif
+#endif
+	return mixSamplesFuncs;
+}
+
+void prepareRateConverter(st_rate_t inRate, st_rate_t outRate, int quality) {
+	quality = MIN<int>(quality, ARRAYSIZE(sincQualities));
+	if (quality > 0)
+		sincTableCache().get(quality, inRate, outRate);
+}
+
+RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo, int quality) {
+	quality = MIN<int>(quality, ARRAYSIZE(sincQualities));
+
+	if (quality > 0) {
+		if (inStereo) {
+			if (outStereo) {
+				if (reverseStereo)
+					return new SincRateConverter<true, true, true>(inRate, outRate, quality);
+				else
+					return new SincRateConverter<true, true, false>(inRate, outRate, quality);
+			} else
+				return new SincRateConverter<true, false, false>(inRate, outRate, quality);
+		} else {
+			if (outStereo)
+				return new SincRateConverter<false, true, false>(inRate, outRate, quality);
+			else
+				return new SincRateConverter<false, false, false>(inRate, outRate, quality);
+		}
+	}
+
 	if (inStereo) {
 		if (outStereo) {
 			if (reverseStereo)
@@ -104,7 +104,20 @@ public:
 	virtual bool needsDraining() const = 0;
 };
 
-RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo);
+/**
+ * Create a RateConverter for the given rates and channel layouts.
+ *
+ * @param quality	0 for linear interpolation, 1 to 3 for increasingly long
+ *					windowed sinc filters. See Mixer::getResamplerQuality.
+ */
+RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo, int quality = 0);
+
+/**
+ * Build the filter tables a converter of the given quality needs for the
+ * given rates. Call this before switching the rates of a converter which is
+ * used on the mixer thread, so that it does not have to build them there.
+ */
+void prepareRateConverter(st_rate_t inRate, st_rate_t outRate, int quality);
 
 /** @} */
 } // End of namespace Audio
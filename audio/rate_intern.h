@@ -0,0 +1,118 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_RATE_INTERN_H
+#define AUDIO_RATE_INTERN_H
+
+#include "audio/mixer.h"
+#include "audio/rate.h"
+
+namespace Audio {
+
+/**
+ * Channel layouts handled by the sample mixing kernels. The reversed
+ * layout swaps the left and right channel of a stereo input.
+ */
+enum MixLayout {
+	kMixMonoToMono,
+	kMixMonoToStereo,
+	kMixStereoToMono,
+	kMixStereoToStereo,
+	kMixStereoToStereoReversed,
+	kMixLayoutCount
+};
+
+/**
+ * Scale @p frames frames of @p in by the channel volumes and add them to
+ * @p out, saturating at the sample range. This is the final step of every
+ * rate converter.
+ */
+typedef void (*MixSamplesFunc)(st_sample_t *out, const st_sample_t *in, st_size_t frames, st_volume_t volL, st_volume_t volR);
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+void mixSamplesGeneric(st_sample_t *out, const st_sample_t *in, st_size_t frames, st_volume_t volL, st_volume_t volR) {
+	for (st_size_t i = 0; i < frames; i++) {
+		st_sample_t inL, inR;
+		inL = *in++;
+		inR = (inStereo ? *in++ : inL);
+
+		st_sample_t outL, outR;
+		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
+		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
+
+		if (outStereo) {
+			// Output left channel
+			clampedAdd(out[reverseStereo    ], outL);
+
+			// Output right channel
+			clampedAdd(out[reverseStereo ^ 1], outR);
+
+			out += 2;
+		} else {
+			// Output mono channel
+			clampedAdd(out[0], (outL + outR) / 2);
+
+			out += 1;
+		}
+	}
+}
+
+extern const MixSamplesFunc mixSamplesGenericFuncs[kMixLayoutCount];
+#ifdef SCUMMVM_NEON
+extern const MixSamplesFunc mixSamplesNEONFuncs[kMixLayoutCount];
+#endif
+#ifdef SCUMMVM_SSE2
+extern const MixSamplesFunc mixSamplesSSE2Funcs[kMixLayoutCount];
+#endif
+
+/**
+ * The mixing kernels used by new rate converters, indexed by MixLayout.
+ * If unset, the first converter picks the ones best suited to the CPU.
+ */
+extern const MixSamplesFunc *mixSamplesFuncs;
+
+const MixSamplesFunc *getMixSamplesFuncs();
+
+/**
+ * Return the sum of the products of @p count pairs of samples and filter
+ * coefficients. @p count is a multiple of 8.
+ */
+typedef int32 (*DotProductFunc)(const int16 *a, const int16 *b, uint count);
+
+int32 dotProductGeneric(const int16 *a, const int16 *b, uint count);
+#ifdef SCUMMVM_NEON
+int32 dotProductNEON(const int16 *a, const int16 *b, uint count);
+#endif
+#ifdef SCUMMVM_SSE2
+int32 dotProductSSE2(const int16 *a, const int16 *b, uint count);
+#endif
+
+/**
+ * The dot product used by new windowed sinc converters. If unset, the
+ * first converter picks the one best suited to the CPU.
+ */
+extern DotProductFunc dotProductFunc;
+
+DotProductFunc getDotProductFunc();
+
+} // End of namespace Audio
+
+#endif
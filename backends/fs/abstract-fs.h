@@ -172,6 +172,18 @@ public:
 	 */
 	virtual bool isWritable() const = 0;
 
+	/**
+	 * Retrieves the size and the last modification time of the file referred
+	 * by this node, without opening it.
+	 *
+	 * The default implementation reports that this is not supported.
+	 *
+	 * @param size             the size of the file in bytes
+	 * @param modificationTime the modification time, in seconds since an unspecified epoch
+	 *
+	 * @return bool true if the information could be retrieved, false otherwise.
+	 */
+	virtual bool getFileInfo(uint64 &size, int64 &modificationTime) const { return false; }
 
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
@@ -182,6 +194,16 @@ public:
 	 */
 	virtual Common::SeekableReadStream *createReadStream() = 0;
 
+	/**
+	 * Like createReadStream(), but allows the backend to map the file into
+	 * memory instead of reading it. Only use this for files which are not
+	 * modified while the stream is open, like game data, since accessing a
+	 * mapping of a truncated file crashes.
+	 *
+	 * @return pointer to the stream object, 0 in case of a failure
+	 */
+	virtual Common::SeekableReadStream *createMappedReadStream() { return createReadStream(); }
+
 	/**
 	 * Creates a SeekableReadStream instance corresponding to an alternate
 	 * stream of the file referred by this node. This assumes that the node
@@ -33,6 +33,7 @@
 
 #include "backends/fs/posix/posix-fs.h"
 #include "backends/fs/posix/posix-iostream.h"
+#include "backends/fs/posix/posix-mmapstream.h"
 #include "common/algorithm.h"
 
 #include <sys/param.h>
@@ -63,6 +64,16 @@ bool POSIXFilesystemNode::isReadable() const {
 	return access(_path.c_str(), R_OK) == 0;
 }
 
+bool POSIXFilesystemNode::getFileInfo(uint64 &size, int64 &modificationTime) const {
+	struct stat st;
+	if (stat(_path.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+		return false;
+
+	size = st.st_size;
+	modificationTime = st.st_mtime;
+	return true;
+}
+
 bool POSIXFilesystemNode::isWritable() const {
 	return access(_path.c_str(), W_OK) == 0;
 }
@@ -279,6 +290,17 @@ Common::SeekableReadStream *POSIXFilesystemNode::createReadStream() {
 	return PosixIoStream::makeFromPath(getPath(), StdioStream::WriteMode_Read);
 }
 
+Common::SeekableReadStream *POSIXFilesystemNode::createMappedReadStream() {
+#ifdef HAS_MMAP
+	// Large data files are mapped, so that they are paged in on demand
+	Common::SeekableReadStream *stream = PosixMmapStream::makeFromPath(getPath());
+	if (stream)
+		return stream;
+#endif
+
+	return createReadStream();
+}
+
 Common::SeekableReadStream *POSIXFilesystemNode::createReadStreamForAltStream(Common::AltStreamType altStreamType) {
 #ifdef MACOSX
 	if (altStreamType == Common::AltStreamType::MacResourceFork) {
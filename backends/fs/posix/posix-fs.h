@@ -60,12 +60,14 @@ public:
 	bool isDirectory() const override { return _isDirectory; }
 	bool isReadable() const override;
 	bool isWritable() const override;
+	bool getFileInfo(uint64 &size, int64 &modificationTime) const override;
 
 	AbstractFSNode *getChild(const Common::String &n) const override;
 	bool getChildren(AbstractFSList &list, ListMode mode, bool hidden) const override;
 	AbstractFSNode *getParent() const override;
 
 	Common::SeekableReadStream *createReadStream() override;
+	Common::SeekableReadStream *createMappedReadStream() override;
 	Common::SeekableReadStream *createReadStreamForAltStream(Common::AltStreamType altStreamType) override;
 	Common::SeekableWriteStream *createWriteStream(bool atomic) override;
 	bool createDirectory() override;
@@ -0,0 +1,67 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "backends/fs/posix/posix-mmapstream.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+enum {
+	/** Smaller files are cheaper to read with stdio than to map */
+	kMinMappedSize = 1024 * 1024,
+
+	/** Do not exhaust the address space of 32-bit hosts */
+	kMaxMappedSize32 = 256 * 1024 * 1024
+};
+
+PosixMmapStream *PosixMmapStream::makeFromPath(const Common::String &path) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1)
+		return nullptr;
+
+	struct stat st;
+	if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) || st.st_size < kMinMappedSize ||
+	    (uint64)st.st_size > 0xFFFFFFFFULL || (sizeof(void *) < 8 && st.st_size > kMaxMappedSize32)) {
+		close(fd);
+		return nullptr;
+	}
+
+	void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping keeps its own reference to the file
+	close(fd);
+
+	if (data == MAP_FAILED)
+		return nullptr;
+
+	return new PosixMmapStream((const byte *)data, st.st_size);
+}
+
+PosixMmapStream::PosixMmapStream(const byte *data, uint32 size) :
+		Common::MemoryReadStream(data, size), _data(data), _mappedSize(size) {
+}
+
+PosixMmapStream::~PosixMmapStream() {
+	munmap(const_cast<byte *>(_data), _mappedSize);
+}
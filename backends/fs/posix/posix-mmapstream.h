@@ -0,0 +1,61 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef BACKENDS_FS_POSIX_POSIXMMAPSTREAM_H
+#define BACKENDS_FS_POSIX_POSIXMMAPSTREAM_H
+
+#include "common/memstream.h"
+#include "common/noncopyable.h"
+#include "common/str.h"
+
+/**
+ * A read-only file stream backed by a private memory mapping of the whole
+ * file. Pages are loaded on demand and shared with the page cache, and the
+ * contents can be accessed directly without copying.
+ */
+class PosixMmapStream final : public Common::MemoryReadStream, public Common::NonCopyable {
+public:
+	/**
+	 * Map the file at the given path.
+	 *
+	 * Only regular files large enough to benefit from it are mapped.
+	 *
+	 * @return the new stream, or nullptr if the file should be read through
+	 *         PosixIoStream instead.
+	 */
+	static PosixMmapStream *makeFromPath(const Common::String &path);
+
+	~PosixMmapStream() override;
+
+	/**
+	 * Return the mapped file contents. They stay valid for the lifetime of
+	 * the stream.
+	 */
+	const byte *getData() const { return _data; }
+
+private:
+	PosixMmapStream(const byte *data, uint32 size);
+
+	const byte *_data;
+	uint32 _mappedSize;
+};
+
+#endif
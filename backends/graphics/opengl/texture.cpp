@@ -44,7 +44,7 @@ namespace OpenGL {
 //
 
 Surface::Surface()
-	: _allDirty(false), _dirtyArea() {
+	: _allDirty(false), _dirtyAreas() {
 }
 
 void Surface::copyRectToTexture(uint x, uint y, uint w, uint h, const void *srcPtr, uint srcPitch) {
@@ -86,21 +86,73 @@ void Surface::fill(const Common::Rect &r, uint32 color) {
 
 void Surface::addDirtyArea(const Common::Rect &r) {
 	// *sigh* Common::Rect::extend behaves unexpected whenever one of the two
-	// parameters is an empty rect. Thus, we check whether the current dirty
-	// area is valid. In case it is not we simply use the parameters as new
-	// dirty area. Otherwise, we simply call extend.
-	if (_dirtyArea.isEmpty()) {
-		_dirtyArea = r;
-	} else {
-		_dirtyArea.extend(r);
+	// parameters is an empty rect. Thus, we drop empty rects here, so that
+	// all areas in the list are valid.
+	if (r.isEmpty() || _allDirty) {
+		return;
+	}
+
+	Common::Rect area = r;
+
+	// Merging two areas can make the result worth merging with another one,
+	// so start over after every merge.
+	uint i = 0;
+	while (i < _dirtyAreas.size()) {
+		if (shouldMergeDirtyAreas(_dirtyAreas[i], area)) {
+			area.extend(_dirtyAreas[i]);
+			_dirtyAreas.remove_at(i);
+			i = 0;
+		} else {
+			++i;
+		}
+	}
+
+	// Too many areas, merge with the one that adds the least pixels.
+	while (_dirtyAreas.size() >= kMaxDirtyAreas) {
+		uint best = 0;
+		int64 bestGrowth = 0;
+
+		for (i = 0; i < _dirtyAreas.size(); ++i) {
+			Common::Rect merged = area;
+			merged.extend(_dirtyAreas[i]);
+
+			const int64 growth = (int64)merged.width() * merged.height() - (int64)_dirtyAreas[i].width() * _dirtyAreas[i].height();
+			if (i == 0 || growth < bestGrowth) {
+				best = i;
+				bestGrowth = growth;
+			}
+		}
+
+		area.extend(_dirtyAreas[best]);
+		_dirtyAreas.remove_at(best);
 	}
+
+	_dirtyAreas.push_back(area);
 }
 
-Common::Rect Surface::getDirtyArea() const {
+bool Surface::shouldMergeDirtyAreas(const Common::Rect &a, const Common::Rect &b) {
+	// Without GL_UNPACK_ROW_LENGTH every upload covers whole texture lines,
+	// so areas sharing lines would upload these twice.
+	if (!OpenGLContext.unpackSubImageSupported && a.top < b.bottom && b.top < a.bottom) {
+		return true;
+	}
+
+	// Merge when the bounding box is not much bigger than both areas, as
+	// each upload has some fixed cost of its own.
+	Common::Rect merged = a;
+	merged.extend(b);
+
+	const int64 mergedSize = (int64)merged.width() * merged.height();
+	const int64 separateSize = (int64)a.width() * a.height() + (int64)b.width() * b.height();
+
+	return mergedSize <= separateSize + 64 * 64;
+}
+
+Common::Array<Common::Rect> Surface::getDirtyAreas() const {
 	if (_allDirty) {
-		return Common::Rect(getWidth(), getHeight());
+		return Common::Array<Common::Rect>(1, Common::Rect(getWidth(), getHeight()));
 	} else {
-		return _dirtyArea;
+		return _dirtyAreas;
 	}
 }
 
@@ -161,9 +213,14 @@ void TextureSurface::updateGLTexture() {
 		return;
 	}
 
-	Common::Rect dirtyArea = getDirtyArea();
+	Common::Array<Common::Rect> dirtyAreas = getDirtyAreas();
+
+	for (Common::Rect &dirtyArea : dirtyAreas) {
+		updateGLTexture(dirtyArea);
+	}
 
-	updateGLTexture(dirtyArea);
+	// We should have handled everything, thus not dirty anymore.
+	clearDirty();
 }
 
 void TextureSurface::updateGLTexture(Common::Rect &dirtyArea) {
@@ -197,9 +254,6 @@ void TextureSurface::updateGLTexture(Common::Rect &dirtyArea) {
 	}
 
 	_glTexture.updateArea(dirtyArea, _textureData);
-
-	// We should have handled everything, thus not dirty anymore.
-	clearDirty();
 }
 
 FakeTextureSurface::FakeTextureSurface(GLenum glIntFormat, GLenum glFormat, GLenum glType, const Graphics::PixelFormat &format, const Graphics::PixelFormat &fakeFormat)
@@ -281,12 +335,12 @@ void FakeTextureSurface::updateGLTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = TextureSurface::getSurface();
 
-	const Common::Rect dirtyArea = getDirtyArea();
-
-	byte *dst = (byte *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
-	const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
+	for (const Common::Rect &dirtyArea : getDirtyAreas()) {
+		byte *dst = (byte *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
+		const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
 
-	applyPaletteAndMask(dst, src, outSurf->pitch, _rgbData.pitch, _rgbData.w, dirtyArea, outSurf->format, _rgbData.format);
+		applyPaletteAndMask(dst, src, outSurf->pitch, _rgbData.pitch, _rgbData.w, dirtyArea, outSurf->format, _rgbData.format);
+	}
 
 	// Do generic handling of updating the texture.
 	TextureSurface::updateGLTexture();
@@ -338,25 +392,25 @@ void TextureSurfaceRGB555::updateGLTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = TextureSurface::getSurface();
 
-	const Common::Rect dirtyArea = getDirtyArea();
+	for (const Common::Rect &dirtyArea : getDirtyAreas()) {
+		uint16 *dst = (uint16 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
+		const uint dstAdd = outSurf->pitch - 2 * dirtyArea.width();
 
-	uint16 *dst = (uint16 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
-	const uint dstAdd = outSurf->pitch - 2 * dirtyArea.width();
+		const uint16 *src = (const uint16 *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
+		const uint srcAdd = _rgbData.pitch - 2 * dirtyArea.width();
 
-	const uint16 *src = (const uint16 *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
-	const uint srcAdd = _rgbData.pitch - 2 * dirtyArea.width();
+		for (int height = dirtyArea.height(); height > 0; --height) {
+			for (int width = dirtyArea.width(); width > 0; --width) {
+				const uint16 color = *src++;
 
-	for (int height = dirtyArea.height(); height > 0; --height) {
-		for (int width = dirtyArea.width(); width > 0; --width) {
-			const uint16 color = *src++;
+				*dst++ =   ((color & 0x7C00) << 1)                             // R
+				         | (((color & 0x03E0) << 1) | ((color & 0x0200) >> 4)) // G
+				         | (color & 0x001F);                                   // B
+			}
 
-			*dst++ =   ((color & 0x7C00) << 1)                             // R
-			         | (((color & 0x03E0) << 1) | ((color & 0x0200) >> 4)) // G
-			         | (color & 0x001F);                                   // B
+			src = (const uint16 *)((const byte *)src + srcAdd);
+			dst = (uint16 *)((byte *)dst + dstAdd);
 		}
-
-		src = (const uint16 *)((const byte *)src + srcAdd);
-		dst = (uint16 *)((byte *)dst + dstAdd);
 	}
 
 	// Do generic handling of updating the texture.
@@ -380,23 +434,23 @@ void TextureSurfaceRGBA8888Swap::updateGLTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = TextureSurface::getSurface();
 
-	const Common::Rect dirtyArea = getDirtyArea();
+	for (const Common::Rect &dirtyArea : getDirtyAreas()) {
+		uint32 *dst = (uint32 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
+		const uint dstAdd = outSurf->pitch - 4 * dirtyArea.width();
 
-	uint32 *dst = (uint32 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
-	const uint dstAdd = outSurf->pitch - 4 * dirtyArea.width();
+		const uint32 *src = (const uint32 *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
+		const uint srcAdd = _rgbData.pitch - 4 * dirtyArea.width();
 
-	const uint32 *src = (const uint32 *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
-	const uint srcAdd = _rgbData.pitch - 4 * dirtyArea.width();
+		for (int height = dirtyArea.height(); height > 0; --height) {
+			for (int width = dirtyArea.width(); width > 0; --width) {
+				const uint32 color = *src++;
 
-	for (int height = dirtyArea.height(); height > 0; --height) {
-		for (int width = dirtyArea.width(); width > 0; --width) {
-			const uint32 color = *src++;
+				*dst++ = SWAP_BYTES_32(color);
+			}
 
-			*dst++ = SWAP_BYTES_32(color);
+			src = (const uint32 *)((const byte *)src + srcAdd);
+			dst = (uint32 *)((byte *)dst + dstAdd);
 		}
-
-		src = (const uint32 *)((const byte *)src + srcAdd);
-		dst = (uint32 *)((byte *)dst + dstAdd);
 	}
 
 	// Do generic handling of updating the texture.
@@ -447,46 +501,50 @@ void ScaledTextureSurface::updateGLTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = TextureSurface::getSurface();
 
-	Common::Rect dirtyArea = getDirtyArea();
+	Common::Array<Common::Rect> dirtyAreas = getDirtyAreas();
 
-	// Extend the dirty region for scalers
-	// that "smear" the screen, e.g. 2xSAI
-	dirtyArea.grow(_extraPixels);
-	dirtyArea.clip(Common::Rect(0, 0, _rgbData.w, _rgbData.h));
+	for (Common::Rect &dirtyArea : dirtyAreas) {
+		// Extend the dirty region for scalers
+		// that "smear" the screen, e.g. 2xSAI
+		dirtyArea.grow(_extraPixels);
+		dirtyArea.clip(Common::Rect(0, 0, _rgbData.w, _rgbData.h));
 
-	const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
-	uint srcPitch = _rgbData.pitch;
-	byte *dst;
-	uint dstPitch;
+		const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
+		uint srcPitch = _rgbData.pitch;
+		byte *dst;
+		uint dstPitch;
 
-	if (_convData) {
-		dst = (byte *)_convData->getBasePtr(dirtyArea.left + _extraPixels, dirtyArea.top + _extraPixels);
-		dstPitch = _convData->pitch;
+		if (_convData) {
+			dst = (byte *)_convData->getBasePtr(dirtyArea.left + _extraPixels, dirtyArea.top + _extraPixels);
+			dstPitch = _convData->pitch;
 
-		applyPaletteAndMask(dst, src, dstPitch, srcPitch, _rgbData.w, dirtyArea, _convData->format, _rgbData.format);
+			applyPaletteAndMask(dst, src, dstPitch, srcPitch, _rgbData.w, dirtyArea, _convData->format, _rgbData.format);
 
-		src = dst;
-		srcPitch = dstPitch;
-	}
+			src = dst;
+			srcPitch = dstPitch;
+		}
 
-	dst = (byte *)outSurf->getBasePtr(dirtyArea.left * _scaleFactor, dirtyArea.top * _scaleFactor);
-	dstPitch = outSurf->pitch;
+		dst = (byte *)outSurf->getBasePtr(dirtyArea.left * _scaleFactor, dirtyArea.top * _scaleFactor);
+		dstPitch = outSurf->pitch;
 
-	if (_scaler && (uint)dirtyArea.height() >= _extraPixels) {
-		_scaler->scale(src, srcPitch, dst, dstPitch, dirtyArea.width(), dirtyArea.height(), dirtyArea.left, dirtyArea.top);
-	} else {
-		Graphics::scaleBlit(dst, src, dstPitch, srcPitch,
-		                    dirtyArea.width() * _scaleFactor, dirtyArea.height() * _scaleFactor,
-		                    dirtyArea.width(), dirtyArea.height(), outSurf->format);
-	}
+		if (_scaler && (uint)dirtyArea.height() >= _extraPixels) {
+			_scaler->scale(src, srcPitch, dst, dstPitch, dirtyArea.width(), dirtyArea.height(), dirtyArea.left, dirtyArea.top);
+		} else {
+			Graphics::scaleBlit(dst, src, dstPitch, srcPitch,
+			                    dirtyArea.width() * _scaleFactor, dirtyArea.height() * _scaleFactor,
+			                    dirtyArea.width(), dirtyArea.height(), outSurf->format);
+		}
 
-	dirtyArea.left   *= _scaleFactor;
-	dirtyArea.right  *= _scaleFactor;
-	dirtyArea.top    *= _scaleFactor;
-	dirtyArea.bottom *= _scaleFactor;
+		dirtyArea.left   *= _scaleFactor;
+		dirtyArea.right  *= _scaleFactor;
+		dirtyArea.top    *= _scaleFactor;
+		dirtyArea.bottom *= _scaleFactor;
 
-	// Do generic handling of updating the texture.
-	TextureSurface::updateGLTexture(dirtyArea);
+		// Do generic handling of updating the texture.
+		TextureSurface::updateGLTexture(dirtyArea);
+	}
+
+	clearDirty();
 }
 
 void ScaledTextureSurface::setScaler(uint scalerIndex, int scaleFactor) {
@@ -646,7 +704,9 @@ void TextureSurfaceCLUT8GPU::updateGLTexture() {
 
 	// Update CLUT8 texture if necessary.
 	if (Surface::isDirty()) {
-		_clut8Texture.updateArea(getDirtyArea(), _clut8Data);
+		for (const Common::Rect &dirtyArea : getDirtyAreas()) {
+			_clut8Texture.updateArea(dirtyArea, _clut8Data);
+		}
 		clearDirty();
 	}
 
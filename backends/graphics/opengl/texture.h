@@ -29,6 +29,7 @@
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 
+#include "common/array.h"
 #include "common/rect.h"
 
 class Scaler;
@@ -99,7 +100,7 @@ public:
 	void fill(const Common::Rect &r, uint32 color);
 
 	void flagDirty() { _allDirty = true; }
-	virtual bool isDirty() const { return _allDirty || !_dirtyArea.isEmpty(); }
+	virtual bool isDirty() const { return _allDirty || !_dirtyAreas.empty(); }
 
 	virtual uint getWidth() const = 0;
 	virtual uint getHeight() const = 0;
@@ -139,13 +140,25 @@ public:
 	 */
 	virtual const Texture &getGLTexture() const = 0;
 protected:
-	void clearDirty() { _allDirty = false; _dirtyArea = Common::Rect(); }
+	void clearDirty() { _allDirty = false; _dirtyAreas.clear(); }
 
 	void addDirtyArea(const Common::Rect &r);
-	Common::Rect getDirtyArea() const;
+
+	/**
+	 * @return The areas that need to be updated.
+	 */
+	Common::Array<Common::Rect> getDirtyAreas() const;
 private:
+	/**
+	 * Maximum number of separate dirty areas. Past this, new areas are
+	 * merged with the closest existing one.
+	 */
+	static const uint kMaxDirtyAreas = 8;
+
+	static bool shouldMergeDirtyAreas(const Common::Rect &a, const Common::Rect &b);
+
 	bool _allDirty;
-	Common::Rect _dirtyArea;
+	Common::Array<Common::Rect> _dirtyAreas;
 };
 
 /**
@@ -189,6 +202,9 @@ public:
 protected:
 	const Graphics::PixelFormat _format;
 
+	/**
+	 * Upload one area of the texture data, without clearing the dirty state.
+	 */
 	void updateGLTexture(Common::Rect &dirtyArea);
 
 private:
@@ -25,6 +25,7 @@
 #include "backends/graphics/surfacesdl/surfacesdl-graphics.h"
 #include "backends/events/sdl/sdl-events.h"
 #include "common/config-manager.h"
+#include "common/jobsystem.h"
 #include "common/mutex.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
@@ -1270,6 +1271,29 @@ void SurfaceSdlGraphicsManager::updateScreen() {
 	internUpdateScreen();
 }
 
+void SurfaceSdlGraphicsManager::scaleArea(const byte *src, uint32 srcPitch, byte *dst, uint32 dstPitch, int width, int height, int x, int y, int factor) {
+	// Bands smaller than this are not worth the overhead of a job
+	const int minBandHeight = 32;
+
+	Common::JobSystem *jobSystem = g_system->getJobSystem();
+	const int bands = MIN<int>(jobSystem->getConcurrency(), height / minBandHeight);
+
+	if (bands <= 1 || factor == 1 || !_scalerPlugin->canScaleInParallel()) {
+		_scaler->scale(src, srcPitch, dst, dstPitch, width, height, x, y);
+		return;
+	}
+
+	// Each band reads the source pixels around it like when scaling the whole
+	// area at once: the padding and neighbouring lines are only read, so the
+	// output does not depend on how the area is split.
+	jobSystem->parallelFor(bands, [=](uint band) {
+		const int top = height * band / bands;
+		const int bottom = height * (band + 1) / bands;
+
+		_scaler->scale(src + top * srcPitch, srcPitch, dst + top * factor * dstPitch, dstPitch, width, bottom - top, x, y + top);
+	}, 1);
+}
+
 void SurfaceSdlGraphicsManager::updateScreen(SDL_Rect *dirtyRectList, int actualDirtyRects) {
 	SDL_UpdateRects(_hwScreen, actualDirtyRects, dirtyRectList);
 }
@@ -1514,8 +1538,8 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 				if (_videoMode.aspectRatioCorrection && !_overlayInGUI)
 					dst_y = real2Aspect(dst_y);
 
-				_scaler->scale((byte *)srcSurf->pixels + (src_x + _maxExtraPixels) * bpp + (src_y + _maxExtraPixels) * srcPitch, srcPitch,
-						(byte *)_hwScreen->pixels + dst_x * bpp + dst_y * dstPitch, dstPitch, dst_w, dst_h, src_x, src_y);
+				scaleArea((byte *)srcSurf->pixels + (src_x + _maxExtraPixels) * bpp + (src_y + _maxExtraPixels) * srcPitch, srcPitch,
+						(byte *)_hwScreen->pixels + dst_x * bpp + dst_y * dstPitch, dstPitch, dst_w, dst_h, src_x, src_y, scale1);
 
 				r->x = dst_x;
 				r->y = dst_y;
@@ -437,6 +437,12 @@ protected:
 	virtual void internUpdateScreen();
 	virtual void updateScreen(SDL_Rect *dirtyRectList, int actualDirtyRects);
 
+	/**
+	 * Scale an area of the game or overlay screen, splitting it in
+	 * horizontal bands scaled by the job system when it is large enough.
+	 */
+	void scaleArea(const byte *src, uint32 srcPitch, byte *dst, uint32 dstPitch, int width, int height, int x, int y, int factor);
+
 	virtual bool loadGFXMode();
 	virtual void unloadGFXMode();
 	virtual bool hotswapGFXMode();
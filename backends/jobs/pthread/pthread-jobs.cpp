@@ -0,0 +1,197 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+#define FORBIDDEN_SYMBOL_EXCEPTION_unistd_h
+
+#include "backends/jobs/pthread/pthread-jobs.h"
+
+#include "common/array.h"
+#include "common/list.h"
+#include "common/util.h"
+#include "common/textconsole.h"
+
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+
+/**
+ * pthreads job system implementation
+ *
+ * Jobs are kept in a single queue shared by all workers. Threads waiting
+ * for a group run the queued jobs of that group themselves, so nested waits
+ * cannot deadlock, and a waiting thread never runs unrelated jobs.
+ */
+class PthreadJobSystem final : public Common::JobSystem {
+public:
+	PthreadJobSystem(uint workerCount);
+	~PthreadJobSystem() override;
+
+	uint getWorkerCount() const override { return _threads.size(); }
+
+	void submit(JobGroup &group, JobProc proc, void *refCon, uint index) override;
+	void wait(JobGroup &group) override;
+
+private:
+	struct Job {
+		JobGroup *group;
+		JobProc proc;
+		void *refCon;
+		uint index;
+	};
+
+	static void *workerMain(void *arg);
+
+	/** Run a job taken from the queue, to be called with the mutex held. */
+	void runJob(const Job &job);
+
+	/** Take the first queued job of the group, to be called with the mutex held. */
+	bool takeJob(const JobGroup &group, Job &job);
+
+	pthread_mutex_t _mutex;
+	pthread_cond_t _jobAvailable;
+	pthread_cond_t _jobDone;
+
+	Common::List<Job> _queue;
+	Common::Array<pthread_t> _threads;
+	bool _quit;
+};
+
+PthreadJobSystem::PthreadJobSystem(uint workerCount) : _quit(false) {
+	pthread_mutex_init(&_mutex, nullptr);
+	pthread_cond_init(&_jobAvailable, nullptr);
+	pthread_cond_init(&_jobDone, nullptr);
+
+	// Workers must not receive the signals meant for the main thread.
+	sigset_t allSignals, oldSignals;
+	sigfillset(&allSignals);
+	pthread_sigmask(SIG_SETMASK, &allSignals, &oldSignals);
+
+	for (uint i = 0; i < workerCount; i++) {
+		pthread_t thread;
+		if (pthread_create(&thread, nullptr, workerMain, this) != 0) {
+			warning("pthread_create() failed, using %u job worker threads", i);
+			break;
+		}
+		_threads.push_back(thread);
+	}
+
+	pthread_sigmask(SIG_SETMASK, &oldSignals, nullptr);
+}
+
+PthreadJobSystem::~PthreadJobSystem() {
+	// The workers run the jobs left in the queue before exiting, so that
+	// no group is left with jobs which will never finish.
+	pthread_mutex_lock(&_mutex);
+	_quit = true;
+	pthread_cond_broadcast(&_jobAvailable);
+	pthread_mutex_unlock(&_mutex);
+
+	for (uint i = 0; i < _threads.size(); i++) {
+		pthread_join(_threads[i], nullptr);
+	}
+
+	pthread_cond_destroy(&_jobDone);
+	pthread_cond_destroy(&_jobAvailable);
+	pthread_mutex_destroy(&_mutex);
+}
+
+void *PthreadJobSystem::workerMain(void *arg) {
+	PthreadJobSystem *jobSystem = (PthreadJobSystem *)arg;
+
+	pthread_mutex_lock(&jobSystem->_mutex);
+	for (;;) {
+		if (jobSystem->_queue.empty()) {
+			if (jobSystem->_quit)
+				break;
+			pthread_cond_wait(&jobSystem->_jobAvailable, &jobSystem->_mutex);
+			continue;
+		}
+		const Job job = jobSystem->_queue.front();
+		jobSystem->_queue.pop_front();
+		jobSystem->runJob(job);
+	}
+	pthread_mutex_unlock(&jobSystem->_mutex);
+
+	return nullptr;
+}
+
+void PthreadJobSystem::runJob(const Job &job) {
+	pthread_mutex_unlock(&_mutex);
+	job.proc(job.refCon, job.index);
+	pthread_mutex_lock(&_mutex);
+
+	if (removePending(*job.group))
+		pthread_cond_broadcast(&_jobDone);
+}
+
+bool PthreadJobSystem::takeJob(const JobGroup &group, Job &job) {
+	for (Common::List<Job>::iterator i = _queue.begin(); i != _queue.end(); ++i) {
+		if (i->group == &group) {
+			job = *i;
+			_queue.erase(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+void PthreadJobSystem::submit(JobGroup &group, JobProc proc, void *refCon, uint index) {
+	if (_threads.empty()) {
+		proc(refCon, index);
+		return;
+	}
+
+	Job job;
+	job.group = &group;
+	job.proc = proc;
+	job.refCon = refCon;
+	job.index = index;
+
+	pthread_mutex_lock(&_mutex);
+	addPending(group);
+	_queue.push_back(job);
+	pthread_cond_signal(&_jobAvailable);
+	pthread_mutex_unlock(&_mutex);
+}
+
+void PthreadJobSystem::wait(JobGroup &group) {
+	pthread_mutex_lock(&_mutex);
+	while (!isDone(group)) {
+		// Only help with the jobs of this group, other jobs could take long
+		// or expect to run in another context than the caller's stack.
+		Job job;
+		if (takeJob(group, job)) {
+			runJob(job);
+		} else {
+			pthread_cond_wait(&_jobDone, &_mutex);
+		}
+	}
+	pthread_mutex_unlock(&_mutex);
+}
+
+Common::JobSystem *createPthreadJobSystem(int workerCount) {
+	if (workerCount < 0) {
+		long processors = sysconf(_SC_NPROCESSORS_ONLN);
+		workerCount = CLIP<long>(processors - 1, 0, 31);
+	}
+	return new PthreadJobSystem(workerCount);
+}
@@ -266,6 +266,16 @@ MODULE_OBJS += \
 	taskbar/unity/unity-taskbar.o \
 	dialogs/gtk/gtk-dialogs.o
 
+ifdef HAS_PTHREAD
+MODULE_OBJS += \
+	jobs/pthread/pthread-jobs.o
+endif
+
+ifdef HAS_MMAP
+MODULE_OBJS += \
+	fs/posix/posix-mmapstream.o
+endif
+
 ifdef USE_SPEECH_DISPATCHER
 ifdef USE_TTS
 MODULE_OBJS += \
@@ -36,6 +36,7 @@
 #include "backends/saves/posix/posix-saves.h"
 #include "backends/fs/posix/posix-fs-factory.h"
 #include "backends/fs/posix/posix-fs.h"
+#include "backends/jobs/pthread/pthread-jobs.h"
 #include "backends/taskbar/unity/unity-taskbar.h"
 #include "backends/dialogs/gtk/gtk-dialogs.h"
 
@@ -64,6 +65,11 @@ void OSystem_POSIX::init() {
 	// Initialze File System Factory
 	_fsFactory = new POSIXFilesystemFactory();
 
+#ifdef HAS_PTHREAD
+	// Initialize job system
+	_jobSystem = createPthreadJobSystem();
+#endif
+
 #if defined(USE_TASKBAR) && defined(USE_UNITY)
 	// Initialize taskbar manager
 	_taskbarManager = new UnityTaskbarManager();
@@ -175,6 +175,8 @@ static const char HELP_STRING4[] =
 	"  --enable-gs              Enable Roland GS mode for MIDI playback\n"
 	"  --output-channels=CHANNELS Select output channel count (e.g. 2 for stereo)\n"
 	"  --output-rate=RATE       Select output sample rate in Hz (e.g. 22050)\n"
+	"  --resampler-quality=NUM  Select resampler quality (0 for linear interpolation,\n"
+	"                           1-3 for increasingly sharp windowed sinc filters)\n"
 	"  --opl-driver=DRIVER      Select AdLib (OPL) emulator (db, mame"
 #ifndef DISABLE_NUKED_OPL
 																	 ", nuked"
@@ -316,6 +318,7 @@ void registerDefaults() {
 	ConfMan.registerDefault("sfx_mute", false);
 	ConfMan.registerDefault("speech_mute", false);
 	ConfMan.registerDefault("mute", false);
+	ConfMan.registerDefault("resampler_quality", 0);
 
 	ConfMan.registerDefault("multi_midi", false);
 	ConfMan.registerDefault("native_mt32", false);
@@ -769,6 +772,9 @@ Common::String parseCommandLine(Common::StringMap &settings, int argc, const cha
 			DO_LONG_OPTION_INT("output-rate")
 			END_OPTION
 
+			DO_LONG_OPTION_INT("resampler-quality")
+			END_OPTION
+
 			DO_OPTION_BOOL('f', "fullscreen")
 			END_OPTION
 
@@ -1502,16 +1508,8 @@ static void dumpAllDetectionEntries() {
 	}
 }
 
-/** Display all games in the given directory, or current directory if empty */
-static DetectedGames getGameList(const Common::FSNode &dir) {
-	Common::FSList files;
-
-	// Collect all files from directory
-	if (!dir.getChildren(files, Common::FSNode::kListAll)) {
-		printf("Path %s does not exist or is not a directory.\n", dir.getPath().toString(Common::Path::kNativeSeparator).c_str());
-		return DetectedGames();
-	}
-
+/** Display all games in the given directory listing */
+static DetectedGames getGameList(const Common::FSList &files) {
 	// detect Games
 	DetectionResults detectionResults = EngineMan.detectGames(files);
 
@@ -1523,14 +1521,44 @@ static DetectedGames getGameList(const Common::FSNode &dir) {
 	return detectionResults.listRecognizedGames();
 }
 
-static DetectedGames recListGames(const Common::FSNode &dir, const Common::String &engineId, const Common::String &gameId, bool recursive) {
-	DetectedGames list = getGameList(dir);
+/** Collect all files from the given directory, or current directory if empty */
+static bool listDirectory(const Common::FSNode &dir, Common::FSList &files) {
+	if (!dir.getChildren(files, Common::FSNode::kListAll)) {
+		printf("Path %s does not exist or is not a directory.\n", dir.getPath().toString(Common::Path::kNativeSeparator).c_str());
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * List the subdirectories found in @p files for the next level of a recursive
+ * scan. They are listed and hashed all at once, to overlap their I/O.
+ */
+static void listSubdirectories(const Common::FSList &files, Common::FSList &dirs, Common::Array<Common::FSList> &contents) {
+	for (const auto &file : files) {
+		if (file.isDirectory())
+			dirs.push_back(file);
+	}
+
+	Common::Array<bool> listed;
+	EngineMan.listDirectories(dirs, contents, listed);
+
+	for (uint i = 0; i < dirs.size(); i++) {
+		if (!listed[i])
+			printf("Path %s does not exist or is not a directory.\n", dirs[i].getPath().toString(Common::Path::kNativeSeparator).c_str());
+	}
+}
+
+static DetectedGames recListGames(const Common::FSList &files, const Common::String &engineId, const Common::String &gameId, bool recursive) {
+	DetectedGames list = getGameList(files);
 
 	if (recursive) {
-		Common::FSList files;
-		dir.getChildren(files, Common::FSNode::kListDirectoriesOnly);
-		for (const auto &file : files) {
-			DetectedGames rec = recListGames(file, engineId, gameId, recursive);
+		Common::FSList dirs;
+		Common::Array<Common::FSList> contents;
+		listSubdirectories(files, dirs, contents);
+		for (uint i = 0; i < dirs.size(); i++) {
+			DetectedGames rec = recListGames(contents[i], engineId, gameId, recursive);
 			for (auto &game : rec) {
 				if ((game.engineId == engineId && game.gameId == gameId)
 				    || gameId.empty())
@@ -1542,12 +1570,22 @@ static DetectedGames recListGames(const Common::FSNode &dir, const Common::Strin
 	return list;
 }
 
+static DetectedGames recListGames(const Common::FSNode &dir, const Common::String &engineId, const Common::String &gameId, bool recursive) {
+	Common::FSList files;
+	if (!listDirectory(dir, files))
+		return DetectedGames();
+
+	return recListGames(files, engineId, gameId, recursive);
+}
+
 /** Display all games in the given directory, return ID of first detected game */
 static Common::String detectGames(const Common::Path &path, const Common::String &engineId, const Common::String &gameId, bool recursive) {
 	bool noPath = path.empty();
 	//Current directory
 	Common::FSNode dir(path);
 	DetectedGames candidates = recListGames(dir, engineId, gameId, recursive);
+	ADCacheMan.savePersistentCache();
+	ADCacheMan.clearPrefetched();
 
 	if (candidates.empty()) {
 		printf("WARNING: ScummVM could not find any game in %s\n", dir.getPath().toString(Common::Path::kNativeSeparator).c_str());
@@ -1572,9 +1610,9 @@ static Common::String detectGames(const Common::Path &path, const Common::String
 	return buildQualifiedGameName(candidates[0].engineId, candidates[0].gameId);
 }
 
-static int recAddGames(const Common::FSNode &dir, const Common::String &engineId, const Common::String &gameId, bool recursive) {
+static int recAddGames(const Common::FSList &files, const Common::String &engineId, const Common::String &gameId, bool recursive) {
 	int count = 0;
-	DetectedGames list = getGameList(dir);
+	DetectedGames list = getGameList(files);
 	for (const auto &v : list) {
 		if ((v.engineId != engineId || v.gameId != gameId)
 		    && !gameId.empty()) {
@@ -1601,17 +1639,25 @@ static int recAddGames(const Common::FSNode &dir, const Common::String &engineId
 	}
 
 	if (recursive) {
-		Common::FSList files;
-		if (dir.getChildren(files, Common::FSNode::kListDirectoriesOnly)) {
-			for (const auto &file : files) {
-				count += recAddGames(file, engineId, gameId, recursive);
-			}
+		Common::FSList dirs;
+		Common::Array<Common::FSList> contents;
+		listSubdirectories(files, dirs, contents);
+		for (uint i = 0; i < dirs.size(); i++) {
+			count += recAddGames(contents[i], engineId, gameId, recursive);
 		}
 	}
 
 	return count;
 }
 
+static int recAddGames(const Common::FSNode &dir, const Common::String &engineId, const Common::String &gameId, bool recursive) {
+	Common::FSList files;
+	if (!listDirectory(dir, files))
+		return 0;
+
+	return recAddGames(files, engineId, gameId, recursive);
+}
+
 static void calcMD5(Common::FSNode &path, int32 length) {
 	if (!path.exists()) {
 		usage("File '%s' does not exist", path.getName().c_str());
@@ -1691,6 +1737,8 @@ static bool addGames(const Common::Path &path, const Common::String &engineId, c
 	//Current directory
 	Common::FSNode dir(path);
 	int added = recAddGames(dir, engineId, gameId, recursive);
+	ADCacheMan.savePersistentCache();
+	ADCacheMan.clearPrefetched();
 	printf("Added %d games\n", added);
 	if (added == 0 && !recursive) {
 		printf("Consider using --recursive to search inside subdirectories\n");
@@ -25,6 +25,8 @@
 #include "common/debug.h"
 #include "common/debug-channels.h"
 #include "common/config-manager.h"
+#include "common/jobsystem.h"
+#include "common/system.h"
 
 #ifdef DYNAMIC_MODULES
 #include "common/fs.h"
@@ -692,10 +694,23 @@ DetectionResults EngineManager::detectGames(const Common::FSList &fslist, uint32
 
 	// Close all archives that were opened during detection
 	ADCacheMan.clearArchives();
+	ADCacheMan.savePersistentCache(false);
 
 	return DetectionResults(candidates);
 }
 
+void EngineManager::listDirectories(const Common::FSList &dirs, Common::Array<Common::FSList> &contents, Common::Array<bool> &listed) const {
+	contents.clear();
+	contents.resize(dirs.size());
+	listed.resize(dirs.size());
+
+	g_system->getJobSystem()->parallelFor(dirs.size(), [&dirs, &contents, &listed](uint i) {
+		listed[i] = dirs[i].getChildren(contents[i], Common::FSNode::kListAll);
+	}, 1);
+
+	ADCacheMan.prefetchFileProperties(contents);
+}
+
 const PluginList &EngineManager::getPlugins(const PluginType fetchPluginType) const {
 	return PluginManager::instance().getPlugins(fetchPluginType);
 }
@@ -900,6 +915,7 @@ void EngineManager::upgradeTargetForEngineId(const Common::String &target) const
 		// Clear md5 cache before detection starts
 		ADCacheMan.clear();
 		DetectedGames candidates = metaEngine.detectGames(files);
+		ADCacheMan.savePersistentCache();
 		if (candidates.empty()) {
 			warning("No games supported by the engine '%s' were found in path '%s' when upgrading target '%s'",
 			        metaEngine.getName(), path.toString(Common::Path::kNativeSeparator).c_str(), target.c_str());
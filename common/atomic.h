@@ -0,0 +1,153 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_ATOMIC_H
+#define COMMON_ATOMIC_H
+
+#include "common/scummsys.h"
+#include "common/intrinsics.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_atomic Atomic operations
+ * @ingroup common
+ *
+ * @brief Minimal helpers for sharing word-sized values between threads
+ *        without taking a lock.
+ *
+ * Loads have acquire semantics and stores have release semantics, which is
+ * enough to publish data written before the store to a thread that observes
+ * the stored value. Only use these with naturally aligned values no larger
+ * than a pointer.
+ * @{
+ */
+
+#if defined(__GNUC__)
+
+template<typename T>
+inline T atomicLoad(const volatile T *ptr) {
+	return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+template<typename T>
+inline void atomicStore(volatile T *ptr, T value) {
+	__atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+#elif defined(_MSC_VER)
+
+// Plain volatile accesses are not ordered on ARM, nor anywhere when building
+// with /volatile:iso, so use the ISO volatile intrinsics, which never tear,
+// together with an explicit barrier.
+inline void atomicBarrier() {
+#if defined(_M_ARM64)
+	__dmb(_ARM64_BARRIER_ISH);
+#elif defined(_M_ARM)
+	__dmb(_ARM_BARRIER_ISH);
+#else
+	// x86 and x64 do not reorder a load with later accesses or a store with
+	// earlier ones, so keeping the compiler from doing so is enough.
+	_ReadWriteBarrier();
+#endif
+}
+
+template<typename T>
+inline T atomicLoad(const volatile T *ptr) {
+	T value;
+	switch (sizeof(T)) {
+	case 1: {
+		const __int8 raw = __iso_volatile_load8((const volatile __int8 *)ptr);
+		memcpy(&value, &raw, sizeof(T));
+		break;
+	}
+	case 2: {
+		const __int16 raw = __iso_volatile_load16((const volatile __int16 *)ptr);
+		memcpy(&value, &raw, sizeof(T));
+		break;
+	}
+	case 4: {
+		const __int32 raw = __iso_volatile_load32((const volatile __int32 *)ptr);
+		memcpy(&value, &raw, sizeof(T));
+		break;
+	}
+	default: {
+		const __int64 raw = __iso_volatile_load64((const volatile __int64 *)ptr);
+		memcpy(&value, &raw, sizeof(T));
+		break;
+	}
+	}
+	atomicBarrier();
+	return value;
+}
+
+template<typename T>
+inline void atomicStore(volatile T *ptr, T value) {
+	atomicBarrier();
+	switch (sizeof(T)) {
+	case 1: {
+		__int8 raw;
+		memcpy(&raw, &value, sizeof(T));
+		__iso_volatile_store8((volatile __int8 *)ptr, raw);
+		break;
+	}
+	case 2: {
+		__int16 raw;
+		memcpy(&raw, &value, sizeof(T));
+		__iso_volatile_store16((volatile __int16 *)ptr, raw);
+		break;
+	}
+	case 4: {
+		__int32 raw;
+		memcpy(&raw, &value, sizeof(T));
+		__iso_volatile_store32((volatile __int32 *)ptr, raw);
+		break;
+	}
+	default: {
+		__int64 raw;
+		memcpy(&raw, &value, sizeof(T));
+		__iso_volatile_store64((volatile __int64 *)ptr, raw);
+		break;
+	}
+	}
+}
+
+#else
+
+// Best effort for single core targets: volatile keeps the compiler from
+// caching the value.
+template<typename T>
+inline T atomicLoad(const volatile T *ptr) {
+	return *ptr;
+}
+
+template<typename T>
+inline void atomicStore(volatile T *ptr, T value) {
+	*ptr = value;
+}
+
+#endif
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -136,6 +136,14 @@ static inline bool inflateClickteam(byte *dst, uint  dstLen, const byte *src, ui
 SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped,
 		DisposeAfterUse::Flag disposeParent = DisposeAfterUse::YES, uint64 knownSize = 0);
 
+/**
+ * Like wrapCompressedReadStream(), but always decompresses with the built-in
+ * inflater, even when there is ZLIB support. Without ZLIB support, this is
+ * what wrapCompressedReadStream() uses.
+ */
+SeekableReadStream *wrapGzioReadStream(SeekableReadStream *toBeWrapped,
+		DisposeAfterUse::Flag disposeParent = DisposeAfterUse::YES, uint64 knownSize = 0);
+
 /**
  * Take an arbitrary SeekableReadStream and wrap it in a custom stream which
  * provides transparent on-the-fly decompression. Assumes the data it
@@ -34,6 +34,7 @@
    comments to that effect with your name and the date.  Thank you.
  */
 
+#include "common/array.h"
 #include "common/debug.h"
 #include "common/endian.h"
 #include "common/stream.h"
@@ -223,7 +224,7 @@ public:
 		_lastBlock(0), _codeState (0), _inflateN(0),
 		_inflateD(0), _bb(0), _bk(0), _wp(0), _tl(nullptr),
 		_td(nullptr), _bl(0),
-		_bd(0), _savedOffset(0), _err(false), _mode(mode), _input(parent, disposeParent),
+		_bd(0), _savedOffset(0), _numLiteralCodes(0), _numDistanceCodes(0), _err(false), _mode(mode), _input(parent, disposeParent),
 		_inbufD(0), _inbufSize(0), _uncompressedSize(uncompressedSize), _streamPos(0), _eos(false) {
 
 		if (dict && dict_size) {
@@ -232,6 +233,11 @@ public:
 		}
 	}
 
+	~GzioReadStream() {
+		for (Checkpoint *checkpoint : _checkpoints)
+			delete checkpoint;
+	}
+
 	uint32 read(void *dataPtr, uint32 dataSize) override;
 
 	bool eos() const override { return _eos; }
@@ -257,6 +263,39 @@ private:
 	static const int WSIZE = 0x8000;
 	static const int INBUFSIZ = 0x2000;
 
+	/*
+	 *  Distance between two checkpoints in the uncompressed data
+	 *
+	 *  This must be a multiple of WSIZE
+	 */
+	static const int CHECKPOINT_INTERVAL = 0x100000;
+
+	/*
+	 *  Maximum number of literal/length and distance codes
+	 */
+	static const int MAX_CODES = 286 + 30;
+
+	/* The state needed to resume decompression at a window boundary.  */
+	struct Checkpoint {
+		/* The offset in uncompressed data.  */
+		int64 offset;
+		/* The offset in the underlying stream.  */
+		int64 inputPos;
+		int blockType;
+		int blockLen;
+		int lastBlock;
+		int codeState;
+		unsigned inflateN;
+		unsigned inflateD;
+		unsigned long bb;
+		unsigned bk;
+		/* The code lengths of a dynamic block, to rebuild its tables.  */
+		unsigned numLiteralCodes;
+		unsigned numDistanceCodes;
+		uint8 codeLengths[MAX_CODES];
+		uint8 slide[WSIZE];
+	};
+
 	/* If input is in memory following fields are used instead of file.  */
 	Common::DisposablePtr<Common::SeekableReadStream> _input;
 	/* The offset at which the data starts in the underlying file.  */
@@ -291,6 +330,12 @@ private:
 	int _bd;
 	/* The original offset value.  */
 	int64 _savedOffset;
+	/* The code lengths of the current dynamic block.  */
+	unsigned _numLiteralCodes;
+	unsigned _numDistanceCodes;
+	uint8 _codeLengths[MAX_CODES];
+	/* The checkpoints recorded so far, sorted by offset.  */
+	Common::Array<Checkpoint *> _checkpoints;
 
 	bool _err;
 
@@ -310,6 +355,10 @@ private:
 	int inflate_codes_in_window();
 	void init_dynamic_block ();
 	void init_stored_block ();
+	void build_dynamic_tables (unsigned *ll, unsigned nl, unsigned nd);
+	void save_checkpoint ();
+	const Checkpoint *find_checkpoint (int64 offset) const;
+	void restore_checkpoint (const Checkpoint &checkpoint);
 	int32 readAtOffset(int64 offset, byte *buf, uint32 len);
 };
 
@@ -922,7 +971,33 @@ GzioReadStream::init_dynamic_block ()
   _bb = b;
   _bk = k;
 
-  /* build the decoding tables for literal/length and distance codes */
+  /* keep the code lengths for checkpoints within this block */
+  _numLiteralCodes = nl;
+  _numDistanceCodes = nd;
+  for (j = 0; j < n; j++)
+    _codeLengths[j] = ll[j];
+
+  build_dynamic_tables (ll, nl, nd);
+  if (_err)
+    return;
+
+  /* indicate we're now working on a block */
+  _codeState = 0;
+  _blockLen++;
+  return;
+
+ fail:
+  huft_free (_tl);
+  _td = NULL;
+  _tl = NULL;
+}
+
+
+/* build the decoding tables for literal/length and distance codes */
+
+void
+GzioReadStream::build_dynamic_tables (unsigned *ll, unsigned nl, unsigned nd)
+{
   _bl = lbits;
   if (huft_build (ll, nl, 257, cplens, cplext, &_tl, &_bl) != 0)
     {
@@ -939,16 +1014,6 @@ GzioReadStream::init_dynamic_block ()
       _err = true;
       return;
     }
-
-  /* indicate we're now working on a block */
-  _codeState = 0;
-  _blockLen++;
-  return;
-
- fail:
-  huft_free (_tl);
-  _td = NULL;
-  _tl = NULL;
 }
 
 
@@ -1086,6 +1151,97 @@ GzioReadStream::inflate_window ()
     }
 
   _savedOffset += _wp;
+
+  if (_wp == WSIZE && !_err && _savedOffset % CHECKPOINT_INTERVAL == 0)
+    save_checkpoint ();
+}
+
+
+void
+GzioReadStream::save_checkpoint ()
+{
+  /* Only the furthest point decompressed so far adds a new checkpoint.  */
+  if (!_checkpoints.empty () && _checkpoints.back ()->offset >= _savedOffset)
+    return;
+
+  Checkpoint *checkpoint = new Checkpoint ();
+  checkpoint->offset = _savedOffset;
+  checkpoint->inputPos = _input->pos () - (_inbufSize - _inbufD);
+  checkpoint->blockType = _blockType;
+  checkpoint->blockLen = _blockLen;
+  checkpoint->lastBlock = _lastBlock;
+  checkpoint->codeState = _codeState;
+  checkpoint->inflateN = _inflateN;
+  checkpoint->inflateD = _inflateD;
+  checkpoint->bb = _bb;
+  checkpoint->bk = _bk;
+  checkpoint->numLiteralCodes = _numLiteralCodes;
+  checkpoint->numDistanceCodes = _numDistanceCodes;
+  memcpy (checkpoint->codeLengths, _codeLengths, sizeof (_codeLengths));
+  memcpy (checkpoint->slide, _slide, WSIZE);
+
+  _checkpoints.push_back (checkpoint);
+}
+
+
+/* find the last checkpoint at or before offset */
+
+const GzioReadStream::Checkpoint *
+GzioReadStream::find_checkpoint (int64 offset) const
+{
+  uint lo = 0, hi = _checkpoints.size ();
+
+  while (lo < hi)
+    {
+      uint mid = (lo + hi) / 2;
+      if (_checkpoints[mid]->offset <= offset)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  return lo ? _checkpoints[lo - 1] : NULL;
+}
+
+
+void
+GzioReadStream::restore_checkpoint (const Checkpoint &checkpoint)
+{
+  huft_free (_tl);
+  huft_free (_td);
+  _tl = NULL;
+  _td = NULL;
+
+  /* rebuild the tables of a Huffman block interrupted by the window */
+  if (checkpoint.blockLen && checkpoint.blockType == INFLATE_FIXED)
+    init_fixed_block ();
+  else if (checkpoint.blockLen && checkpoint.blockType == INFLATE_DYNAMIC)
+    {
+      unsigned ll[MAX_CODES];
+      unsigned n = checkpoint.numLiteralCodes + checkpoint.numDistanceCodes;
+
+      for (unsigned i = 0; i < n; i++)
+	ll[i] = checkpoint.codeLengths[i];
+
+      build_dynamic_tables (ll, checkpoint.numLiteralCodes, checkpoint.numDistanceCodes);
+
+      _numLiteralCodes = checkpoint.numLiteralCodes;
+      _numDistanceCodes = checkpoint.numDistanceCodes;
+      memcpy (_codeLengths, checkpoint.codeLengths, sizeof (_codeLengths));
+    }
+
+  parentSeek (checkpoint.inputPos);
+  _blockType = checkpoint.blockType;
+  _blockLen = checkpoint.blockLen;
+  _lastBlock = checkpoint.lastBlock;
+  _codeState = checkpoint.codeState;
+  _inflateN = checkpoint.inflateN;
+  _inflateD = checkpoint.inflateD;
+  _bb = checkpoint.bb;
+  _bk = checkpoint.bk;
+  memcpy (_slide, checkpoint.slide, WSIZE);
+  _wp = WSIZE;
+  _savedOffset = checkpoint.offset;
 }
 
 
@@ -1241,9 +1397,18 @@ GzioReadStream::readAtOffset (int64 offset, byte *buf, uint32 len)
 {
   int32 ret = 0;
 
-  /* Do we reset decompression to the beginning of the file?  */
-  if (_savedOffset > offset + WSIZE)
-    initialize_tables();
+  /* Do we resume decompression from an earlier point, or skip ahead to a
+     checkpoint past the current window?  */
+  const Checkpoint *checkpoint = find_checkpoint (offset);
+
+  if (_savedOffset > offset + WSIZE
+      || (checkpoint && checkpoint->offset > _savedOffset))
+    {
+      if (checkpoint)
+	restore_checkpoint (*checkpoint);
+      else
+	initialize_tables();
+    }
 
   /*
    *  This loop operates upon uncompressed data only.  The only
@@ -1325,8 +1490,7 @@ bool GzioReadStream::seek(int64 offs, int whence) {
 	return true;
 }
 
-#ifndef USE_ZLIB
-SeekableReadStream* wrapCompressedReadStream(Common::SeekableReadStream *parent, DisposeAfterUse::Flag disposeParent, uint64 knownSize) {
+SeekableReadStream* wrapGzioReadStream(Common::SeekableReadStream *parent, DisposeAfterUse::Flag disposeParent, uint64 knownSize) {
 	if (!parent)
 		return nullptr;
 
@@ -1373,6 +1537,11 @@ SeekableReadStream* wrapCompressedReadStream(Common::SeekableReadStream *parent,
 	return gzio;
 }
 
+#ifndef USE_ZLIB
+SeekableReadStream* wrapCompressedReadStream(Common::SeekableReadStream *parent, DisposeAfterUse::Flag disposeParent, uint64 knownSize) {
+	return wrapGzioReadStream(parent, disposeParent, knownSize);
+}
+
 SeekableReadStream* wrapDeflateReadStream(Common::SeekableReadStream *parent, DisposeAfterUse::Flag disposeParent, uint64 knownSize, const byte *dict, uint dictLen) {
 	if (!parent)
 		return nullptr;
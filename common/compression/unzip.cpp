@@ -72,8 +72,16 @@
 
 #ifdef USE_ZLIB
 #include <zlib.h>
+
+// Older zlib versions can only seek backward in a deflate stream by
+// decompressing it from the start again
+#if ZLIB_VERNUM >= 0x1271
+#define UNZ_SEEKABLE_DEFLATE
+#endif
 #else  // !USE_ZLIB
 
+#define UNZ_SEEKABLE_DEFLATE
+
 // Even when zlib is not linked in, we can still open ZIP archives and read
 // files from them.  Attempted decompression of compressed files will use GZio
 //
@@ -95,8 +103,11 @@ typedef Byte Bytef;
 #include "common/compression/deflate.h"
 #include "common/compression/unzip.h"
 #include "common/memstream.h"
+#include "common/mutex.h"
+#include "common/ptr.h"
+#include "common/substream.h"
 
-#include "common/hashmap.h"
+#include "common/flathashmap.h"
 #include "common/hash-str.h"
 
 #if defined(STRICTUNZIP) || defined(STRICTZIPUNZIP)
@@ -237,6 +248,13 @@ Common::SharedArchiveContents unzOpenCurrentFile(unzFile file
   If there is no error, the return value is UNZ_OK.
 */
 
+Common::SeekableReadStream *unzOpenCurrentFileStream(unzFile file);
+/*
+  Open the current file in the zipfile as a stream which reads and
+  decompresses its data on demand. The CRC is not checked.
+  Return NULL if there is an error.
+*/
+
 int unzCloseCurrentFile(unzFile file);
 /*
   Close the file in zip opened with unzOpenCurrentFile
@@ -318,9 +336,92 @@ typedef struct {
 	unz_file_info_internal cur_file_info_internal;	/* private info about it*/
 } cached_file_in_zip;
 
-typedef Common::HashMap<Common::Path, cached_file_in_zip, Common::Path::IgnoreCase_Hash,
+typedef Common::FlatHashMap<Common::Path, cached_file_in_zip, Common::Path::IgnoreCase_Hash,
 	Common::Path::IgnoreCase_EqualTo> ZipHash;
 
+/* unz_shared_stream owns the zipfile stream. It is shared with the streams
+   returned by unzOpenCurrentFileStream, which may outlive the zipfile and
+   may be read from another thread, hence the mutex */
+struct unz_shared_stream {
+	unz_shared_stream(Common::SeekableReadStream *stream) : _stream(stream) {}
+
+	Common::ScopedPtr<Common::SeekableReadStream> _stream;
+	Common::Mutex _mutex;
+};
+
+class ZipMemberReadStream : public Common::SafeMutexedSeekableSubReadStream {
+public:
+	/* the caller must hold the mutex of the shared stream */
+	ZipMemberReadStream(const Common::SharedPtr<unz_shared_stream> &shared, uint32 begin, uint32 end)
+		: Common::SafeMutexedSeekableSubReadStream(shared->_stream.get(), begin, end, DisposeAfterUse::NO, shared->_mutex),
+		  _shared(shared) {
+	}
+
+private:
+	Common::SharedPtr<unz_shared_stream> _shared;
+};
+
+/* ZipMemberCrcReadStream checks the CRC of a member returned by
+   unzOpenCurrentFileStream once all of it has been read. Only the data read
+   in order from the start of the member is summed up. */
+class ZipMemberCrcReadStream : public Common::SeekableReadStream {
+public:
+	ZipMemberCrcReadStream(Common::SeekableReadStream *parentStream, uint32 expectedCrc)
+		: _parentStream(parentStream, DisposeAfterUse::YES), _expectedCrc(expectedCrc), _checkedSize(0), _crcError(false) {
+#ifdef USE_ZLIB
+		_crc32 = crc32(0, nullptr, 0);
+#else
+		_crc32 = _crc.getInitRemainder();
+#endif
+	}
+
+	bool eos() const override { return _parentStream->eos(); }
+	bool err() const override { return _crcError || _parentStream->err(); }
+	void clearErr() override { _parentStream->clearErr(); }
+	int64 pos() const override { return _parentStream->pos(); }
+	int64 size() const override { return _parentStream->size(); }
+	bool seek(int64 offset, int whence = SEEK_SET) override { return _parentStream->seek(offset, whence); }
+
+	uint32 read(void *dataPtr, uint32 dataSize) override {
+		const int64 start = _parentStream->pos();
+		const uint32 len = _parentStream->read(dataPtr, dataSize);
+
+		if (start <= _checkedSize && start + len > _checkedSize) {
+			const byte *data = (const byte *)dataPtr + (_checkedSize - start);
+			const uint32 dataLen = start + len - _checkedSize;
+#ifdef USE_ZLIB
+			_crc32 = crc32(_crc32, data, dataLen);
+#else
+			for (uint32 i = 0; i < dataLen; i++)
+				_crc32 = _crc.processByte(data[i], _crc32);
+#endif
+			_checkedSize += dataLen;
+
+			if (_checkedSize == size()) {
+#ifndef USE_ZLIB
+				_crc32 = _crc.finalize(_crc32);
+#endif
+				if (_crc32 != _expectedCrc) {
+					warning("CRC32 mismatch: %08x, %08x", _crc32, _expectedCrc);
+					_crcError = true;
+				}
+			}
+		}
+
+		return len;
+	}
+
+private:
+	Common::DisposablePtr<Common::SeekableReadStream> _parentStream;
+#ifndef USE_ZLIB
+	Common::CRC32 _crc;
+#endif
+	uint32 _crc32;
+	uint32 _expectedCrc;
+	int64 _checkedSize;
+	bool _crcError;
+};
+
 /* unz_s contain internal information about the zipfile
 */
 typedef struct {
@@ -335,11 +436,15 @@ typedef struct {
 	uLong size_central_dir;			/* size of the central directory  */
 	uLong offset_central_dir;		/* offset of start of central directory with
 									respect to the starting disk number */
+	uLong stream_offset;			/* offset of the first byte of _stream in the
+									zipfile, non-zero while the central directory
+									is parsed from memory */
 
 	unz_file_info cur_file_info;					/* public info about the current file in zip*/
 	unz_file_info_internal cur_file_info_internal;	/* private info about it*/
 
 	ZipHash _hash;
+	Common::SharedPtr<unz_shared_stream> _shared;
 } unz_s;
 
 /* ===========================================================================
@@ -459,6 +564,7 @@ unzFile unzOpen(Common::SeekableReadStream *stream, bool flattenTree) {
 	int err = UNZ_OK;
 
 	us->_stream = stream;
+	us->stream_offset = 0;
 
 	central_pos = unzlocal_SearchCentralDir(*us->_stream);
 	if (central_pos == 0)
@@ -525,6 +631,28 @@ unzFile unzOpen(Common::SeekableReadStream *stream, bool flattenTree) {
 		                    (us->offset_central_dir + us->size_central_dir);
 	us->central_pos = central_pos;
 
+	// Parse the central directory from memory, which replaces a seek and a
+	// few small reads per entry with a single read of the whole directory.
+	Common::SeekableReadStream *centralDir = nullptr;
+	const uLong centralDirStart = us->offset_central_dir + us->byte_before_the_zipfile;
+	if (us->_stream->seek(centralDirStart, SEEK_SET)) {
+		const byte *view = us->_stream->tryGetContiguousView(us->size_central_dir);
+		if (view) {
+			centralDir = new Common::MemoryReadStream(view, us->size_central_dir);
+		} else {
+			byte *buf = (byte *)malloc(us->size_central_dir);
+			if (buf && us->_stream->read(buf, us->size_central_dir) == us->size_central_dir)
+				centralDir = new Common::MemoryReadStream(buf, us->size_central_dir, DisposeAfterUse::YES);
+			else
+				free(buf);
+		}
+	}
+
+	if (centralDir) {
+		us->_stream = centralDir;
+		us->stream_offset = centralDirStart;
+	}
+
 	err = unzGoToFirstFile((unzFile)us);
 
 	while (err == UNZ_OK) {
@@ -591,6 +719,14 @@ unzFile unzOpen(Common::SeekableReadStream *stream, bool flattenTree) {
 		// Move to the next file
 		err = unzGoToNextFile((unzFile)us);
 	}
+
+	if (centralDir) {
+		delete centralDir;
+		us->_stream = stream;
+		us->stream_offset = 0;
+	}
+
+	us->_shared = Common::SharedPtr<unz_shared_stream>(new unz_shared_stream(stream));
 	return (unzFile)us;
 }
 
@@ -606,7 +742,7 @@ int unzClose(unzFile file) {
 		return UNZ_PARAMERROR;
 	s = (unz_s *)file;
 
-	delete s->_stream;
+	// The stream itself is owned by _shared
 	delete s;
 	return UNZ_OK;
 }
@@ -641,7 +777,7 @@ static int unzlocal_GetCurrentFileInfoInternal(unzFile file,
 	if (file == nullptr)
 		return UNZ_PARAMERROR;
 	s = (unz_s *)file;
-	s->_stream->seek(s->pos_in_central_dir + s->byte_before_the_zipfile, SEEK_SET);
+	s->_stream->seek(s->pos_in_central_dir + s->byte_before_the_zipfile - s->stream_offset, SEEK_SET);
 	if (s->_stream->err())
 		err = UNZ_ERRNO;
 
@@ -983,7 +1119,7 @@ Common::SharedArchiveContents unzOpenCurrentFile (unzFile file
 		return Common::SharedArchiveContents();
 
 	if (s->cur_file_info.compression_method != 0 && s->cur_file_info.compression_method != Z_DEFLATED) {
-		warning("Unknown compression algoritthm %d", (int)s->cur_file_info.compression_method);
+		warning("Unknown compression algorithm %d", (int)s->cur_file_info.compression_method);
 		return Common::SharedArchiveContents();
 	}
 
@@ -1006,7 +1142,7 @@ Common::SharedArchiveContents unzOpenCurrentFile (unzFile file
 		compressedBuffer = nullptr;
 		break;
 	default:
-		warning("Unknown compression algoritthm %d", (int)s->cur_file_info.compression_method);
+		warning("Unknown compression algorithm %d", (int)s->cur_file_info.compression_method);
 		delete[] compressedBuffer;
 		return Common::SharedArchiveContents();
 	}
@@ -1024,11 +1160,53 @@ Common::SharedArchiveContents unzOpenCurrentFile (unzFile file
 	return Common::SharedArchiveContents(uncompressedBuffer, s->cur_file_info.uncompressed_size);
 }
 
+Common::SeekableReadStream *unzOpenCurrentFileStream(unzFile file) {
+	uInt iSizeVar;
+	unz_s *s;
+	uLong offset_local_extrafield;  /* offset of the local extra field */
+	uInt  size_local_extrafield;    /* size of the local extra field */
+
+	if (file == nullptr)
+		return nullptr;
+	s = (unz_s *)file;
+	if (!s->current_file_ok)
+		return nullptr;
+
+	if (unzlocal_CheckCurrentFileCoherencyHeader(s, &iSizeVar,
+				&offset_local_extrafield, &size_local_extrafield) != UNZ_OK)
+		return nullptr;
+
+	uLong begin = s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar;
+	uLong end = begin + s->cur_file_info.compressed_size;
+	Common::SeekableReadStream *stream = new ZipMemberReadStream(s->_shared, begin, end);
+
+	switch (s->cur_file_info.compression_method) {
+	case 0: // Store
+		break;
+	case Z_DEFLATED:
+		stream = Common::wrapDeflateReadStream(stream, DisposeAfterUse::YES, s->cur_file_info.uncompressed_size);
+		if (!stream)
+			return nullptr;
+		break;
+	default:
+		warning("Unknown compression algorithm %d", (int)s->cur_file_info.compression_method);
+		delete stream;
+		return nullptr;
+	}
+
+	return new ZipMemberCrcReadStream(stream, s->cur_file_info.crc);
+}
+
 
 namespace Common {
 
 
 class ZipArchive : public MemcachingCaseInsensitiveArchive {
+	// Members at least this large are decompressed on demand rather than
+	// up front, and are not kept in the contents cache. Deflated members are
+	// only streamed when seeking in them does not restart the decompression.
+	static const uint32 kLazyMemberSize = 1024 * 1024;
+
 	unzFile _zipFile;
 #ifndef USE_ZLIB
 	Common::CRC32 _crc;
@@ -1078,10 +1256,17 @@ ZipArchive::~ZipArchive() {
 }
 
 bool ZipArchive::hasFile(const Path &path) const {
+	// unzLocateFile() changes the current file of the shared archive state
+	const unz_s *const archive = (const unz_s *)_zipFile;
+	StackLock lock(archive->_shared->_mutex);
+
 	return (unzLocateFile(_zipFile, path, 2) == UNZ_OK);
 }
 
 bool ZipArchive::isPathDirectory(const Path &path) const {
+	const unz_s *const archive = (const unz_s *)_zipFile;
+	StackLock lock(archive->_shared->_mutex);
+
 	if (unzLocateFile(_zipFile, path, 2) != UNZ_OK)
 		return false;
 
@@ -1112,8 +1297,24 @@ const ArchiveMemberPtr ZipArchive::getMember(const Path &path) const {
 }
 
 Common::SharedArchiveContents ZipArchive::readContentsForPath(const Common::Path &path) const {
+	const unz_s *const archive = (const unz_s *)_zipFile;
+	StackLock lock(archive->_shared->_mutex);
+
 	if (unzLocateFile(_zipFile, path, 2) != UNZ_OK)
 		return Common::SharedArchiveContents();
+
+#ifdef UNZ_SEEKABLE_DEFLATE
+	const bool lazy = archive->cur_file_info.uncompressed_size >= kLazyMemberSize;
+#else
+	const bool lazy = archive->cur_file_info.uncompressed_size >= kLazyMemberSize && archive->cur_file_info.compression_method == 0;
+#endif
+	if (lazy) {
+		SeekableReadStream *stream = unzOpenCurrentFileStream(_zipFile);
+		if (!stream)
+			return Common::SharedArchiveContents();
+		return Common::SharedArchiveContents::bypass(stream);
+	}
+
 #ifndef USE_ZLIB
 	return unzOpenCurrentFile(_zipFile, _crc);
 #else
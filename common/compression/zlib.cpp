@@ -33,6 +33,7 @@
 
 #include "common/compression/deflate.h"
 
+#include "common/array.h"
 #include "common/ptr.h"
 #include "common/util.h"
 #include "common/stream.h"
@@ -89,6 +90,11 @@ bool inflateZlibHeaderless(byte *dst, uint *dstLen, const byte *src, uint srcLen
 static bool _shownBackwardSeekingWarning = false;
 #endif
 
+// inflateGetDictionary() is needed to record checkpoints
+#if ZLIB_VERNUM >= 0x1271
+#define ZLIB_HAS_CHECKPOINTS
+#endif
+
 /**
  * A simple wrapper class which can be used to wrap around an arbitrary
  * other SeekableReadStream and will then provide on-the-fly decompression support.
@@ -97,7 +103,21 @@ static bool _shownBackwardSeekingWarning = false;
 class GZipReadStream : public SeekableReadStream {
 protected:
 	enum {
-		BUFSIZE = 16384		// 1 << MAX_WBITS
+		BUFSIZE = 16384,		// 1 << MAX_WBITS
+		WINDOWSIZE = 32768,
+		CHECKPOINT_INTERVAL = 0x100000	// Minimal distance between two checkpoints
+	};
+
+	/**
+	 * The state needed to resume decompression at a deflate block boundary,
+	 * so that seeking does not need to decompress from the start again.
+	 */
+	struct Checkpoint {
+		uint32 offset;		///< The offset in the decompressed data
+		int64 inputPos;		///< The offset of the next whole byte in the wrapped stream
+		int bits;			///< The number of bits of the previous byte still to be read
+		uint windowSize;
+		byte window[WINDOWSIZE];	///< The data preceding offset
 	};
 
 	byte	_buf[BUFSIZE];
@@ -105,11 +125,14 @@ protected:
 	DisposablePtr<SeekableReadStream> _wrapped;
 	z_stream _stream;
 	int _zlibErr;
+	int _windowBits;
 	uint64 _parentPos;
 	uint32 _pos;
 	uint32 _origSize;
 	bool _eos;
 
+	Array<Checkpoint *> _checkpoints;	///< Sorted by offset
+
 public:
 
 	GZipReadStream(SeekableReadStream *w, DisposeAfterUse::Flag disposeParent, uint32 knownSize) : _wrapped(w, disposeParent), _stream() {
@@ -139,7 +162,8 @@ public:
 		// the compressed file. This feature was added in zlib 1.2.0.4,
 		// released 10 August 2003.
 		// Note: This is *crucial* for savegame compatibility, do *not* remove!
-		_zlibErr = inflateInit2(&_stream, MAX_WBITS + 32);
+		_windowBits = MAX_WBITS + 32;
+		_zlibErr = inflateInit2(&_stream, _windowBits);
 		if (_zlibErr != Z_OK)
 			return;
 
@@ -159,7 +183,8 @@ public:
 		_pos = 0;
 		_eos = false;
 
-		_zlibErr = inflateInit2(&_stream, -MAX_WBITS);
+		_windowBits = -MAX_WBITS;
+		_zlibErr = inflateInit2(&_stream, _windowBits);
 		if (_zlibErr != Z_OK)
 			return;
 
@@ -177,6 +202,9 @@ public:
 
 	~GZipReadStream() {
 		inflateEnd(&_stream);
+
+		for (uint i = 0; i < _checkpoints.size(); i++)
+			delete _checkpoints[i];
 	}
 
 	bool err() const override { return (_zlibErr != Z_OK) && (_zlibErr != Z_STREAM_END); }
@@ -196,7 +224,14 @@ public:
 				_stream.next_in = _buf;
 				_stream.avail_in = _wrapped->read(_buf, BUFSIZE);
 			}
+#ifdef ZLIB_HAS_CHECKPOINTS
+			// Stop at the end of each block, where a checkpoint can be recorded
+			_zlibErr = inflate(&_stream, Z_BLOCK);
+			if (_zlibErr == Z_OK && (_stream.data_type & 128) && !(_stream.data_type & 64))
+				saveCheckpoint(_pos + dataSize - _stream.avail_out);
+#else
 			_zlibErr = inflate(&_stream, Z_NO_FLUSH);
+#endif
 		}
 
 		// Update the position counter
@@ -236,10 +271,15 @@ public:
 
 		assert(newPos >= 0);
 
-		if ((uint32)newPos < _pos) {
-			// To search backward, we have to restart the whole decompression
-			// from the start of the file. A rather wasteful operation, best
-			// to avoid it. :/
+		// Resume from the last checkpoint before the new position, unless
+		// decompressing from the current position gets there sooner
+		const Checkpoint *checkpoint = findCheckpoint(newPos);
+		if (checkpoint && (checkpoint->offset > _pos || (uint32)newPos < _pos)) {
+			if (!restoreCheckpoint(*checkpoint))
+				return false; // FIXME: STREAM REWRITE
+		} else if ((uint32)newPos < _pos) {
+			// To search backward before the first checkpoint, we have to
+			// restart the whole decompression from the start of the file.
 
 #ifndef RELEASE_BUILD
 			if (!_shownBackwardSeekingWarning) {
@@ -253,7 +293,13 @@ public:
 
 			_pos = 0;
 			_wrapped->seek(_parentPos, SEEK_SET);
+#ifdef ZLIB_HAS_CHECKPOINTS
+			// A restored checkpoint switches to raw deflate, so use the
+			// initial window bits again
+			_zlibErr = inflateReset2(&_stream, _windowBits);
+#else
 			_zlibErr = inflateReset(&_stream);
+#endif
 			if (_zlibErr != Z_OK)
 				return false; // FIXME: STREAM REWRITE
 			_stream.next_in = _buf;
@@ -273,6 +319,65 @@ public:
 		_eos = false;
 		return true; // FIXME: STREAM REWRITE
 	}
+
+private:
+	void saveCheckpoint(uint32 offset) {
+#ifdef ZLIB_HAS_CHECKPOINTS
+		// Only the furthest point decompressed so far adds a new checkpoint
+		const uint32 nextOffset = _checkpoints.empty() ? (uint32)CHECKPOINT_INTERVAL : _checkpoints.back()->offset + CHECKPOINT_INTERVAL;
+		if (offset < nextOffset)
+			return;
+
+		Checkpoint *checkpoint = new Checkpoint();
+		checkpoint->offset = offset;
+		checkpoint->inputPos = _wrapped->pos() - _stream.avail_in;
+		checkpoint->bits = _stream.data_type & 7;
+		uInt windowSize = WINDOWSIZE;
+		if (inflateGetDictionary(&_stream, checkpoint->window, &windowSize) != Z_OK) {
+			delete checkpoint;
+			return;
+		}
+		checkpoint->windowSize = windowSize;
+		_checkpoints.push_back(checkpoint);
+#endif
+	}
+
+	const Checkpoint *findCheckpoint(uint32 offset) const {
+		uint lo = 0, hi = _checkpoints.size();
+		while (lo < hi) {
+			const uint mid = (lo + hi) / 2;
+			if (_checkpoints[mid]->offset <= offset)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		return lo ? _checkpoints[lo - 1] : nullptr;
+	}
+
+	bool restoreCheckpoint(const Checkpoint &checkpoint) {
+#ifdef ZLIB_HAS_CHECKPOINTS
+		// The checkpoint is inside the deflate data, past any header
+		_zlibErr = inflateReset2(&_stream, -MAX_WBITS);
+		if (_zlibErr == Z_OK && checkpoint.bits) {
+			// The remaining bits are the top ones of the previous byte
+			_wrapped->seek(checkpoint.inputPos - 1, SEEK_SET);
+			const byte lastByte = _wrapped->readByte();
+			_zlibErr = inflatePrime(&_stream, checkpoint.bits, lastByte >> (8 - checkpoint.bits));
+		}
+		if (_zlibErr == Z_OK)
+			_zlibErr = inflateSetDictionary(&_stream, const_cast<byte *>(checkpoint.window), checkpoint.windowSize);
+		if (_zlibErr != Z_OK)
+			return false;
+
+		_wrapped->seek(checkpoint.inputPos, SEEK_SET);
+		_stream.next_in = _buf;
+		_stream.avail_in = 0;
+		_pos = checkpoint.offset;
+		return true;
+#else
+		return false;
+#endif
+	}
 };
 
 /**
@@ -0,0 +1,663 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// The hash map in this file uses open addressing with the keys and values
+// stored inline, and a separate array of control bytes in the style of
+// Abseil's SwissTable. Each control byte holds 7 bits of the hash of the
+// entry in the matching slot, so a lookup can check a whole group of slots
+// for candidates before touching any key.
+
+#ifndef COMMON_FLATHASHMAP_H
+#define COMMON_FLATHASHMAP_H
+
+#include "common/hashmap.h"
+#include "common/intrinsics.h"
+#include "common/util.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FLATHASHMAP_USE_SSE2
+#endif
+
+namespace Common {
+
+/**
+ * @defgroup common_flathashmap Flat hash table (FlatHashMap)
+ * @ingroup common
+ *
+ * @brief API for operations on a flat hash table.
+ *
+ * @{
+ */
+
+/**
+ * FlatHashMap<Key,Val> is a drop-in replacement for HashMap<Key,Val> which
+ * stores its entries inline instead of in separately allocated nodes. This
+ * makes lookups considerably cheaper, at the cost of entries being moved
+ * around when the table grows.
+ *
+ * @note Unlike with HashMap, pointers and references to keys and values are
+ *       invalidated by any operation inserting a new key into the map. Only
+ *       use FlatHashMap where no such references are kept around.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+	struct Node {
+		Val _value;
+		const Key _key;
+		explicit Node(const Key &key) : _value(), _key(key) {}
+		explicit Node(Key &&key) : _value(), _key(Common::move(key)) {}
+		Node(const Node &node) : _value(node._value), _key(node._key) {}
+	};
+
+private:
+
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> HM_t;
+
+	enum {
+		FLATHASHMAP_GROUP_WIDTH = 16,
+		FLATHASHMAP_MIN_CAPACITY = 16,
+
+		// The quotient of the next two constants controls how much the
+		// internal storage may fill up, including erased entries, before
+		// it gets rehashed.
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 7,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 8
+	};
+
+	enum {
+		kCtrlEmpty = -128,
+		kCtrlDeleted = -2
+		// Full slots store the low 7 bits of their hash, 0 to 127
+	};
+
+	/**
+	 * A group of consecutive control bytes, which can be matched against
+	 * a value all at once.
+	 */
+	class Group {
+	public:
+#ifdef FLATHASHMAP_USE_SSE2
+		explicit Group(const int8 *ctrl) : _ctrl(_mm_loadu_si128((const __m128i *)ctrl)) {}
+
+		uint32 match(int8 h2) const {
+			return _mm_movemask_epi8(_mm_cmpeq_epi8(_ctrl, _mm_set1_epi8(h2)));
+		}
+
+		uint32 matchEmpty() const {
+			return match(kCtrlEmpty);
+		}
+
+		uint32 matchEmptyOrDeleted() const {
+			return _mm_movemask_epi8(_ctrl);
+		}
+
+	private:
+		__m128i _ctrl;
+#else
+		explicit Group(const int8 *ctrl) : _ctrl(ctrl) {}
+
+		uint32 match(int8 h2) const {
+			uint32 mask = 0;
+			for (int i = 0; i < FLATHASHMAP_GROUP_WIDTH; i++)
+				mask |= (uint32)(_ctrl[i] == h2) << i;
+			return mask;
+		}
+
+		uint32 matchEmpty() const {
+			return match(kCtrlEmpty);
+		}
+
+		uint32 matchEmptyOrDeleted() const {
+			uint32 mask = 0;
+			for (int i = 0; i < FLATHASHMAP_GROUP_WIDTH; i++)
+				mask |= (uint32)(_ctrl[i] < 0) << i;
+			return mask;
+		}
+
+	private:
+		const int8 *_ctrl;
+#endif
+	};
+
+	/** Default value, returned by the const getVal. */
+	Val _defaultVal;
+
+	int8 *_ctrl;		///< Control bytes, the first FLATHASHMAP_GROUP_WIDTH are repeated at the end
+	Node *_slots;		///< Storage for the entries, _mask + 1 of them
+	size_type _mask;	///< Capacity of the FlatHashMap minus one; must be a power of two minus one
+	size_type _size;
+	size_type _deleted;	///< Number of erased slots which are not empty yet
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	static const size_type NONE_FOUND = (size_type)-1;
+
+	static int countTrailingZeros(uint32 mask) {
+#if defined(__GNUC__)
+		return __builtin_ctz(mask);
+#else
+		int n = 0;
+		while (!(mask & 1)) {
+			mask >>= 1;
+			n++;
+		}
+		return n;
+#endif
+	}
+
+	uint32 hashOf(const Key &key) const {
+		// Scramble the hash so that both the low bits used for the control
+		// byte and the high bits used for the position are usable
+		uint32 hash = _hash(key);
+		hash ^= hash >> 16;
+		hash *= 0x85EBCA6B;
+		hash ^= hash >> 13;
+		hash *= 0xC2B2AE35;
+		hash ^= hash >> 16;
+		return hash;
+	}
+
+	void setCtrl(size_type idx, int8 value) {
+		_ctrl[idx] = value;
+		if (idx < FLATHASHMAP_GROUP_WIDTH)
+			_ctrl[_mask + 1 + idx] = value;
+	}
+
+	void allocStorage(size_type capacity) {
+		_mask = capacity - 1;
+		_ctrl = new int8[capacity + FLATHASHMAP_GROUP_WIDTH];
+		assert(_ctrl != nullptr);
+		memset(_ctrl, kCtrlEmpty, capacity + FLATHASHMAP_GROUP_WIDTH);
+		_slots = (Node *)malloc(capacity * sizeof(Node));
+		assert(_slots != nullptr);
+	}
+
+	void freeStorage() {
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (_ctrl[ctr] >= 0)
+				_slots[ctr].~Node();
+		}
+		delete[] _ctrl;
+		free(_slots);
+	}
+
+	void assign(const HM_t &map);
+	size_type lookup(const Key &key, uint32 hash) const;
+	size_type lookup(const Key &key) const { return lookup(key, hashOf(key)); }
+	size_type findInsertSlot(uint32 hash) const;
+	size_type lookupAndCreateIfMissing(const Key &key);
+	void rehash(size_type newCapacity);
+	void eraseSlot(size_type ctr);
+
+	template<class T> friend class IteratorImpl;
+
+	/**
+	 * Simple FlatHashMap iterator implementation.
+	 */
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+		template<class T> friend class IteratorImpl;
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+	protected:
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != nullptr);
+			assert(_idx <= _hashmap->_mask);
+			assert(_hashmap->_ctrl[_idx] >= 0);
+			return &_hashmap->_slots[_idx];
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(nullptr) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			do {
+				_idx++;
+			} while (_idx <= _hashmap->_mask && _hashmap->_ctrl[_idx] < 0);
+			if (_idx > _hashmap->_mask)
+				_idx = NONE_FOUND;
+
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap();
+	FlatHashMap(const HM_t &map);
+	~FlatHashMap();
+
+	HM_t &operator=(const HM_t &map) {
+		if (this == &map)
+			return *this;
+
+		// Remove the previous content and ...
+		freeStorage();
+		// ... copy the new stuff.
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const;
+
+	Val &operator[](const Key &key);
+	const Val &operator[](const Key &key) const;
+
+	Val &getOrCreateVal(const Key &key);
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+	const Val &getValOrDefault(const Key &key) const;
+	const Val &getValOrDefault(const Key &key, const Val &defaultVal) const;
+	bool tryGetVal(const Key &key, Val &out) const;
+	void setVal(const Key &key, const Val &val);
+
+	void clear(bool shrinkArray = 0);
+
+	void erase(iterator entry);
+	void erase(const Key &key);
+
+	size_type size() const { return _size; }
+
+	iterator	begin() {
+		// Find and return the first non-empty entry
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (_ctrl[ctr] >= 0)
+				return iterator(ctr, this);
+		}
+		return end();
+	}
+	iterator	end() {
+		return iterator(NONE_FOUND, this);
+	}
+
+	const_iterator	begin() const {
+		// Find and return the first non-empty entry
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (_ctrl[ctr] >= 0)
+				return const_iterator(ctr, this);
+		}
+		return end();
+	}
+	const_iterator	end() const {
+		return const_iterator(NONE_FOUND, this);
+	}
+
+	iterator	find(const Key &key) {
+		return iterator(lookup(key), this);
+	}
+
+	const_iterator	find(const Key &key) const {
+		return const_iterator(lookup(key), this);
+	}
+
+	/** Return true if hashmap is empty. */
+	bool empty() const {
+		return (_size == 0);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+/**
+ * Base constructor, creates an empty hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap() : _defaultVal() {
+	allocStorage(FLATHASHMAP_MIN_CAPACITY);
+	_size = 0;
+	_deleted = 0;
+}
+
+/**
+ * Copy constructor, creates a full copy of the given hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap(const HM_t &map) :
+	_defaultVal() {
+	assign(map);
+}
+
+/**
+ * Destructor, frees all used memory.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::~FlatHashMap() {
+	freeStorage();
+}
+
+/**
+ * Internal method for assigning the content of another FlatHashMap
+ * to this one.
+ *
+ * @note The previous storage here is *not* deallocated here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const HM_t &map) {
+	allocStorage(map._mask + 1);
+
+	// The layout does not depend on anything but the hashes, so the control
+	// bytes can be copied as they are.
+	memcpy(_ctrl, map._ctrl, _mask + 1 + FLATHASHMAP_GROUP_WIDTH);
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (_ctrl[ctr] >= 0)
+			new (&_slots[ctr]) Node(map._slots[ctr]);
+	}
+	_size = map._size;
+	_deleted = map._deleted;
+}
+
+/**
+ * Clear all values in the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	if (shrinkArray && _mask >= FLATHASHMAP_MIN_CAPACITY) {
+		freeStorage();
+		allocStorage(FLATHASHMAP_MIN_CAPACITY);
+	} else {
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (_ctrl[ctr] >= 0)
+				_slots[ctr].~Node();
+		}
+		memset(_ctrl, kCtrlEmpty, _mask + 1 + FLATHASHMAP_GROUP_WIDTH);
+	}
+
+	_size = 0;
+	_deleted = 0;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::rehash(size_type newCapacity) {
+	assert(newCapacity > _size);
+
+	const size_type old_mask = _mask;
+	int8 *old_ctrl = _ctrl;
+	Node *old_slots = _slots;
+
+	allocStorage(newCapacity);
+	_deleted = 0;
+
+	for (size_type ctr = 0; ctr <= old_mask; ++ctr) {
+		if (old_ctrl[ctr] < 0)
+			continue;
+
+		// Since we know that no key exists twice in the old table, we
+		// can simply take the first free slot without calling _equal().
+		const uint32 hash = hashOf(old_slots[ctr]._key);
+		const size_type idx = findInsertSlot(hash);
+		setCtrl(idx, hash & 0x7F);
+
+		// The old node is destroyed right away, so its key can be moved
+		// even though it is const
+		Node *node = new (&_slots[idx]) Node(Common::move(const_cast<Key &>(old_slots[ctr]._key)));
+		node->_value = Common::move(old_slots[ctr]._value);
+		old_slots[ctr].~Node();
+	}
+
+	delete[] old_ctrl;
+	free(old_slots);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key, uint32 hash) const {
+	const int8 h2 = hash & 0x7F;
+	size_type pos = (hash >> 7) & _mask;
+
+	// Probe groups at triangular offsets, which visits every group of a
+	// table whose capacity is a power of two. The loop ends because the
+	// load factor guarantees that there are empty slots left.
+	for (size_type step = FLATHASHMAP_GROUP_WIDTH; ; step += FLATHASHMAP_GROUP_WIDTH) {
+		const Group group(_ctrl + pos);
+		for (uint32 match = group.match(h2); match; match &= match - 1) {
+			const size_type ctr = (pos + countTrailingZeros(match)) & _mask;
+			if (_equal(_slots[ctr]._key, key))
+				return ctr;
+		}
+
+		if (group.matchEmpty())
+			return NONE_FOUND;
+
+		pos = (pos + step) & _mask;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::findInsertSlot(uint32 hash) const {
+	size_type pos = (hash >> 7) & _mask;
+
+	for (size_type step = FLATHASHMAP_GROUP_WIDTH; ; step += FLATHASHMAP_GROUP_WIDTH) {
+		const uint32 match = Group(_ctrl + pos).matchEmptyOrDeleted();
+		if (match)
+			return (pos + countTrailingZeros(match)) & _mask;
+
+		pos = (pos + step) & _mask;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	const uint32 hash = hashOf(key);
+	size_type ctr = lookup(key, hash);
+	if (ctr != NONE_FOUND)
+		return ctr;
+
+	// Keep the load factor below a certain threshold.
+	// Erased slots are also counted, as they make probing longer.
+	size_type capacity = _mask + 1;
+	if ((_size + _deleted + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR >
+	        capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR) {
+		// Only grow if the table is actually getting full, otherwise it is
+		// enough to get rid of the erased slots
+		if ((_size + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR * 2 >
+		        capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR)
+			capacity = capacity < 512 ? (capacity * 4) : (capacity * 2);
+		rehash(capacity);
+	}
+
+	ctr = findInsertSlot(hash);
+	if (_ctrl[ctr] == kCtrlDeleted)
+		_deleted--;
+	setCtrl(ctr, hash & 0x7F);
+	new (&_slots[ctr]) Node(key);
+	_size++;
+
+	return ctr;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::eraseSlot(size_type ctr) {
+	assert(ctr <= _mask);
+	assert(_ctrl[ctr] >= 0);
+
+	_slots[ctr].~Node();
+	_size--;
+
+	// If there was never a full group around this slot, no probe can have
+	// gone past it, so it can be marked as empty. Otherwise it has to stay
+	// a tombstone to keep the entries behind it reachable.
+	const uint32 emptyAfter = Group(_ctrl + ctr).matchEmpty();
+	const uint32 emptyBefore = Group(_ctrl + ((ctr - FLATHASHMAP_GROUP_WIDTH) & _mask)).matchEmpty();
+	if (emptyBefore && emptyAfter &&
+	        countTrailingZeros(emptyAfter) + (FLATHASHMAP_GROUP_WIDTH - 1 - intLog2(emptyBefore)) < FLATHASHMAP_GROUP_WIDTH) {
+		setCtrl(ctr, kCtrlEmpty);
+	} else {
+		setCtrl(ctr, kCtrlDeleted);
+		_deleted++;
+	}
+}
+
+/**
+ * Check whether the hashmap contains the given key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::contains(const Key &key) const {
+	return lookup(key) != NONE_FOUND;
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) {
+	return getOrCreateVal(key);
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) const {
+	return getVal(key);
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getOrCreateVal(const Key &key) {
+	size_type ctr = lookupAndCreateIfMissing(key);
+	return _slots[ctr]._value;
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != NONE_FOUND)
+		return _slots[ctr]._value;
+	else
+		// See comment in HashMap::getVal().
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) const {
+	size_type ctr = lookup(key);
+	if (ctr != NONE_FOUND)
+		return _slots[ctr]._value;
+	else
+		// See comment in HashMap::getVal().
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key) const {
+	return getValOrDefault(key, _defaultVal);
+}
+
+/**
+ * Get a value from the hashmap. If the key is not present, then return @p defaultVal.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key, const Val &defaultVal) const {
+	size_type ctr = lookup(key);
+	if (ctr != NONE_FOUND)
+		return _slots[ctr]._value;
+	else
+		return defaultVal;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::tryGetVal(const Key &key, Val &out) const {
+	size_type ctr = lookup(key);
+	if (ctr != NONE_FOUND) {
+		out = _slots[ctr]._value;
+		return true;
+	} else {
+		return false;
+	}
+}
+
+/**
+ * Assign an element specified by @p key to a value @p val.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::setVal(const Key &key, const Val &val) {
+	size_type ctr = lookupAndCreateIfMissing(key);
+	_slots[ctr]._value = val;
+}
+
+/**
+ * Erase an element referred to by an iterator.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(iterator entry) {
+	// Check whether we have a valid iterator
+	assert(entry._hashmap == this);
+	eraseSlot(entry._idx);
+}
+
+/**
+ * Erase an element specified by a key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != NONE_FOUND)
+		eraseSlot(ctr);
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
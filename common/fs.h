@@ -24,6 +24,7 @@
 
 #include "common/array.h"
 #include "common/archive.h"
+#include "common/flathashmap.h"
 #include "common/hash-str.h"
 #include "common/hashmap.h"
 #include "common/ptr.h"
@@ -252,6 +253,18 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Retrieve the size and the last modification time of the file referred
+	 * by this node, without opening it. Not all backends support this.
+	 *
+	 * @param size              The size of the file in bytes.
+	 * @param modificationTime  The modification time, in seconds since an
+	 *                          unspecified epoch.
+	 *
+	 * @return True if the information could be retrieved, false otherwise.
+	 */
+	bool getFileInfo(uint64 &size, int64 &modificationTime) const;
+
 	/**
 	 * Create a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -261,6 +274,16 @@ public:
 	 */
 	SeekableReadStream *createReadStream() const override;
 
+	/**
+	 * Create a SeekableReadStream instance corresponding to the file
+	 * referred by this node, which the backend may map into memory. Only
+	 * use this for files which are not modified while the stream is open,
+	 * like game data, and never for saved games.
+	 *
+	 * @return Pointer to the stream object, nullptr in case of a failure.
+	 */
+	SeekableReadStream *createMappedReadStream() const;
+
 	/**
 	 * Create a SeekableReadStream instance corresponding to an alternate stream
 	 * of the file referred by this node. This assumes that the node actually
@@ -350,7 +373,7 @@ class FSDirectory : public Archive {
 
 	// Caches are case insensitive, clashes are dealt with when creating
 	// Key is stored in lowercase.
-	typedef HashMap<Path, FSNode, Path::IgnoreCaseAndMac_Hash, Path::IgnoreCaseAndMac_EqualTo> NodeCache;
+	typedef FlatHashMap<Path, FSNode, Path::IgnoreCaseAndMac_Hash, Path::IgnoreCaseAndMac_EqualTo> NodeCache;
 	typedef HashMap<Path, Array<String>, Path::IgnoreCaseAndMac_Hash, Path::IgnoreCaseAndMac_EqualTo> NodeMapCache;
 	mutable NodeCache	_fileCache, _subDirCache;
 	mutable NodeMapCache	_fileMapCache, _dirMapCache;
@@ -0,0 +1,77 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/jobsystem.h"
+#include "common/util.h"
+
+namespace Common {
+
+namespace {
+
+struct ParallelForBatch {
+	JobSystem::JobProc proc;
+	void *refCon;
+	uint count;
+	uint grainSize;
+};
+
+void runParallelForBatch(void *refCon, uint batch) {
+	const ParallelForBatch *b = (const ParallelForBatch *)refCon;
+	const uint end = MIN(b->count, (batch + 1) * b->grainSize);
+	for (uint i = batch * b->grainSize; i < end; i++) {
+		b->proc(b->refCon, i);
+	}
+}
+
+} // End of anonymous namespace
+
+void JobSystem::parallelFor(uint count, JobProc proc, void *refCon, uint grainSize) {
+	if (count == 0)
+		return;
+
+	const uint concurrency = getConcurrency();
+
+	// A few batches per thread keep all threads busy when indices do not cost the same.
+	if (grainSize == 0)
+		grainSize = MAX<uint>(1, count / (concurrency * 4));
+
+	if (concurrency == 1 || count <= grainSize) {
+		for (uint i = 0; i < count; i++) {
+			proc(refCon, i);
+		}
+		return;
+	}
+
+	ParallelForBatch batch;
+	batch.proc = proc;
+	batch.refCon = refCon;
+	batch.count = count;
+	batch.grainSize = grainSize;
+
+	JobGroup group;
+	const uint batchCount = (count + grainSize - 1) / grainSize;
+	for (uint i = 0; i < batchCount; i++) {
+		submit(group, runParallelForBatch, &batch, i);
+	}
+	wait(group);
+}
+
+} // End of namespace Common
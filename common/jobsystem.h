@@ -0,0 +1,143 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_JOBSYSTEM_H
+#define COMMON_JOBSYSTEM_H
+
+#include "common/scummsys.h"
+#include "common/noncopyable.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_jobsystem Job system
+ * @ingroup common
+ *
+ * @brief API for spreading work over several threads.
+ *
+ * The OSystem API does not expose threads. Backends able to run worker
+ * threads provide a JobSystem subclass, while this base class runs every
+ * job immediately on the calling thread. Code using the job system hence
+ * behaves the same on every port and only runs faster where threads exist.
+ *
+ * Jobs may run concurrently with each other, so they must only touch data
+ * which is not shared with other jobs of the same batch, and must not call
+ * into the OSystem graphics, events or mixer APIs.
+ *
+ * @{
+ */
+
+class JobSystem : NonCopyable {
+public:
+	typedef void (*JobProc)(void *refCon, uint index); /*!< Type definition of a job. */
+
+	/**
+	 * Set of submitted jobs which can be waited for as a whole,
+	 * acting as the future of all the jobs submitted with it.
+	 *
+	 * A group must be waited for before it goes out of scope.
+	 */
+	class JobGroup : NonCopyable {
+		friend class JobSystem;
+	public:
+		JobGroup() : _pending(0) {}
+
+	private:
+		/** Number of submitted jobs of this group which have not finished yet. */
+		uint _pending;
+	};
+
+	virtual ~JobSystem() {}
+
+	/**
+	 * Return the number of worker threads, not counting the thread submitting the jobs.
+	 *
+	 * This is 0 when jobs are run serially.
+	 */
+	virtual uint getWorkerCount() const { return 0; }
+
+	/**
+	 * Return how many jobs can run at the same time, including the submitting thread.
+	 */
+	uint getConcurrency() const { return getWorkerCount() + 1; }
+
+	/**
+	 * Submit a job to the pool.
+	 *
+	 * The job may start immediately and run on any thread, including the
+	 * calling one. The serial implementation runs it before returning.
+	 *
+	 * @param group   Group the job is accounted in.
+	 * @param proc    Job callback.
+	 * @param refCon  Arbitrary void pointer passed to the callback.
+	 * @param index   Arbitrary index passed to the callback.
+	 */
+	virtual void submit(JobGroup &group, JobProc proc, void *refCon, uint index = 0) {
+		proc(refCon, index);
+	}
+
+	/**
+	 * Wait until all jobs of the group have finished.
+	 *
+	 * While waiting, the calling thread helps running the queued jobs of
+	 * this group, but never jobs of other groups.
+	 */
+	virtual void wait(JobGroup &group) {}
+
+	/**
+	 * Call @p proc for every index in [0, count) and wait for all calls to finish.
+	 *
+	 * Indices are handed out in batches of @p grainSize consecutive indices.
+	 * A grain size of 0 picks one based on the number of threads.
+	 */
+	void parallelFor(uint count, JobProc proc, void *refCon, uint grainSize = 0);
+
+	/**
+	 * Call the functor @p func with every index in [0, count) and wait for all
+	 * calls to finish. This is typically used with a lambda.
+	 */
+	template<class T>
+	void parallelFor(uint count, const T &func, uint grainSize = 0) {
+		parallelFor(count, &callFunctor<T>, const_cast<T *>(&func), grainSize);
+	}
+
+protected:
+	/** Account a job as pending in its group, called by subclasses with their lock held. */
+	static void addPending(JobGroup &group) { group._pending++; }
+
+	/** Account a job as done in its group, returns true when it was the last one. */
+	static bool removePending(JobGroup &group) { return --group._pending == 0; }
+
+	/** Whether all jobs of the group are done. */
+	static bool isDone(const JobGroup &group) { return group._pending == 0; }
+
+private:
+	template<class T>
+	static void callFunctor(void *refCon, uint index) {
+		(*(const T *)refCon)(index);
+	}
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
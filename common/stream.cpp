@@ -158,6 +158,17 @@ bool MemoryReadStream::seek(int64 offs, int whence) {
 	return true; // FIXME: STREAM REWRITE
 }
 
+const byte *MemoryReadStream::tryGetContiguousView(uint32 size) {
+	if (size > _size - _pos)
+		return nullptr;
+
+	const byte *view = _ptr;
+	_ptr += size;
+	_pos += size;
+
+	return view;
+}
+
 #pragma mark -
 
 enum {
@@ -292,6 +303,17 @@ bool SeekableSubReadStream::seek(int64 offset, int whence) {
 	return ret;
 }
 
+const byte *SeekableSubReadStream::tryGetContiguousView(uint32 size) {
+	if (size > _end - _pos)
+		return nullptr;
+
+	const byte *view = _parentStream->tryGetContiguousView(size);
+	if (view)
+		_pos += size;
+
+	return view;
+}
+
 uint32 SafeSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	// Make sure the parent stream is at the right position
 	seek(0, SEEK_CUR);
@@ -299,6 +321,13 @@ uint32 SafeSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	return SeekableSubReadStream::read(dataPtr, dataSize);
 }
 
+const byte *SafeSeekableSubReadStream::tryGetContiguousView(uint32 size) {
+	// Make sure the parent stream is at the right position
+	seek(0, SEEK_CUR);
+
+	return SeekableSubReadStream::tryGetContiguousView(size);
+}
+
 void SeekableReadStream::hexdump(int len, int bytesPerLine, int startOffset) {
 	uint pos_ = pos();
 	uint size_ = size();
@@ -611,4 +640,9 @@ uint32 SafeMutexedSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	return Common::SafeSeekableSubReadStream::read(dataPtr, dataSize);
 }
 
+const byte *SafeMutexedSeekableSubReadStream::tryGetContiguousView(uint32 size) {
+	Common::StackLock lock(_mutex);
+	return Common::SafeSeekableSubReadStream::tryGetContiguousView(size);
+}
+
 } // End of namespace Common
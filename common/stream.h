@@ -792,6 +792,26 @@ public:
 	 */
 	virtual bool skip(uint32 offset) { return seek(offset, SEEK_CUR); }
 
+	/**
+	 * Try to access the next @p size bytes of the stream in place.
+	 *
+	 * Streams whose data already lives in memory can return a pointer into
+	 * their buffer, which lets callers parse the data without copying it
+	 * into a temporary buffer first. On success, the stream position
+	 * indicator is advanced by @p size bytes, exactly as if read() had been
+	 * called. The returned data must not be modified and stays valid until
+	 * the stream is destroyed.
+	 *
+	 * Callers must be prepared for this to fail and fall back to read().
+	 *
+	 * @param size	Number of bytes to access.
+	 *
+	 * @return Pointer to the data, or nullptr if the stream cannot provide
+	 *         a view or fewer than @p size bytes remain. In that case, the
+	 *         stream position indicator is left unchanged.
+	 */
+	virtual const byte *tryGetContiguousView(uint32 size) { return nullptr; }
+
 	/**
 	 * Read at most one less than the number of characters specified
 	 * by @p bufSize from the stream and store them in the string buffer.
@@ -982,6 +1002,7 @@ public:
 	int64 pos() const override { return _parentStream->pos(); }
 	int64 size() const override { return _parentStream->size(); }
 	bool seek(int64 offset, int whence = SEEK_SET) override { return _parentStream->seek(offset, whence); }
+	const byte *tryGetContiguousView(uint32 size) override { return _parentStream->tryGetContiguousView(size); }
 };
 
 /** @} */
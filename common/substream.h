@@ -86,6 +86,8 @@ public:
 	virtual int64 size() const { return _end - _begin; }
 
 	virtual bool seek(int64 offset, int whence = SEEK_SET);
+
+	virtual const byte *tryGetContiguousView(uint32 size);
 };
 
 /**
@@ -108,6 +110,7 @@ public:
 	}
 
 	virtual uint32 read(void *dataPtr, uint32 dataSize);
+	virtual const byte *tryGetContiguousView(uint32 size);
 };
 
 /**
@@ -124,6 +127,7 @@ public:
 		: SafeSeekableSubReadStream(parentStream, begin, end, disposeParentStream), _mutex(mutex) {
 	}
 	uint32 read(void *dataPtr, uint32 dataSize) override;
+	const byte *tryGetContiguousView(uint32 size) override;
 protected:
 	Common::Mutex &_mutex;
 };
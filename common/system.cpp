@@ -25,6 +25,7 @@
 #include "common/events.h"
 #include "common/fs.h"
 #include "common/file.h"
+#include "common/jobsystem.h"
 #include "common/savefile.h"
 #include "common/str.h"
 #include "common/taskbar.h"
@@ -56,6 +57,7 @@ OSystem::OSystem() {
 #if defined(USE_SYSDIALOGS)
 	_dialogManager = nullptr;
 #endif
+	_jobSystem = nullptr;
 	_fsFactory = nullptr;
 	_dlcStore = nullptr;
 	_backendInitialized = false;
@@ -92,6 +94,9 @@ OSystem::~OSystem() {
 	delete _savefileManager;
 	_savefileManager = nullptr;
 
+	delete _jobSystem;
+	_jobSystem = nullptr;
+
 	delete _fsFactory;
 	_fsFactory = nullptr;
 
@@ -262,3 +267,9 @@ Common::TimerManager *OSystem::getTimerManager() {
 Common::SaveFileManager *OSystem::getSavefileManager() {
 	return _savefileManager;
 }
+
+Common::JobSystem *OSystem::getJobSystem() {
+	if (!_jobSystem)
+		_jobSystem = new Common::JobSystem();
+	return _jobSystem;
+}
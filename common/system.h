@@ -54,6 +54,7 @@ class Store;
 
 namespace Common {
 class EventManager;
+class JobSystem;
 class MutexInternal;
 struct Rect;
 class SaveFileManager;
@@ -251,6 +252,15 @@ protected:
 	Common::DialogManager *_dialogManager;
 #endif
 
+	/**
+	 * No default value is provided for _jobSystem by OSystem.
+	 * However, getJobSystem() creates a serial one on first use if
+	 * none has been set before.
+	 *
+	 * @note _jobSystem is deleted by the OSystem destructor.
+	 */
+	Common::JobSystem *_jobSystem;
+
 	/**
 	 * No default value is provided for _fsFactory by OSystem.
 	 *
@@ -1772,6 +1782,16 @@ public:
 	}
 #endif
 
+	/**
+	 * Return the JobSystem, used to spread work over several threads.
+	 *
+	 * Backends without threads get a job system running every job on the
+	 * calling thread.
+	 *
+	 * For more information, see @ref Common::JobSystem.
+	 */
+	virtual Common::JobSystem *getJobSystem();
+
 	/**
 	 * Return the DLC Store, used to implement DLC manager functions.
 	 *
@@ -21,12 +21,14 @@
 
 #define FORBIDDEN_SYMBOL_EXCEPTION_printf
 
+#include "common/algorithm.h"
 #include "common/debug.h"
 #include "common/util.h"
 #include "common/file.h"
 #include "common/macresman.h"
 #include "common/md5.h"
 #include "common/config-manager.h"
+#include "common/jobsystem.h"
 #include "common/punycode.h"
 #include "common/system.h"
 #include "common/textconsole.h"
@@ -407,6 +409,7 @@ Common::Error AdvancedMetaEngineDetectionBase::identifyGame(DetectedGame &game,
 
 	// Detection is done, no need to keep archives in memory anymore
 	ADCacheMan.clearArchives();
+	ADCacheMan.savePersistentCache();
 
 	if (!agdDesc.desc)
 		return Common::kNoGameDataFoundError;
@@ -532,6 +535,11 @@ Common::String md5PropToGameFile(MD5Properties flags) {
 
 static bool getFilePropertiesIntern(uint md5Bytes, const AdvancedMetaEngineBase::FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps);
 
+static Common::String makeFilePropertiesKey(MD5Properties md5prop, const Common::FSNode &node, const Common::String &fname, uint md5Bytes) {
+	return Common::String::format("%s:%s:%s:%d", md5PropToCachePrefix(md5prop).c_str(),
+		node.getPath().toString('/').c_str(), fname.c_str(), md5Bytes);
+}
+
 bool AdvancedMetaEngineDetectionBase::getFileProperties(const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const {
 	Common::String hashname = md5PropToCachePrefix(md5prop);
 		hashname += ':';
@@ -545,11 +553,43 @@ bool AdvancedMetaEngineDetectionBase::getFileProperties(const FileMap &allFiles,
 		return true;
 	}
 
+	// Mac forks are resolved through MacResManager, which may pick any of
+	// several files, so only plain files and archive members are cached
+	// persistently. They are keyed by the full path of the file on disk.
+	Common::String persistentKey;
+	const Common::FSNode *persistentNode = nullptr;
+
+	if (!(md5prop & (kMD5MacResFork | kMD5MacDataFork))) {
+		Common::Path diskName = fname;
+
+		if (md5prop & kMD5Archive) {
+			Common::StringTokenizer tok(fname.toString(), ":");
+			tok.nextToken();
+			diskName = Common::Path(tok.nextToken());
+		}
+
+		if (allFiles.contains(diskName)) {
+			persistentNode = &allFiles[diskName];
+			persistentKey = makeFilePropertiesKey(md5prop, *persistentNode, fname.toString('/'), _md5Bytes);
+
+			if (ADCacheMan.getPrefetchedFileProperties(persistentKey, fileProps) ||
+					ADCacheMan.getPersistentFileProperties(persistentKey, *persistentNode, fileProps)) {
+				fileProps.md5prop = (MD5Properties)(md5prop & kMD5Tail);
+				ADCacheMan.setMD5(hashname, fileProps.md5);
+				ADCacheMan.setSize(hashname, fileProps.size);
+				return true;
+			}
+		}
+	}
+
 	bool res = getFilePropertiesIntern(_md5Bytes, allFiles, md5prop, fname, fileProps);
 
 	if (res) {
 		ADCacheMan.setMD5(hashname, fileProps.md5);
 		ADCacheMan.setSize(hashname, fileProps.size);
+
+		if (persistentNode)
+			ADCacheMan.setPersistentFileProperties(persistentKey, *persistentNode, fileProps);
 	}
 
 	return res;
@@ -668,6 +708,196 @@ static bool getFilePropertiesIntern(uint md5Bytes, const AdvancedMetaEngineBase:
 	return true;
 }
 
+namespace {
+
+const char *const kPersistentCacheFileName = "detection-md5.cache";
+
+// Minimum delay in milliseconds between two non-forced writes
+const uint32 kPersistentCacheSaveInterval = 10000;
+
+Common::FSNode getPersistentCacheNode() {
+	Common::Path configFile = ConfMan.getCustomConfigFileName();
+	if (configFile.empty())
+		configFile = g_system->getDefaultConfigFileName();
+
+	return Common::FSNode(configFile).getParent().getChild(kPersistentCacheFileName);
+}
+
+} // End of anonymous namespace
+
+void AdvancedDetectorCacheManager::loadPersistentCache() {
+	persistentLoaded = true;
+
+	Common::FSNode node = getPersistentCacheNode();
+	if (!node.exists())
+		return;
+
+	Common::ScopedPtr<Common::SeekableReadStream> stream(node.createReadStream());
+	if (!stream)
+		return;
+
+	persistentCache.load(*stream);
+	debugC(2, kDebugGlobalDetection, "Loaded %u entries from the persistent MD5 cache", persistentCache.size());
+}
+
+bool AdvancedDetectorCacheManager::getPersistentFileProperties(const Common::String &key, const Common::FSNode &node, FileProperties &fileProps) {
+	if (!persistentLoaded)
+		loadPersistentCache();
+
+	uint64 fileSize;
+	int64 modificationTime;
+	if (!node.getFileInfo(fileSize, modificationTime))
+		return false;
+
+	const PersistentMD5Cache::Entry *entry = persistentCache.use(key, fileSize, modificationTime);
+	if (!entry)
+		return false;
+
+	fileProps.md5 = entry->md5;
+	fileProps.size = entry->size;
+	return true;
+}
+
+void AdvancedDetectorCacheManager::setPersistentFileProperties(const Common::String &key, const Common::FSNode &node, const FileProperties &fileProps) {
+	uint64 fileSize;
+	int64 modificationTime;
+	if (!node.getFileInfo(fileSize, modificationTime))
+		return;
+
+	if (!persistentLoaded)
+		loadPersistentCache();
+
+	persistentCache.store(key, fileSize, modificationTime, fileProps.size, fileProps.md5);
+}
+
+void AdvancedDetectorCacheManager::savePersistentCache(bool force) {
+	if (!persistentCache.isDirty())
+		return;
+
+	uint32 now = g_system->getMillis();
+	if (!force && persistentLastSave != 0 && now - persistentLastSave < kPersistentCacheSaveInterval)
+		return;
+
+	persistentLastSave = now;
+
+	// Write atomically, so that an interrupted write never leaves a
+	// truncated cache behind
+	Common::FSNode node = getPersistentCacheNode();
+	Common::ScopedPtr<Common::WriteStream> stream(node.createWriteStream(true));
+	if (!stream) {
+		debugC(2, kDebugGlobalDetection, "Could not write the persistent MD5 cache to '%s'", node.getPath().toString(Common::Path::kNativeSeparator).c_str());
+		return;
+	}
+
+	persistentCache.save(*stream);
+	stream->finalize();
+}
+
+void AdvancedDetectorCacheManager::addPrefetchFile(const Common::String &fname, MD5Properties md5prop, uint md5Bytes) {
+	Common::Array<PrefetchFile> &files = prefetchFileMap.getOrCreateVal(fname);
+	for (const PrefetchFile &file : files) {
+		if (file.fname == fname && file.md5prop == md5prop && file.md5Bytes == md5Bytes)
+			return;
+	}
+
+	PrefetchFile file;
+	file.fname = fname;
+	file.md5prop = md5prop;
+	file.md5Bytes = md5Bytes;
+	files.push_back(file);
+}
+
+void AdvancedDetectorCacheManager::prefetchFileProperties(const Common::Array<Common::FSList> &lists) {
+	// Without worker threads, hashing in advance would not overlap
+	// anything and could only hash files no detector ends up needing.
+	Common::JobSystem *jobSystem = g_system->getJobSystem();
+	if (jobSystem->getWorkerCount() == 0 || prefetchFileMap.empty())
+		return;
+
+	if (!persistentLoaded)
+		loadPersistentCache();
+
+	struct PrefetchJob {
+		Common::FSNode node;
+		Common::String key;
+		MD5Properties md5prop;
+		uint md5Bytes;
+		FileProperties fileProps;
+		uint64 fileSize;
+		int64 modificationTime;
+		bool found;
+		bool hashed;
+		bool hasFileInfo;
+	};
+
+	Common::Array<PrefetchJob> jobs;
+	for (const Common::FSList &files : lists) {
+		for (const Common::FSNode &node : files) {
+			if (node.isDirectory())
+				continue;
+
+			PrefetchFileMap::const_iterator it = prefetchFileMap.find(node.getName());
+			if (it == prefetchFileMap.end())
+				continue;
+
+			for (const PrefetchFile &file : it->_value) {
+				PrefetchJob job;
+				job.key = makeFilePropertiesKey(file.md5prop, node, file.fname, file.md5Bytes);
+				if (prefetchHashMap.contains(job.key))
+					continue;
+
+				job.node = node;
+				job.md5prop = file.md5prop;
+				job.md5Bytes = file.md5Bytes;
+				job.found = job.hashed = job.hasFileInfo = false;
+				jobs.push_back(job);
+			}
+		}
+	}
+
+	// The persistent cache is only read while the jobs run
+	jobSystem->parallelFor(jobs.size(), [this, &jobs](uint i) {
+		PrefetchJob &job = jobs[i];
+
+		job.hasFileInfo = job.node.getFileInfo(job.fileSize, job.modificationTime);
+		if (job.hasFileInfo) {
+			const PersistentMD5Cache::Entry *entry = persistentCache.find(job.key, job.fileSize, job.modificationTime);
+			if (entry) {
+				job.fileProps.md5 = entry->md5;
+				job.fileProps.size = entry->size;
+				job.found = true;
+				return;
+			}
+		}
+
+		Common::ScopedPtr<Common::SeekableReadStream> stream(job.node.createReadStream());
+		if (!stream)
+			return;
+
+		if ((job.md5prop & kMD5Tail) && stream->size() > job.md5Bytes)
+			stream->seek(-(int64)job.md5Bytes, SEEK_END);
+
+		job.fileProps.size = stream->size();
+		job.fileProps.md5 = Common::computeStreamMD5AsString(*stream, job.md5Bytes);
+		job.found = job.hashed = true;
+	}, 1);
+
+	for (PrefetchJob &job : jobs) {
+		if (!job.found)
+			continue;
+
+		job.fileProps.md5prop = (MD5Properties)(job.md5prop & kMD5Tail);
+		prefetchHashMap.setVal(job.key, job.fileProps);
+
+		if (job.hashed && job.hasFileInfo)
+			persistentCache.store(job.key, job.fileSize, job.modificationTime, job.fileProps.size, job.fileProps.md5);
+		else if (!job.hashed)
+			persistentCache.use(job.key, job.fileSize, job.modificationTime);
+	}
+
+	debugC(2, kDebugGlobalDetection, "Prefetched the properties of %u files", jobs.size());
+}
+
 void AdvancedMetaEngineDetectionBase::dumpDetectionEntries() const {
 	const byte *descPtr;
 
@@ -703,6 +933,23 @@ void AdvancedMetaEngineDetectionBase::dumpDetectionEntries() const {
 	}
 }
 
+void AdvancedMetaEngineDetectionBase::probeIndexedFile(const FileMap &allFiles, uint id, CachedPropertiesMap &filesProps, Common::Array<uint> &candidates) {
+	const IndexedFile &file = _indexedFiles[id];
+	if (filesProps.contains(file.key))
+		return;
+
+	FileProperties tmp;
+	if (getFileProperties(allFiles, file.md5prop, file.fileName, tmp)) {
+		debugC(3, kDebugGlobalDetection, "> '%s': '%s' %ld", file.key.c_str(), tmp.md5.c_str(), long(tmp.size));
+	}
+
+	// Both positive and negative results are cached to avoid
+	// repeatedly checking for files.
+	filesProps[file.key] = tmp;
+
+	candidates.push_back(file.descriptions);
+}
+
 ADDetectedGames AdvancedMetaEngineDetectionBase::detectGame(const Common::FSNode &parent, const FileMap &allFiles, Common::Language language, Common::Platform platform, const Common::String &extra, uint32 skipADFlags, bool skipIncomplete) {
 	CachedPropertiesMap filesProps;
 	ADDetectedGames matched;
@@ -717,36 +964,36 @@ ADDetectedGames AdvancedMetaEngineDetectionBase::detectGame(const Common::FSNode
 
 	// Check which files are included in some ADGameDescription *and* whether
 	// they are present. Compute MD5s and file sizes for the available files.
-	for (descPtr = _gameDescriptors; ((const ADGameDescription *)descPtr)->gameId != nullptr; descPtr += _descItemSize) {
-		g = (const ADGameDescription *)descPtr;
+	// Files missing from allFiles are never looked at, as they can only fail.
+	// The entries whose first file is probed are the only ones which may match.
+	Common::Array<uint> candidates(_filelessDescriptions);
 
-		for (fileDesc = g->filesDescriptions; fileDesc->fileName; fileDesc++) {
-			MD5Properties md5prop = gameFileToMD5Props(fileDesc, g->flags);
-			Common::String fname = fileDesc->fileName;
-			Common::String key = md5PropToCachePrefix(md5prop);
-				key += ':';
-				key += fname;
+	for (FileMap::const_iterator it = allFiles.begin(); it != allFiles.end(); ++it) {
+		FileIndex::const_iterator indexed = _fileIndex.find(it->_key);
+		if (indexed == _fileIndex.end())
+			continue;
 
-			if (filesProps.contains(key))
-				continue;
+		for (uint id : indexed->_value)
+			probeIndexedFile(allFiles, id, filesProps, candidates);
+	}
 
-			FileProperties tmp;
-			if (getFileProperties(allFiles, md5prop, Common::Path(fname), tmp)) {
-				debugC(3, kDebugGlobalDetection, "> '%s': '%s' %ld", key.c_str(), tmp.md5.c_str(), long(tmp.size));
-			}
+	for (uint id : _unindexedFiles)
+		probeIndexedFile(allFiles, id, filesProps, candidates);
 
-			// Both positive and negative results are cached to avoid
-			// repeatedly checking for files.
-			filesProps[key] = tmp;
-		}
-	}
+	// Keep the order of the tables, which decides between equal matches
+	Common::sort(candidates.begin(), candidates.end());
 
 	int maxFilesMatched = 0;
 	bool gotAnyMatchesWithAllFiles = false;
 
 	// MD5 based matching
 	uint i;
-	for (i = 0, descPtr = _gameDescriptors; ((const ADGameDescription *)descPtr)->gameId != nullptr; descPtr += _descItemSize, ++i) {
+	for (uint c = 0; c < candidates.size(); c++) {
+		if (c > 0 && candidates[c] == candidates[c - 1])
+			continue;
+
+		i = candidates[c];
+		descPtr = _gameDescriptors + i * _descItemSize;
 		g = (const ADGameDescription *)descPtr;
 
 		// Do not even bother to look at entries which do not have matching
@@ -1021,12 +1268,70 @@ void AdvancedMetaEngineDetectionBase::preprocessDescriptions() {
 		}
 	}
 
+	buildFileIndex();
+
 #ifndef RELEASE_BUILD
 	// Check the provided tables for sanity
 	detectClashes();
 #endif
 }
 
+void AdvancedMetaEngineDetectionBase::buildFileIndex() {
+	Common::HashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> fileIds;
+
+	uint i = 0;
+	for (const byte *descPtr = _gameDescriptors; ((const ADGameDescription *)descPtr)->gameId != nullptr; descPtr += _descItemSize, i++) {
+		const ADGameDescription *g = (const ADGameDescription *)descPtr;
+
+		if (!g->filesDescriptions[0].fileName) {
+			_filelessDescriptions.push_back(i);
+			continue;
+		}
+
+		for (const ADGameFileDescription *fileDesc = g->filesDescriptions; fileDesc->fileName; fileDesc++) {
+			MD5Properties md5prop = gameFileToMD5Props(fileDesc, g->flags);
+			Common::String key = md5PropToCachePrefix(md5prop);
+				key += ':';
+				key += fileDesc->fileName;
+
+			uint id;
+			if (!fileIds.tryGetVal(key, id)) {
+				id = _indexedFiles.size();
+				fileIds.setVal(key, id);
+
+				IndexedFile file;
+				file.key = key;
+				file.fileName = Common::Path(fileDesc->fileName);
+				file.md5prop = md5prop;
+				_indexedFiles.push_back(file);
+
+				if (md5prop & (kMD5MacResFork | kMD5MacDataFork)) {
+					// MacResManager looks for forks under several names
+					_unindexedFiles.push_back(id);
+				} else if (md5prop & kMD5Archive) {
+					// Archive members are present when their archive is
+					Common::StringTokenizer tok(fileDesc->fileName, ":");
+					tok.nextToken();
+					_fileIndex.getOrCreateVal(Common::Path(tok.nextToken())).push_back(id);
+				} else {
+					_fileIndex.getOrCreateVal(file.fileName).push_back(id);
+
+					// detectGame() hashes every such file found at the top
+					// level, so it can be hashed ahead of time
+					if (!strchr(fileDesc->fileName, '/'))
+						ADCacheMan.addPrefetchFile(fileDesc->fileName, md5prop, _md5Bytes);
+				}
+			}
+
+			// An entry can only match when its first file is present
+			if (fileDesc == g->filesDescriptions)
+				_indexedFiles[id].descriptions.push_back(i);
+		}
+	}
+
+	debugC(4, kDebugGlobalDetection, "Indexed %u files of %u detection entries for engine '%s'", _indexedFiles.size(), i, getName());
+}
+
 Common::StringArray AdvancedMetaEngineDetectionBase::getPathsFromEntry(const ADGameDescription *g) {
 	Common::StringArray result;
 	Common::HashMap<Common::String, bool, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> unique;
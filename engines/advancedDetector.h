@@ -24,6 +24,7 @@
 
 #include "engines/metaengine.h"
 #include "engines/engine.h"
+#include "engines/md5cache.h"
 
 #include "common/hash-str.h"
 
@@ -540,7 +541,19 @@ protected:
 	}
 
 private:
+	/** A file checked by the detection entries, with the properties it is checked with. */
+	struct IndexedFile {
+		Common::String key;                /*!< Key of the file in the properties computed by detectGame(). */
+		Common::Path fileName;             /*!< Name of the file, as found in the detection entries. */
+		MD5Properties md5prop;             /*!< Properties used to compute the MD5. */
+		Common::Array<uint> descriptions;  /*!< Detection entries whose first file this is. */
+	};
+
+	typedef Common::HashMap<Common::Path, Common::Array<uint>, Common::Path::IgnoreCase_Hash, Common::Path::IgnoreCase_EqualTo> FileIndex;
+
 	void preprocessDescriptions();
+	void buildFileIndex();
+	void probeIndexedFile(const FileMap &allFiles, uint id, CachedPropertiesMap &filesProps, Common::Array<uint> &candidates);
 	static Common::StringArray getPathsFromEntry(const ADGameDescription *g);
 	bool isEntryGrayListed(const ADGameDescription *g) const;
 	void detectClashes() const;
@@ -550,6 +563,15 @@ private:
 	Common::HashMap<Common::String, bool, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> _globsMap;
 	bool _hashMapsInited;
 
+	/** Every distinct file checked by the detection entries. */
+	Common::Array<IndexedFile> _indexedFiles;
+	/** Indices in _indexedFiles, by the name under which the file is present in a FileMap. */
+	FileIndex _fileIndex;
+	/** Indices in _indexedFiles of the Mac forks, which cannot be looked up by name. */
+	Common::Array<uint> _unindexedFiles;
+	/** Detection entries without any file. */
+	Common::Array<uint> _filelessDescriptions;
+
 protected:
 	/**
 	 * Detect games in the specified directory.
@@ -772,7 +794,57 @@ public:
 		return archiveHashMap.getValOrDefault(node.getPath(), nullptr);
 	}
 
-	AdvancedDetectorCacheManager() {
+	/**
+	 * Look up @p key in the persistent MD5 cache, which is kept on disk next
+	 * to the configuration file and survives between detection runs.
+	 *
+	 * The entry is only used if the size and the modification time of
+	 * @p node are unchanged since it was stored.
+	 */
+	bool getPersistentFileProperties(const Common::String &key, const Common::FSNode &node, FileProperties &fileProps);
+
+	/** Store the properties of @p node under @p key in the persistent MD5 cache. */
+	void setPersistentFileProperties(const Common::String &key, const Common::FSNode &node, const FileProperties &fileProps);
+
+	/**
+	 * Write the persistent MD5 cache back to disk if it was modified. The
+	 * new contents are written to a temporary file, which then replaces
+	 * the old one.
+	 *
+	 * Unless @p force is set, writes are rate limited, so that scanning many
+	 * directories in a row does not rewrite the whole file for each of them.
+	 */
+	void savePersistentCache(bool force = true);
+
+	/**
+	 * Register a file which the detector of an engine hashes whenever it is
+	 * present, so that prefetchFileProperties() can hash it in advance.
+	 */
+	void addPrefetchFile(const Common::String &fname, MD5Properties md5prop, uint md5Bytes);
+
+	/**
+	 * Hash the registered files found in @p lists, spreading the work over
+	 * the job system. The results answer the getFileProperties() calls of
+	 * the following detection runs, until clearPrefetched() is called at
+	 * the end of the scan.
+	 */
+	void prefetchFileProperties(const Common::Array<Common::FSList> &lists);
+
+	/** Look up @p key in the results of the last prefetchFileProperties() call. */
+	bool getPrefetchedFileProperties(const Common::String &key, FileProperties &fileProps) const {
+		PrefetchHashMap::const_iterator it = prefetchHashMap.find(key);
+		if (it == prefetchHashMap.end())
+			return false;
+
+		fileProps = it->_value;
+		return true;
+	}
+
+	void clearPrefetched() {
+		prefetchHashMap.clear(true);
+	}
+
+	AdvancedDetectorCacheManager() : persistentCache(kPersistentCacheMaxEntries), persistentLoaded(false), persistentLastSave(0) {
 		clear();
 	}
 
@@ -783,6 +855,10 @@ public:
 		archiveHashMap.clear(true);
 	}
 
+	/**
+	 * Forget everything gathered during the current detection run.
+	 * The persistent MD5 cache is kept.
+	 */
 	void clear() {
 		md5HashMap.clear(true);
 		sizeHashMap.clear(true);
@@ -792,12 +868,38 @@ public:
 private:
 	friend class Common::Singleton<AdvancedDetectorCacheManager>;
 
+	enum {
+		/**
+		 * Upper bound on the number of entries written back, so that the
+		 * cache cannot grow without limit when games are moved around. The
+		 * least recently used entries are dropped first.
+		 */
+		kPersistentCacheMaxEntries = 200000
+	};
+
+	struct PrefetchFile {
+		Common::String fname;
+		MD5Properties md5prop;
+		uint md5Bytes;
+	};
+
+	void loadPersistentCache();
+
 	typedef Common::HashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FileHashMap;
 	typedef Common::HashMap<Common::String, int64, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> SizeHashMap;
 	typedef Common::HashMap<Common::Path, Common::Archive *, Common::Path::IgnoreCase_Hash, Common::Path::IgnoreCase_EqualTo> ArchiveHashMap;
 	FileHashMap md5HashMap;
 	SizeHashMap sizeHashMap;
 	ArchiveHashMap archiveHashMap;
+
+	PersistentMD5Cache persistentCache;
+	bool persistentLoaded;
+	uint32 persistentLastSave;
+
+	typedef Common::HashMap<Common::String, Common::Array<PrefetchFile>, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> PrefetchFileMap;
+	typedef Common::HashMap<Common::String, FileProperties> PrefetchHashMap;
+	PrefetchFileMap prefetchFileMap;
+	PrefetchHashMap prefetchHashMap;
 };
 
 /** Convenience shortcut for accessing the MD5CacheManager. */
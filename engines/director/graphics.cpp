@@ -276,78 +276,30 @@ void DirectorEngine::draw() {
 	g_system->updateScreen();
 }
 
+// Blends a sprite pixel with the destination according to the sprite's
+// blend factor.
 template <typename T>
-class InkPrimitives final : public Graphics::Primitives {
-public:
-	constexpr InkPrimitives() {}
-	void drawPoint(int x, int y, uint32 src, void *data) override;
-};
-
-template <typename T>
-void InkPrimitives<T>::drawPoint(int x, int y, uint32 src, void *data) {
-	DirectorPlotData *p = (DirectorPlotData *)data;
-	Graphics::MacWindowManager *wm = p->d->_wm;
-
-	if (!p->destRect.contains(x, y))
-		return;
-
-	T *dst;
-	uint32 tmpDst;
-
-	dst = (T *)p->dst->getBasePtr(x, y);
-
-	if (p->ms) {
-		if (p->ms->pd->thickness > 1) {
-			int prevThickness = p->ms->pd->thickness;
-			int x1 = x;
-			int x2 = x1 + prevThickness;
-			int y1 = y;
-			int y2 = y1 + prevThickness;
-
-			p->ms->pd->thickness = 1;	// We do not want recursive loops
-
-			for (y = y1; y < y2; y++)
-				for (x = x1; x < x2; x++)
-					if (x >= 0 && x < p->ms->pd->surface->w && y >= 0 && y < p->ms->pd->surface->h) {
-						drawPoint(x, y, src, data);
-					}
-
-			p->ms->pd->thickness = prevThickness;
-			return;
-		}
-
-		if (p->ms->tile) {
-			int x1 = p->ms->tileRect->left + (p->ms->pd->fillOriginX + x) % p->ms->tileRect->width();
-			int y1 = p->ms->tileRect->top  + (p->ms->pd->fillOriginY + y) % p->ms->tileRect->height();
-
-			src = p->ms->tile->_surface.getPixel(x1, y1);
-		} else {
-			// Get the pixel that macDrawPixel will give us, but store it to apply the
-			// ink later
-			tmpDst = *dst;
-			wm->getDrawPrimitives().drawPoint(x, y, src, p->ms->pd);
-			src = *dst;
+static FORCEINLINE void blendInkPixel(DirectorPlotData *p, Graphics::MacWindowManager *wm, uint32 src, T *dst) {
+	byte rSrc, gSrc, bSrc;
+	byte rDst, gDst, bDst;
 
-			*dst = tmpDst;
-		}
-	} else if (p->alpha) {
-		// Sprite blend does not respect colourization; defaults to matte ink
-		byte rSrc, gSrc, bSrc;
-		byte rDst, gDst, bDst;
+	wm->decomposeColor<T>(src, rSrc, gSrc, bSrc);
+	wm->decomposeColor<T>(*dst, rDst, gDst, bDst);
 
-		wm->decomposeColor<T>(src, rSrc, gSrc, bSrc);
-		wm->decomposeColor<T>(*dst, rDst, gDst, bDst);
-
-		rDst = lerpByte(rSrc, rDst, p->alpha, 255);
-		gDst = lerpByte(gSrc, gDst, p->alpha, 255);
-		bDst = lerpByte(bSrc, bDst, p->alpha, 255);
-		*dst = wm->findBestColor(rDst, gDst, bDst);
-		return;
-	}
+	rDst = lerpByte(rSrc, rDst, p->alpha, 255);
+	gDst = lerpByte(gSrc, gDst, p->alpha, 255);
+	bDst = lerpByte(bSrc, bDst, p->alpha, 255);
+	*dst = wm->findBestColor(rDst, gDst, bDst);
+}
 
- 	switch (p->ink) {
+// Applies an ink to a single pixel. When Plain is set, the caller has made
+// sure that no colourization is needed, which removes those branches from
+// the specialised row blitters below.
+template <typename T, bool Plain>
+static FORCEINLINE void inkPixel(InkType ink, DirectorPlotData *p, Graphics::MacWindowManager *wm, uint32 src, T *dst) {
+	switch (ink) {
 	case kInkTypeBackgndTrans:
-		if (p->oneBitImage) {
+		if (!Plain && p->oneBitImage) {
 			// One-bit images have a slightly different rendering algorithm for BackgndTrans.
 			// Foreground colour is used, and background colour is ignored.
 			*dst = (src == p->colorBlack) ? p->foreColor : *dst;
@@ -363,7 +315,7 @@ void InkPrimitives<T>::drawPoint(int x, int y, uint32 src, void *data) {
 		// If there's a blend factor set, it's dealt with in the alpha handling block.
 		// Otherwise, treat it like a Matte image.
 	case kInkTypeCopy: {
-		if (p->applyColor) {
+		if (!Plain && p->applyColor) {
 			if (sizeof(T) == 1) {
 				*dst = (src == 0xff) ? p->foreColor : ((src == 0x00) ? p->backColor : *dst);
 			} else {
@@ -388,7 +340,7 @@ void InkPrimitives<T>::drawPoint(int x, int y, uint32 src, void *data) {
 		break;
 	}
 	case kInkTypeNotCopy:
-		if (p->applyColor) {
+		if (!Plain && p->applyColor) {
 			if (sizeof(T) == 1) {
 				*dst = (src == 0xff) ? p->backColor : ((src == 0x00) ? p->foreColor : src);
 			} else {
@@ -416,7 +368,7 @@ void InkPrimitives<T>::drawPoint(int x, int y, uint32 src, void *data) {
 		}
 		break;
 	case kInkTypeTransparent:
-		if (p->oneBitImage || p->applyColor) {
+		if (!Plain && (p->oneBitImage || p->applyColor)) {
 			*dst = (src == p->colorBlack) ? p->foreColor : *dst;
 		} else {
 			// OR dst palette index with src.
@@ -426,7 +378,7 @@ void InkPrimitives<T>::drawPoint(int x, int y, uint32 src, void *data) {
 		}
 		break;
 	case kInkTypeNotTrans:
-		if (p->oneBitImage || p->applyColor) {
+		if (!Plain && (p->oneBitImage || p->applyColor)) {
 			*dst = (src == p->colorWhite) ? p->foreColor : *dst;
 		} else {
 			// OR dst palette index with the inverse of src.
@@ -445,7 +397,7 @@ void InkPrimitives<T>::drawPoint(int x, int y, uint32 src, void *data) {
 		*dst ^= ~(src);
 		break;
 	case kInkTypeGhost:
-		if (p->oneBitImage || p->applyColor) {
+		if (!Plain && (p->oneBitImage || p->applyColor)) {
 			*dst = (src == p->colorBlack) ? p->backColor : *dst;
 		} else {
 			// AND dst palette index with the inverse of src.
@@ -456,7 +408,7 @@ void InkPrimitives<T>::drawPoint(int x, int y, uint32 src, void *data) {
 		}
 		break;
 	case kInkTypeNotGhost:
-		if (p->oneBitImage || p->applyColor) {
+		if (!Plain && (p->oneBitImage || p->applyColor)) {
 			*dst = (src == p->colorWhite) ? p->backColor : *dst;
 		} else {
 			// AND dst palette index with src.
@@ -471,7 +423,7 @@ void InkPrimitives<T>::drawPoint(int x, int y, uint32 src, void *data) {
 		wm->decomposeColor<T>(src, rSrc, gSrc, bSrc);
 		wm->decomposeColor<T>(*dst, rDst, gDst, bDst);
 
-		switch (p->ink) {
+		switch (ink) {
 		case kInkTypeAddPin:
 			// Add src to dst, but pinning each channel so it can't go above 0xff.
 			*dst = wm->findBestColor(rDst + MIN(0xff - rDst, (int)rSrc), gDst + MIN(0xff - gDst, (int)gSrc), bDst + MIN(0xff - bDst, (int)bSrc));
@@ -503,6 +455,69 @@ void InkPrimitives<T>::drawPoint(int x, int y, uint32 src, void *data) {
 	}
 }
 
+template <typename T>
+class InkPrimitives final : public Graphics::Primitives {
+public:
+	constexpr InkPrimitives() {}
+	void drawPoint(int x, int y, uint32 src, void *data) override;
+};
+
+template <typename T>
+void InkPrimitives<T>::drawPoint(int x, int y, uint32 src, void *data) {
+	DirectorPlotData *p = (DirectorPlotData *)data;
+	Graphics::MacWindowManager *wm = p->d->_wm;
+
+	if (!p->destRect.contains(x, y))
+		return;
+
+	T *dst;
+	uint32 tmpDst;
+
+	dst = (T *)p->dst->getBasePtr(x, y);
+
+	if (p->ms) {
+		if (p->ms->pd->thickness > 1) {
+			int prevThickness = p->ms->pd->thickness;
+			int x1 = x;
+			int x2 = x1 + prevThickness;
+			int y1 = y;
+			int y2 = y1 + prevThickness;
+
+			p->ms->pd->thickness = 1;	// We do not want recursive loops
+
+			for (y = y1; y < y2; y++)
+				for (x = x1; x < x2; x++)
+					if (x >= 0 && x < p->ms->pd->surface->w && y >= 0 && y < p->ms->pd->surface->h) {
+						drawPoint(x, y, src, data);
+					}
+
+			p->ms->pd->thickness = prevThickness;
+			return;
+		}
+
+		if (p->ms->tile) {
+			int x1 = p->ms->tileRect->left + (p->ms->pd->fillOriginX + x) % p->ms->tileRect->width();
+			int y1 = p->ms->tileRect->top  + (p->ms->pd->fillOriginY + y) % p->ms->tileRect->height();
+
+			src = p->ms->tile->_surface.getPixel(x1, y1);
+		} else {
+			// Get the pixel that macDrawPixel will give us, but store it to apply the
+			// ink later
+			tmpDst = *dst;
+			wm->getDrawPrimitives().drawPoint(x, y, src, p->ms->pd);
+			src = *dst;
+
+			*dst = tmpDst;
+		}
+	} else if (p->alpha) {
+		// Sprite blend does not respect colourization; defaults to matte ink
+		blendInkPixel<T>(p, wm, src, dst);
+		return;
+	}
+
+	inkPixel<T, false>(p->ink, p, wm, src, dst);
+}
+
 Graphics::Primitives *DirectorEngine::getInkPrimitives() {
 	if (!_primitives) {
 		if (_pixelformat.bytesPerPixel == 1)
@@ -700,6 +715,90 @@ void DirectorPlotData::inkBlitShape(Common::Rect &srcRect) {
 	}
 }
 
+// Row blitters for bitmap sprites, specialised per ink type and pixel size.
+// A negative Ink means the ink is read from the plot data at runtime, which
+// is used for the ink values without a specialisation.
+template <typename T, int Ink, bool Plain>
+static FORCEINLINE void inkBlitPixel(DirectorPlotData *p, Graphics::MacWindowManager *wm, uint32 src, T *dst) {
+	if (!Plain) {
+		src = p->preprocessColor(src);
+
+		if (p->alpha) {
+			blendInkPixel<T>(p, wm, src, dst);
+			return;
+		}
+	}
+
+	inkPixel<T, Plain>(Ink < 0 ? p->ink : (InkType)Ink, p, wm, src, dst);
+}
+
+template <typename T, int Ink, bool Plain>
+static void inkBlitRow(DirectorPlotData *p, T *dst, const T *src, const byte *msk, int width) {
+	Graphics::MacWindowManager *wm = p->d->_wm;
+
+	if (msk) {
+		for (int x = 0; x < width; x++) {
+			if (msk[x])
+				inkBlitPixel<T, Ink, Plain>(p, wm, src[x], &dst[x]);
+		}
+	} else {
+		for (int x = 0; x < width; x++)
+			inkBlitPixel<T, Ink, Plain>(p, wm, src[x], &dst[x]);
+	}
+}
+
+template <typename T>
+struct InkRowBlitter {
+	typedef void (*Func)(DirectorPlotData *p, T *dst, const T *src, const byte *msk, int width);
+
+	static Func get(InkType ink, bool plain) {
+#define INK_ROW_BLITTER(ink) \
+		case ink: \
+			return plain ? &inkBlitRow<T, ink, true> : &inkBlitRow<T, ink, false>
+
+		switch (ink) {
+		INK_ROW_BLITTER(kInkTypeCopy);
+		INK_ROW_BLITTER(kInkTypeTransparent);
+		INK_ROW_BLITTER(kInkTypeReverse);
+		INK_ROW_BLITTER(kInkTypeGhost);
+		INK_ROW_BLITTER(kInkTypeNotCopy);
+		INK_ROW_BLITTER(kInkTypeNotTrans);
+		INK_ROW_BLITTER(kInkTypeNotReverse);
+		INK_ROW_BLITTER(kInkTypeNotGhost);
+		INK_ROW_BLITTER(kInkTypeMatte);
+		INK_ROW_BLITTER(kInkTypeMask);
+		INK_ROW_BLITTER(kInkTypeBlend);
+		INK_ROW_BLITTER(kInkTypeAddPin);
+		INK_ROW_BLITTER(kInkTypeAdd);
+		INK_ROW_BLITTER(kInkTypeSubPin);
+		INK_ROW_BLITTER(kInkTypeBackgndTrans);
+		INK_ROW_BLITTER(kInkTypeLight);
+		INK_ROW_BLITTER(kInkTypeSub);
+		INK_ROW_BLITTER(kInkTypeDark);
+		default:
+			return plain ? &inkBlitRow<T, -1, true> : &inkBlitRow<T, -1, false>;
+		}
+
+#undef INK_ROW_BLITTER
+	}
+};
+
+template <typename T>
+static void inkBlitRows(DirectorPlotData *p, const Common::Point &srcOrigin, int width, int height, const Graphics::Surface *mask) {
+	// Colourization, blending and text preprocessing are decided per sprite,
+	// so most sprites can use the variant without those checks.
+	bool plain = !p->applyColor && !p->alpha && !p->oneBitImage && p->sprite != kTextSprite;
+	typename InkRowBlitter<T>::Func blitRow = InkRowBlitter<T>::get(p->ink, plain);
+
+	for (int i = 0; i < height; i++) {
+		T *dst = (T *)p->dst->getBasePtr(p->destRect.left, p->destRect.top + i);
+		const T *src = (const T *)p->srf->getBasePtr(srcOrigin.x, srcOrigin.y + i);
+		const byte *msk = mask ? (const byte *)mask->getBasePtr(srcOrigin.x, srcOrigin.y + i) : nullptr;
+
+		blitRow(p, dst, src, msk, width);
+	}
+}
+
 void DirectorPlotData::inkBlitSurface(Common::Rect &srcRect, const Graphics::Surface *mask) {
 	if (!srf)
 		return;
@@ -734,26 +833,44 @@ void DirectorPlotData::inkBlitSurface(Common::Rect &srcRect, const Graphics::Sur
 	// format as the window manager. Most of the time this is
 	// the job of BitmapCastMember::createWidget.
 
-	Graphics::Primitives *primitives = g_director->getInkPrimitives();
+	if (!ms) {
+		// Clip against the source surface once, then hand whole rows
+		// to the blitter for the ink.
+		Common::Point srcOrigin(abs(srcRect.left - destRect.left), abs(srcRect.top - destRect.top));
+		int width = MIN<int>(destRect.width(), srf->w - srcOrigin.x);
+		int height = MIN<int>(destRect.height(), srf->h - srcOrigin.y);
+
+		if (!destRect.isEmpty() && (width < destRect.width() || height < destRect.height()))
+			failedBoundsCheck = true;
+
+		if (width > 0 && height > 0) {
+			if (d->_wm->_pixelformat.bytesPerPixel == 1)
+				inkBlitRows<byte>(this, srcOrigin, width, height, mask);
+			else
+				inkBlitRows<uint32>(this, srcOrigin, width, height, mask);
+		}
+	} else {
+		Graphics::Primitives *primitives = g_director->getInkPrimitives();
 
-	srcPoint.y = abs(srcRect.top - destRect.top);
-	for (int i = 0; i < destRect.height(); i++, srcPoint.y++) {
-		srcPoint.x = abs(srcRect.left - destRect.left);
-		const byte *msk = mask ? (const byte *)mask->getBasePtr(srcPoint.x, srcPoint.y) : nullptr;
+		srcPoint.y = abs(srcRect.top - destRect.top);
+		for (int i = 0; i < destRect.height(); i++, srcPoint.y++) {
+			srcPoint.x = abs(srcRect.left - destRect.left);
+			const byte *msk = mask ? (const byte *)mask->getBasePtr(srcPoint.x, srcPoint.y) : nullptr;
 
-		for (int j = 0; j < destRect.width(); j++, srcPoint.x++) {
-			if (!srfClip.contains(srcPoint)) {
-				failedBoundsCheck = true;
-				continue;
-			}
+			for (int j = 0; j < destRect.width(); j++, srcPoint.x++) {
+				if (!srfClip.contains(srcPoint)) {
+					failedBoundsCheck = true;
+					continue;
+				}
 
-			if (!mask || (msk && (*msk++))) {
-				if (d->_wm->_pixelformat.bytesPerPixel == 1) {
-					primitives->drawPoint(destRect.left + j, destRect.top + i,
-										preprocessColor(*((byte *)srf->getBasePtr(srcPoint.x, srcPoint.y))), this);
-				} else {
-					primitives->drawPoint(destRect.left + j, destRect.top + i,
-										preprocessColor(*((uint32 *)srf->getBasePtr(srcPoint.x, srcPoint.y))), this);
+				if (!mask || (msk && (*msk++))) {
+					if (d->_wm->_pixelformat.bytesPerPixel == 1) {
+						primitives->drawPoint(destRect.left + j, destRect.top + i,
+											preprocessColor(*((byte *)srf->getBasePtr(srcPoint.x, srcPoint.y))), this);
+					} else {
+						primitives->drawPoint(destRect.left + j, destRect.top + i,
+											preprocessColor(*((uint32 *)srf->getBasePtr(srcPoint.x, srcPoint.y))), this);
+					}
 				}
 			}
 		}
@@ -0,0 +1,179 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/algorithm.h"
+#include "common/array.h"
+#include "common/stream.h"
+
+#include "engines/md5cache.h"
+
+namespace {
+
+const char *const kCacheHeader = "# ScummVM detection MD5 cache v2";
+
+bool parseInt64(const Common::String &str, int64 &value) {
+	if (str.empty())
+		return false;
+
+	bool negative = str[0] == '-';
+	Common::String digits = negative ? Common::String(str.c_str() + 1) : str;
+	if (digits.empty() || digits.findFirstNotOf("0123456789") != Common::String::npos)
+		return false;
+
+	value = (int64)digits.asUint64();
+	if (negative)
+		value = -value;
+	return true;
+}
+
+struct EvictionCandidate {
+	uint32 lastUse;
+	Common::String key;
+};
+
+} // End of anonymous namespace
+
+PersistentMD5Cache::PersistentMD5Cache(uint maxEntries) :
+	_maxEntries(maxEntries), _useCounter(0), _dirty(false) {
+}
+
+bool PersistentMD5Cache::load(Common::SeekableReadStream &stream) {
+	_entries.clear();
+	_useCounter = 0;
+	_dirty = false;
+
+	if (stream.readLine() != kCacheHeader)
+		return false;
+
+	while (!stream.eos() && !stream.err()) {
+		Common::String line = stream.readLine();
+		if (line.empty())
+			continue;
+
+		// md5 <tab> size <tab> file size <tab> modification time <tab> last use <tab> key
+		Common::String fields[5];
+		size_t pos = 0;
+		uint i;
+		for (i = 0; i < ARRAYSIZE(fields); i++) {
+			size_t tab = line.find('\t', pos);
+			if (tab == Common::String::npos)
+				break;
+			fields[i] = line.substr(pos, tab - pos);
+			pos = tab + 1;
+		}
+
+		Entry entry;
+		int64 fileSize, lastUse;
+		if (i != ARRAYSIZE(fields) || pos >= line.size() ||
+				!parseInt64(fields[1], entry.size) ||
+				!parseInt64(fields[2], fileSize) || fileSize < 0 ||
+				!parseInt64(fields[3], entry.modificationTime) ||
+				!parseInt64(fields[4], lastUse) || lastUse < 0 || lastUse > 0xFFFFFFFF)
+			continue;
+
+		entry.md5 = fields[0];
+		entry.fileSize = fileSize;
+		entry.lastUse = (uint32)lastUse;
+		_useCounter = MAX(_useCounter, entry.lastUse);
+		_entries.setVal(line.substr(pos), entry);
+	}
+
+	return true;
+}
+
+void PersistentMD5Cache::save(Common::WriteStream &stream) {
+	evict();
+
+	stream.writeString(kCacheHeader);
+	stream.writeByte('\n');
+
+	for (EntryMap::const_iterator it = _entries.begin(); it != _entries.end(); ++it) {
+		stream.writeString(Common::String::format("%s\t%lld\t%llu\t%lld\t%u\t%s\n", it->_value.md5.c_str(),
+			(long long)it->_value.size, (unsigned long long)it->_value.fileSize,
+			(long long)it->_value.modificationTime, it->_value.lastUse, it->_key.c_str()));
+	}
+
+	_dirty = false;
+}
+
+void PersistentMD5Cache::evict() {
+	if (_entries.size() <= _maxEntries)
+		return;
+
+	Common::Array<EvictionCandidate> candidates;
+	candidates.reserve(_entries.size());
+	for (EntryMap::const_iterator it = _entries.begin(); it != _entries.end(); ++it) {
+		EvictionCandidate candidate;
+		candidate.lastUse = it->_value.lastUse;
+		candidate.key = it->_key;
+		candidates.push_back(candidate);
+	}
+
+	Common::sort(candidates.begin(), candidates.end(), [](const EvictionCandidate &a, const EvictionCandidate &b) {
+		return a.lastUse < b.lastUse;
+	});
+
+	const uint count = _entries.size() - _maxEntries;
+	for (uint i = 0; i < count; i++)
+		_entries.erase(candidates[i].key);
+	_dirty = true;
+}
+
+const PersistentMD5Cache::Entry *PersistentMD5Cache::find(const Common::String &key, uint64 fileSize, int64 modificationTime) const {
+	EntryMap::const_iterator it = _entries.find(key);
+	if (it == _entries.end() || it->_value.fileSize != fileSize || it->_value.modificationTime != modificationTime)
+		return nullptr;
+
+	return &it->_value;
+}
+
+const PersistentMD5Cache::Entry *PersistentMD5Cache::use(const Common::String &key, uint64 fileSize, int64 modificationTime) {
+	EntryMap::iterator it = _entries.find(key);
+	if (it == _entries.end() || it->_value.fileSize != fileSize || it->_value.modificationTime != modificationTime)
+		return nullptr;
+
+	// Only recorded on disk the next time the cache is saved for other
+	// reasons, so that using the cache does not rewrite it.
+	it->_value.lastUse = ++_useCounter;
+	return &it->_value;
+}
+
+void PersistentMD5Cache::store(const Common::String &key, uint64 fileSize, int64 modificationTime, int64 size, const Common::String &md5) {
+	// The cache is line based
+	if (key.contains('\n') || key.contains('\r'))
+		return;
+
+	EntryMap::iterator it = _entries.find(key);
+	if (it != _entries.end() && it->_value.md5 == md5 && it->_value.size == size &&
+			it->_value.fileSize == fileSize && it->_value.modificationTime == modificationTime) {
+		it->_value.lastUse = ++_useCounter;
+		return;
+	}
+
+	Entry entry;
+	entry.fileSize = fileSize;
+	entry.modificationTime = modificationTime;
+	entry.size = size;
+	entry.md5 = md5;
+	entry.lastUse = ++_useCounter;
+	_entries.setVal(key, entry);
+	_dirty = true;
+}
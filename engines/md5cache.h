@@ -0,0 +1,110 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ENGINES_MD5CACHE_H
+#define ENGINES_MD5CACHE_H
+
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/str.h"
+
+namespace Common {
+class SeekableReadStream;
+class WriteStream;
+}
+
+/**
+ * @defgroup engines_md5cache Persistent MD5 cache
+ * @ingroup engines
+ *
+ * @brief Detection MD5s kept between runs, for the AdvancedDetector.
+ *
+ * @{
+ */
+
+/**
+ * The file properties computed by the detectors, keyed by a string naming
+ * the file and how it was hashed. Every entry remembers the size and the
+ * modification time of the file on disk, and is only returned while both
+ * are unchanged.
+ *
+ * When the cache holds more entries than its limit, the least recently used
+ * ones are dropped when it is saved.
+ */
+class PersistentMD5Cache {
+public:
+	struct Entry {
+		uint64 fileSize;
+		int64 modificationTime;
+		int64 size;
+		Common::String md5;
+		uint32 lastUse;
+	};
+
+	explicit PersistentMD5Cache(uint maxEntries);
+
+	/**
+	 * Replace the contents of the cache with those read from @p stream.
+	 *
+	 * @return False if the stream does not hold a cache, which is then empty.
+	 */
+	bool load(Common::SeekableReadStream &stream);
+
+	/**
+	 * Write the cache to @p stream, after evicting the least recently used
+	 * entries over the limit. The cache is no longer dirty afterwards.
+	 */
+	void save(Common::WriteStream &stream);
+
+	/**
+	 * Find the entry for @p key if the file still has the given size and
+	 * modification time. This does not count as a use, so it may be called
+	 * from several threads at once.
+	 */
+	const Entry *find(const Common::String &key, uint64 fileSize, int64 modificationTime) const;
+
+	/** Like find(), but marks the entry as used. */
+	const Entry *use(const Common::String &key, uint64 fileSize, int64 modificationTime);
+
+	/**
+	 * Store the properties of a file. The cache only becomes dirty if this
+	 * changes an entry.
+	 */
+	void store(const Common::String &key, uint64 fileSize, int64 modificationTime, int64 size, const Common::String &md5);
+
+	/** Whether the cache changed since it was last loaded or saved. */
+	bool isDirty() const { return _dirty; }
+
+	uint size() const { return _entries.size(); }
+
+private:
+	void evict();
+
+	typedef Common::HashMap<Common::String, Entry> EntryMap;
+	EntryMap _entries;
+	uint _maxEntries;
+	uint32 _useCounter;
+	bool _dirty;
+};
+
+/** @} */
+
+#endif
@@ -607,6 +607,17 @@ public:
 	 */
 	DetectionResults detectGames(const Common::FSList &fslist, uint32 skipADFlags = 0, bool skipIncomplete = false);
 
+	/**
+	 * List the contents of several directories ahead of calling detectGames()
+	 * on each of them, and hash the files the detectors are going to check.
+	 * The I/O is spread over the job system.
+	 *
+	 * @param dirs      The directories to list.
+	 * @param contents  Receives the contents of each directory.
+	 * @param listed    Receives whether each directory could be listed.
+	 */
+	void listDirectories(const Common::FSList &dirs, Common::Array<Common::FSList> &contents, Common::Array<bool> &listed) const;
+
 	/** Find a plugin by its engine ID. */
 	const Plugin *findDetectionPlugin(const Common::String &engineId) const;
 
@@ -85,6 +85,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	// Variables
 	registerVar("sleeptime_factor",	&g_debug_sleeptime_factor);
 	registerVar("gc_interval",		&engine->_gamestate->scriptGCInterval);
+	registerVar("gc_incremental",		&engine->_gamestate->scriptGCIncremental);
 	registerVar("simulated_key",		&g_debug_simulated_key);
 	registerVar("track_mouse_clicks",	&g_debug_track_mouse_clicks);
 	registerCmd("speed_throttle",   WRAP_METHOD(Console, cmdSpeedThrottle));
@@ -98,11 +98,9 @@ static void processWorkList(SegManager *segMan, WorklistManager &wm, const Commo
 	}
 }
 
-AddrSet *findAllActiveReferences(EngineState *s) {
+static void pushRootSet(EngineState *s, WorklistManager &wm) {
 	assert(!s->_executionStack.empty());
 
-	WorklistManager wm;
-
 	// Initialize registers
 	wm.push(s->r_acc);
 	wm.push(s->r_prev);
@@ -169,8 +167,14 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 	}
 
 	debugC(kDebugLevelGC, "[GC] -- Finished explicitly loaded scripts, done with root set");
+}
+
+AddrSet *findAllActiveReferences(EngineState *s) {
+	WorklistManager wm;
+
+	pushRootSet(s, wm);
 
-	processWorkList(s->_segMan, wm, heap);
+	processWorkList(s->_segMan, wm, s->_segMan->getSegments());
 
 	if (g_sci->_gfxPorts)
 		g_sci->_gfxPorts->processEngineHunkList(wm);
@@ -181,6 +185,9 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 void run_gc(EngineState *s) {
 	SegManager *segMan = s->_segMan;
 
+	// A full collection supersedes any incremental one in progress
+	segMan->setGCPhase(SegManager::kGCIdle);
+
 	// Some debug stuff
 	debugC(kDebugLevelGC, "[GC] Running...");
 #ifdef GC_DEBUG_CODE
@@ -234,4 +241,188 @@ void run_gc(EngineState *s) {
 #endif
 }
 
+enum {
+	GC_STEP_SIZE = 500,       ///< Number of objects marked or swept per incremental step
+	GC_MAX_FINISH_TRIES = 16  ///< Number of bounded attempts at finishing the marking
+};
+
+static void flushGreyList(SegManager *segMan, WorklistManager &wm) {
+	Common::Array<reg_t> &greyList = segMan->getGCGreyList();
+	wm.pushArray(greyList);
+	greyList.resize(0);
+}
+
+/**
+ * Marks at most maxCount objects of the work list.
+ * @return true if the work list has been emptied
+ */
+static bool markWorkList(SegManager *segMan, GCState &gc, uint maxCount) {
+	WorklistManager &wm = gc.wm;
+	SegmentId stackSegment = segMan->findSegmentByType(SEG_TYPE_STACK);
+
+	for (uint count = 0; count < maxCount && !wm._worklist.empty(); count++) {
+		reg_t reg = wm._worklist.back();
+		wm._worklist.pop_back();
+
+		SegmentObj *mobj = segMan->getSegmentObj(reg.getSegment());
+		if (!mobj)
+			continue;
+
+		gc.activeRefs.setVal(mobj->findCanonicAddress(segMan, reg), true);
+
+		// The game keeps running between the steps, so the object may have
+		// been freed explicitly since it was added to the work list
+		if (reg.getSegment() != stackSegment && mobj->isValidOffset(reg.getOffset())) {
+			debugC(kDebugLevelGC, "[GC] Checking %04x:%04x", PRINT_REG(reg));
+			wm.pushArray(mobj->listAllOutgoingReferences(reg));
+		}
+	}
+
+	return wm._worklist.empty();
+}
+
+/**
+ * Tries to complete the marking phase. Registers, the stack and local
+ * variables are not guarded by the write barrier, so they are scanned
+ * again, as are all objects allocated since the last try. This only
+ * succeeds if the work list can then be emptied within one step, as the
+ * game must not run between the scan and the end of marking. Otherwise,
+ * marking goes on with the next step, and this is tried again.
+ * @return true if marking has been completed
+ */
+static bool finishMarking(EngineState *s, GCState &gc) {
+	SegManager *segMan = s->_segMan;
+	WorklistManager &wm = gc.wm;
+
+	pushRootSet(s, wm);
+
+	const Common::Array<SegmentObj *> &heap = segMan->getSegments();
+	for (uint seg = 1; seg < heap.size(); seg++) {
+		if (heap[seg] && heap[seg]->getType() == SEG_TYPE_LOCALS)
+			wm.pushArray(heap[seg]->listAllOutgoingReferences(make_reg(seg, 0)));
+	}
+
+	if (g_sci->_gfxPorts)
+		g_sci->_gfxPorts->processEngineHunkList(wm);
+
+	flushGreyList(segMan, wm);
+
+	// A new object may have taken the place of one that has been marked
+	// already, so its contents are scanned unconditionally
+	Common::Array<reg_t> &allocations = segMan->getGCAllocations();
+	for (uint i = 0; i < allocations.size(); i++) {
+		const reg_t addr = allocations[i];
+		SegmentObj *mobj = segMan->getSegmentObj(addr.getSegment());
+		if (mobj && mobj->isValidOffset(addr.getOffset())) {
+			gc.activeRefs.setVal(mobj->findCanonicAddress(segMan, addr), true);
+			wm.pushArray(mobj->listAllOutgoingReferences(addr));
+		}
+	}
+	allocations.resize(0);
+
+	if (!markWorkList(segMan, gc, GC_STEP_SIZE)) {
+		// Keep the game from outrunning the collector forever
+		if (++gc.finishTries < GC_MAX_FINISH_TRIES)
+			return false;
+
+		debugC(kDebugLevelGC, "[GC] -- Finishing marking without interruption");
+		markWorkList(segMan, gc, UINT_MAX);
+	}
+
+	debugC(kDebugLevelGC, "[GC] -- Finished marking, %d active references", gc.activeRefs.size());
+	return true;
+}
+
+/**
+ * Frees at most maxCount unmarked objects.
+ * @return true if all segments have been swept
+ */
+static bool sweepStep(SegManager *segMan, GCState &gc, uint maxCount) {
+	const Common::Array<SegmentObj *> &heap = segMan->getSegments();
+
+	// Objects allocated since marking finished are alive as well
+	Common::Array<reg_t> &allocations = segMan->getGCAllocations();
+	for (uint i = 0; i < allocations.size(); i++)
+		gc.activeRefs.setVal(allocations[i], true);
+	allocations.resize(0);
+
+	uint count = 0;
+	while (count < maxCount) {
+		// Move on to the next segment when this one is done, or when it has
+		// been replaced since its list of objects was taken
+		if (gc.sweepIndex >= gc.sweepList.size() || heap[gc.sweepSegment] != gc.sweepObj) {
+			if (++gc.sweepSegment >= heap.size())
+				return true;
+
+			gc.sweepObj = heap[gc.sweepSegment];
+			gc.sweepIndex = 0;
+			if (gc.sweepObj)
+				gc.sweepList = gc.sweepObj->listAllDeallocatable(gc.sweepSegment);
+			else
+				gc.sweepList.resize(0);
+			continue;
+		}
+
+		SegmentObj *mobj = heap[gc.sweepSegment];
+		const reg_t addr = gc.sweepList[gc.sweepIndex++];
+		count++;
+
+		// Skip objects which have been freed explicitly in the meantime
+		if (!gc.activeRefs.contains(addr) && mobj->isValidOffset(addr.getOffset())) {
+			mobj->freeAtAddress(segMan, addr);
+			debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
+		}
+	}
+
+	return false;
+}
+
+bool run_gc_step(EngineState *s) {
+	SegManager *segMan = s->_segMan;
+
+	if (!s->_gcState)
+		s->_gcState = new GCState();
+	GCState &gc = *s->_gcState;
+
+	switch (segMan->getGCPhase()) {
+	case SegManager::kGCIdle:
+		debugC(kDebugLevelGC, "[GC] Starting incremental collection");
+		gc.wm._worklist.resize(0);
+		gc.wm._map.clear(false);
+		gc.activeRefs.clear(false);
+		gc.finishTries = 0;
+		segMan->setGCPhase(SegManager::kGCMarking);
+		pushRootSet(s, gc.wm);
+		// fall through
+
+	case SegManager::kGCMarking:
+		flushGreyList(segMan, gc.wm);
+		if (!markWorkList(segMan, gc, GC_STEP_SIZE))
+			return false;
+
+		if (!finishMarking(s, gc))
+			return false;
+
+		segMan->setGCPhase(SegManager::kGCSweeping);
+		gc.sweepSegment = 0;
+		gc.sweepObj = nullptr;
+		gc.sweepList.resize(0);
+		gc.sweepIndex = 0;
+		return false;
+
+	case SegManager::kGCSweeping:
+		if (!sweepStep(segMan, gc, GC_STEP_SIZE))
+			return false;
+
+		segMan->setGCPhase(SegManager::kGCIdle);
+		debugC(kDebugLevelGC, "[GC] Finished incremental collection");
+		return true;
+
+	default:
+		break;
+	}
+
+	return false;
+}
+
 } // End of namespace Sci
@@ -62,6 +62,35 @@ struct WorklistManager {
 	void pushArray(const Common::Array<reg_t> &tmp);
 };
 
+/**
+ * State of the incremental garbage collector, kept between the steps of a
+ * collection. It also survives from one collection to the next, so that
+ * the work lists and address sets can reuse their storage.
+ */
+struct GCState {
+	WorklistManager wm;
+	AddrSet activeRefs;	// canonical addresses of all objects marked so far
+
+	uint finishTries;	// failed attempts at finishing the marking
+
+	// Sweep position
+	SegmentId sweepSegment;
+	const SegmentObj *sweepObj;
+	Common::Array<reg_t> sweepList;
+	uint sweepIndex;
+
+	GCState() : finishTries(0), sweepSegment(0), sweepObj(nullptr), sweepIndex(0) {}
+};
+
+/**
+ * Runs one step of an incremental garbage collection. A new collection is
+ * started if none is in progress. Marking and sweeping are spread over the
+ * following calls, each of which only does a bounded amount of work.
+ * @param s The state in which we should gc
+ * @return true if the collection has been completed
+ */
+bool run_gc_step(EngineState *s);
+
 
 } // End of namespace Sci
 
@@ -218,6 +218,9 @@ static void addToFront(EngineState *s, reg_t listRef, reg_t nodeRef) {
 		oldNode->pred = nodeRef;
 	}
 	list->first = nodeRef;
+
+	s->_segMan->writeBarrier(nodeRef);
+	s->_segMan->writeBarrier(newNode->succ);
 }
 
 static void addToEnd(EngineState *s, reg_t listRef, reg_t nodeRef) {
@@ -244,6 +247,9 @@ static void addToEnd(EngineState *s, reg_t listRef, reg_t nodeRef) {
 		old_n->succ = nodeRef;
 	}
 	list->last = nodeRef;
+
+	s->_segMan->writeBarrier(nodeRef);
+	s->_segMan->writeBarrier(newNode->pred);
 }
 
 reg_t kNextNode(EngineState *s, int argc, reg_t *argv) {
@@ -284,8 +290,10 @@ reg_t kNodeValue(EngineState *s, int argc, reg_t *argv) {
 reg_t kAddToFront(EngineState *s, int argc, reg_t *argv) {
 	addToFront(s, argv[0], argv[1]);
 
-	if (argc == 3)
+	if (argc == 3) {
 		s->_segMan->lookupNode(argv[1])->key = argv[2];
+		s->_segMan->writeBarrier(argv[2]);
+	}
 
 	return s->r_acc;
 }
@@ -293,8 +301,10 @@ reg_t kAddToFront(EngineState *s, int argc, reg_t *argv) {
 reg_t kAddToEnd(EngineState *s, int argc, reg_t *argv) {
 	addToEnd(s, argv[0], argv[1]);
 
-	if (argc == 3)
+	if (argc == 3) {
 		s->_segMan->lookupNode(argv[1])->key = argv[2];
+		s->_segMan->writeBarrier(argv[2]);
+	}
 
 	return s->r_acc;
 }
@@ -318,8 +328,10 @@ reg_t kAddAfter(EngineState *s, int argc, reg_t *argv) {
 		return NULL_REG;
 	}
 
-	if (argc == 4)
+	if (argc == 4) {
 		newNode->key = argv[3];
+		s->_segMan->writeBarrier(argv[3]);
+	}
 
 	if (firstNode) { // We're really appending after
 		const reg_t oldNext = firstNode->succ;
@@ -334,6 +346,9 @@ reg_t kAddAfter(EngineState *s, int argc, reg_t *argv) {
 		else
 			s->_segMan->lookupNode(oldNext)->pred = argv[2];
 
+		s->_segMan->writeBarrier(argv[1]);
+		s->_segMan->writeBarrier(argv[2]);
+		s->_segMan->writeBarrier(oldNext);
 	} else {
 		addToFront(s, argv[0], argv[2]); // Set as initial list node
 	}
@@ -360,8 +375,10 @@ reg_t kAddBefore(EngineState *s, int argc, reg_t *argv) {
 		return NULL_REG;
 	}
 
-	if (argc == 4)
+	if (argc == 4) {
 		newNode->key = argv[3];
+		s->_segMan->writeBarrier(argv[3]);
+	}
 
 	if (firstNode) { // We're really appending before
 		const reg_t oldPred = firstNode->pred;
@@ -376,6 +393,9 @@ reg_t kAddBefore(EngineState *s, int argc, reg_t *argv) {
 		else
 			s->_segMan->lookupNode(oldPred)->succ = argv[2];
 
+		s->_segMan->writeBarrier(argv[1]);
+		s->_segMan->writeBarrier(argv[2]);
+		s->_segMan->writeBarrier(oldPred);
 	} else {
 		addToFront(s, argv[0], argv[2]); // Set as initial list node
 	}
@@ -440,6 +460,9 @@ reg_t kDeleteKey(EngineState *s, int argc, reg_t *argv) {
 	if (!n->succ.isNull())
 		s->_segMan->lookupNode(n->succ)->pred = n->pred;
 
+	s->_segMan->writeBarrier(n->pred);
+	s->_segMan->writeBarrier(n->succ);
+
 	// Erase references to the predecessor and successor nodes, as the game
 	// scripts could reference the node itself again.
 	// Happens in the intro of QFG1 and in Longbow, when exiting the cave.
@@ -845,6 +868,8 @@ reg_t kArrayGetElement(EngineState *s, int argc, reg_t *argv) {
 reg_t kArraySetElements(EngineState *s, int argc, reg_t *argv) {
 	SciArray &array = *s->_segMan->lookupArray(argv[0]);
 	array.setElements(argv[1].toUint16(), argc - 2, argv + 2);
+	for (int i = 2; i < argc; ++i)
+		s->_segMan->writeBarrier(argv[i]);
 	return argv[0];
 }
 
@@ -860,6 +885,7 @@ reg_t kArrayFree(EngineState *s, int argc, reg_t *argv) {
 reg_t kArrayFill(EngineState *s, int argc, reg_t *argv) {
 	SciArray &array = *s->_segMan->lookupArray(argv[0]);
 	array.fill(argv[1].toUint16(), argv[2].toUint16(), argv[3]);
+	s->_segMan->writeBarrier(argv[3]);
 	return argv[0];
 }
 
@@ -881,6 +907,14 @@ reg_t kArrayCopy(EngineState *s, int argc, reg_t *argv) {
 		target.copy(source, sourceIndex, targetIndex, count);
 	} else {
 		target.copy(*s->_segMan->lookupArray(argv[2]), sourceIndex, targetIndex, count);
+
+		// The copied references are not seen by the garbage collector
+		// otherwise, if it has already marked the target array
+		if (s->_segMan->getGCPhase() == SegManager::kGCMarking &&
+			(target.getType() == kArrayTypeID || target.getType() == kArrayTypeInt16)) {
+			for (uint i = targetIndex; i < target.size(); ++i)
+				s->_segMan->writeBarrier(target.getAsID(i));
+		}
 	}
 
 	return argv[0];
@@ -68,6 +68,9 @@ enum {
 
 #define VERTEX_HAS_EDGES(V) ((V) != CLIST_NEXT(V))
 
+// Maximum number of vertices for which the visibility graph is cached
+#define MAX_CACHED_VERTICES 512
+
 // Error codes
 enum {
 	PF_OK = 0,
@@ -116,10 +119,14 @@ struct Vertex {
 	// Previous vertex in shortest path
 	Vertex *path_prev;
 
+	// Index into the cached visibility graph, -1 if not cached
+	int cacheIndex;
+
 public:
 	Vertex(const Common::Point &p) : v(p) {
 		costG = HUGE_DISTANCE;
 		path_prev = nullptr;
+		cacheIndex = -1;
 	}
 };
 
@@ -241,6 +248,74 @@ public:
 
 typedef Common::List<Polygon *> PolygonList;
 
+enum {
+	kVisibilityUnknown = 0,
+	kVisibilityVisible = 1,
+	kVisibilityBlocked = 2
+};
+
+// Visibility graph of a polygon set. Entries are filled in as the
+// pathfinder asks for them.
+struct AvoidPathCacheEntry {
+	// Types and vertices of the polygons the graph belongs to
+	Common::Array<int16> key;
+
+	// Visibility of each pair of vertices, indexed by their cacheIndex
+	Common::Array<byte> visibility;
+	uint vertexCount;
+};
+
+// Actors in the same room usually find their paths around the same set of
+// obstacles, often several times per game cycle. The visibility between
+// the obstacle vertices is the expensive part of pathfinding, so we keep
+// it around for the most recently used polygon sets.
+class AvoidPathCache {
+public:
+	~AvoidPathCache() {
+		for (Common::List<AvoidPathCacheEntry *>::iterator it = _entries.begin(); it != _entries.end(); ++it)
+			delete *it;
+	}
+
+	AvoidPathCacheEntry *lookup(const Common::Array<int16> &key, uint vertexCount) {
+		for (Common::List<AvoidPathCacheEntry *>::iterator it = _entries.begin(); it != _entries.end(); ++it) {
+			AvoidPathCacheEntry *entry = *it;
+			if (entry->key == key) {
+				// Keep the most recently used set at the front
+				_entries.erase(it);
+				_entries.push_front(entry);
+				return entry;
+			}
+		}
+
+		AvoidPathCacheEntry *entry;
+		if (_entries.size() >= kMaxEntries) {
+			entry = _entries.back();
+			_entries.pop_back();
+		} else {
+			entry = new AvoidPathCacheEntry();
+		}
+
+		entry->key = key;
+		entry->vertexCount = vertexCount;
+		entry->visibility.clear();
+		entry->visibility.resize(vertexCount * vertexCount);
+		_entries.push_front(entry);
+		return entry;
+	}
+
+private:
+	enum {
+		kMaxEntries = 4
+	};
+
+	Common::List<AvoidPathCacheEntry *> _entries;
+};
+
+void EngineState::freeAvoidPathCache() {
+	delete _avoidPathCache;
+	_avoidPathCache = nullptr;
+}
+
 // Pathfinding state
 struct PathfindingState {
 	// List of all polygons
@@ -255,6 +330,9 @@ struct PathfindingState {
 	// Total number of vertices
 	int vertices;
 
+	// Cached visibility graph for the polygons, or NULL
+	AvoidPathCacheEntry *_visibility;
+
 	// Point to prepend and append to final path
 	Common::Point *_prependPoint;
 	Common::Point *_appendPoint;
@@ -266,6 +344,7 @@ struct PathfindingState {
 		vertex_start = nullptr;
 		vertex_end = nullptr;
 		vertex_index = nullptr;
+		_visibility = nullptr;
 		_prependPoint = nullptr;
 		_appendPoint = nullptr;
 		vertices = 0;
@@ -698,6 +777,39 @@ static int inside(const Common::Point &p, Vertex *vertex) {
 	return 0;
 }
 
+/**
+ * Determines whether a vertex is visible from another vertex.
+ * @param s				the pathfinding state
+ * @param vertex_cur	the vertex to look from
+ * @param vertex		the vertex to look at
+ * @return true if vertex is visible from vertex_cur, false otherwise
+ */
+static bool vertex_visible(PathfindingState *s, Vertex *vertex_cur, Vertex *vertex) {
+	// Make sure we don't intersect a polygon locally at the vertices
+	if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
+		return false;
+
+	// Check for intersecting edges
+	for (int j = 0; j < s->vertices; j++) {
+		Vertex *edge = s->vertex_index[j];
+		if (VERTEX_HAS_EDGES(edge)) {
+			if (between(vertex_cur->v, vertex->v, edge->v)) {
+				// If we hit a vertex, make sure we can pass through it without intersecting its polygon
+				if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
+					return false;
+
+				// This edge won't properly intersect, so we continue
+				continue;
+			}
+
+			if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
+				return false;
+		}
+	}
+
+	return true;
+}
+
 /**
  * Returns a list of all vertices that are visible from a particular vertex.
  * @param s				the pathfinding state
@@ -709,31 +821,20 @@ static VertexList *visible_vertices(PathfindingState *s, Vertex *vertex_cur) {
 
 	for (int i = 0; i < s->vertices; i++) {
 		Vertex *vertex = s->vertex_index[i];
+		bool visible;
 
-		// Make sure we don't intersect a polygon locally at the vertices
-		if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
-			continue;
-
-		// Check for intersecting edges
-		int j;
-		for (j = 0; j < s->vertices; j++) {
-			Vertex *edge = s->vertex_index[j];
-			if (VERTEX_HAS_EDGES(edge)) {
-				if (between(vertex_cur->v, vertex->v, edge->v)) {
-					// If we hit a vertex, make sure we can pass through it without intersecting its polygon
-					if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
-						break;
+		if (s->_visibility && vertex_cur->cacheIndex >= 0 && vertex->cacheIndex >= 0) {
+			byte &cached = s->_visibility->visibility[vertex_cur->cacheIndex * s->_visibility->vertexCount + vertex->cacheIndex];
 
-					// This edge won't properly intersect, so we continue
-					continue;
-				}
+			if (cached == kVisibilityUnknown)
+				cached = vertex_visible(s, vertex_cur, vertex) ? kVisibilityVisible : kVisibilityBlocked;
 
-				if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
-					break;
-			}
+			visible = (cached == kVisibilityVisible);
+		} else {
+			visible = vertex_visible(s, vertex_cur, vertex);
 		}
 
-		if (j == s->vertices)
+		if (visible)
 			visVerts->push_front(vertex);
 	}
 
@@ -1326,6 +1427,32 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 		}
 	}
 
+	// Look up the visibility graph for the polygons we ended up with. This
+	// has to happen before the start and end points are merged in, as those
+	// differ between calls.
+	if (!s->_avoidPathCache)
+		s->_avoidPathCache = new AvoidPathCache();
+
+	Common::Array<int16> cacheKey;
+	int cacheIndex = 0;
+
+	for (PolygonList::iterator it = pf_s->polygons.begin(); it != pf_s->polygons.end(); ++it) {
+		polygon = *it;
+		Vertex *vertex;
+
+		cacheKey.push_back(polygon->type);
+		cacheKey.push_back(polygon->vertices.size());
+
+		CLIST_FOREACH(vertex, &polygon->vertices) {
+			cacheKey.push_back(vertex->v.x);
+			cacheKey.push_back(vertex->v.y);
+			vertex->cacheIndex = cacheIndex++;
+		}
+	}
+
+	if (cacheIndex <= MAX_CACHED_VERTICES)
+		pf_s->_visibility = s->_avoidPathCache->lookup(cacheKey, cacheIndex);
+
 	// Merge start and end points into polygon set
 	pf_s->vertex_start = merge_point(pf_s, *new_start);
 	pf_s->vertex_end = merge_point(pf_s, *new_end);
@@ -1333,6 +1460,13 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 	delete new_start;
 	delete new_end;
 
+	// Start and end points normally become single-vertex polygons, which
+	// don't block any lines of sight. If one of them splits an edge instead,
+	// the polygons no longer match the cached graph.
+	if ((pf_s->vertex_start->cacheIndex < 0 && VERTEX_HAS_EDGES(pf_s->vertex_start)) ||
+		(pf_s->vertex_end->cacheIndex < 0 && VERTEX_HAS_EDGES(pf_s->vertex_end)))
+		pf_s->_visibility = nullptr;
+
 	// Allocate and build vertex index
 	pf_s->vertex_index = (Vertex**)malloc(sizeof(Vertex *) * (count + 2));
 
@@ -266,6 +266,12 @@ public:
 	bool isClass() const { return (getInfoSelector().getOffset() & kInfoFlagClass); }
 	const Object *getClass(SegManager *segMan) const;
 
+	/**
+	 * Returns the object's data in the script it was instantiated from.
+	 * Clones share this with the object they were cloned from.
+	 */
+	const byte *getBaseObjectData() const { return _baseObj.data(); }
+
 	void markAsFreed() { _isFreed = true; }
 	bool isFreed() const { return _isFreed; }
 
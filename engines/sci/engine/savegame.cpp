@@ -336,6 +336,9 @@ void SegManager::saveLoadWithSerializer(Common::Serializer &s) {
 #endif
 			}
 		}
+
+		// Forget about any lookups made while the objects were incomplete
+		flushSelectorCache();
 	}
 }
 
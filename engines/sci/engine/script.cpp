@@ -74,6 +74,32 @@ void Script::freeScript(const bool keepLocalsSegment) {
 	_offsetLookupObjectCount = 0;
 	_offsetLookupStringCount = 0;
 	_offsetLookupSaidCount = 0;
+
+	_instructions.clear();
+	_instructionIndex.clear();
+}
+
+const PMachineInstruction &Script::getInstruction(uint32 offset) {
+	if (_instructionIndex.empty())
+		_instructionIndex.resize(_buf->size(), 0);
+
+	const uint16 index = _instructionIndex[offset];
+	if (index)
+		return _instructions[index - 1];
+
+	PMachineInstruction instruction;
+	instruction.size = readPMachineInstruction(getBuf(offset), instruction.extOpcode, instruction.opparams);
+
+	// Huge SCI3 scripts may contain more instructions than the index can
+	// refer to; the remaining ones are decoded every time they are run
+	if (_instructions.size() >= 0xFFFF) {
+		_uncachedInstruction = instruction;
+		return _uncachedInstruction;
+	}
+
+	_instructions.push_back(instruction);
+	_instructionIndex[offset] = _instructions.size();
+	return _instructions.back();
 }
 
 enum {
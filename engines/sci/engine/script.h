@@ -68,6 +68,15 @@ struct offsetLookupArrayEntry {
 
 typedef Common::Array<offsetLookupArrayEntry> offsetLookupArrayType;
 
+/**
+ * A p-machine instruction in decoded form, see Script::getInstruction().
+ */
+struct PMachineInstruction {
+	int16 opparams[4]; ///< Operands, already sign-extended and in host byte order
+	uint16 size;       ///< Size of the encoded instruction in bytes
+	byte extOpcode;    ///< Opcode, with the lower bit selecting byte operands
+};
+
 class Script : public SegmentObj {
 private:
 	int _nr; /**< Script number */
@@ -101,6 +110,17 @@ private:
 	uint16 _offsetLookupStringCount;
 	uint16 _offsetLookupSaidCount;
 
+	/**
+	 * Instructions of this script which have been run so far, in decoded
+	 * form. Script code does not change anymore once the script has been
+	 * instantiated, so every instruction only needs to be decoded once.
+	 */
+	Common::Array<PMachineInstruction> _instructions;
+	/** For each offset of the buffer, 1-based index into _instructions, or 0 if not decoded yet */
+	Common::Array<uint16> _instructionIndex;
+	/** Holds the last decoded instruction once _instructionIndex has run out of indices */
+	PMachineInstruction _uncachedInstruction;
+
 public:
 	int getLocalsOffset() const { return _localsOffset; }
 	uint16 getLocalsCount() const { return _localsCount; }
@@ -126,6 +146,12 @@ public:
 	ObjMap &getObjectMap() { return _objects; }
 	const ObjMap &getObjectMap() const { return _objects; }
 
+	/**
+	 * Returns the instruction at the given offset of the script buffer in
+	 * decoded form. The returned reference is only valid until the next call.
+	 */
+	const PMachineInstruction &getInstruction(uint32 offset);
+
 	// speed optimization: inline due to frequent calling
 	bool offsetIsObject(uint32 offset) const {
 		return _buf->getUint16SEAt(offset + SCRIPT_OBJECT_MAGIC_OFFSET) == SCRIPT_OBJECT_MAGIC_NUMBER;
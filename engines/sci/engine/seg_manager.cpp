@@ -39,6 +39,10 @@ SegManager::SegManager(ResourceManager *resMan, ScriptPatcher *scriptPatcher)
 	_nodesSegId = 0;
 	_hunksSegId = 0;
 
+	_gcPhase = kGCIdle;
+
+	flushSelectorCache();
+
 	_saveDirPtr = NULL_REG;
 	_parserPtr = NULL_REG;
 
@@ -79,6 +83,21 @@ void SegManager::resetSegMan() {
 	// Reinitialize class table
 	_classTable.clear();
 	createClassTable();
+
+	// Any incremental garbage collection in progress is void now
+	setGCPhase(kGCIdle);
+}
+
+void SegManager::flushSelectorCache() {
+	for (uint i = 0; i < kSelectorCacheSize; i++)
+		_selectorCache[i].objectData = nullptr;
+}
+
+void SegManager::setGCPhase(GCPhase phase) {
+	_gcPhase = phase;
+	// Keep the storage of both lists around for the next collection
+	_gcGreyList.resize(0);
+	_gcAllocations.resize(0);
 }
 
 void SegManager::initSysStrings() {
@@ -165,6 +184,7 @@ void SegManager::deallocate(SegmentId seg) {
 	if (mobj->getType() == SEG_TYPE_SCRIPT) {
 		Script *scr = (Script *)mobj;
 		_scriptSegMap.erase(scr->getScriptNumber());
+		flushSelectorCache();
 		if (scr->getLocalsSegment()) {
 			// Check if the locals segment has already been deallocated.
 			// If the locals block has been stored in a segment with an ID
@@ -461,6 +481,7 @@ reg_t SegManager::allocateHunkEntry(const char *hunk_type, int size) {
 	int offset = table->allocEntry();
 
 	reg_t addr = make_reg(_hunksSegId, offset);
+	trackAllocation(addr);
 	Hunk &h = table->at(offset);
 
 	h.mem = malloc(size);
@@ -494,6 +515,7 @@ Clone *SegManager::allocateClone(reg_t *addr) {
 	int offset = table->allocEntry();
 
 	*addr = make_reg(_clonesSegId, offset);
+	trackAllocation(*addr);
 	return &table->at(offset);
 }
 
@@ -510,6 +532,7 @@ List *SegManager::allocateList(reg_t *addr) {
 	int offset = table->allocEntry();
 
 	*addr = make_reg(_listsSegId, offset);
+	trackAllocation(*addr);
 	return &table->at(offset);
 }
 
@@ -526,6 +549,7 @@ Node *SegManager::allocateNode(reg_t *addr) {
 	int offset = table->allocEntry();
 
 	*addr = make_reg(_nodesSegId, offset);
+	trackAllocation(*addr);
 	return &table->at(offset);
 }
 
@@ -909,6 +933,7 @@ byte *SegManager::allocDynmem(int size, const char *descr, reg_t *addr) {
 	DynMem *dynmem = new DynMem();
 	SegmentId segid = allocSegment(dynmem);
 	*addr = make_reg(segid, 0);
+	trackAllocation(*addr);
 
 	dynmem->_size = size;
 
@@ -952,6 +977,7 @@ SciArray *SegManager::allocateArray(SciArrayType type, uint16 size, reg_t *addr)
 	int offset = table->allocEntry();
 
 	*addr = make_reg(_arraysSegId, offset);
+	trackAllocation(*addr);
 
 	SciArray *array = &table->at(offset);
 	array->setType(type);
@@ -1008,6 +1034,7 @@ SciBitmap *SegManager::allocateBitmap(reg_t *addr, const int16 width, const int1
 	int offset = table->allocEntry();
 
 	*addr = make_reg(_bitmapSegId, offset);
+	trackAllocation(*addr);
 	SciBitmap &bitmap = table->at(offset);
 
 	bitmap.create(width, height, skipColor, originX, originY, xResolution, yResolution, paletteSize, remap, gc);
@@ -1105,6 +1132,7 @@ int SegManager::instantiateScript(int scriptNum, bool applyScriptPatches) {
 #ifdef ENABLE_SCI32
 	g_sci->_guestAdditions->instantiateScriptHook(*scr);
 #endif
+	flushSelectorCache();
 
 	return segmentId;
 }
@@ -460,7 +460,83 @@ public:
 
 	const Common::Array<SegmentObj *> &getSegments() const { return _heap; }
 
+	// Incremental garbage collection
+
+	enum GCPhase {
+		kGCIdle,     ///< No incremental collection in progress
+		kGCMarking,  ///< Reachable objects are being marked
+		kGCSweeping  ///< Unmarked objects are being freed
+	};
+
+	GCPhase getGCPhase() const { return _gcPhase; }
+
+	/**
+	 * Switches the phase of the incremental garbage collector, and drops
+	 * the references collected by the write barrier so far.
+	 */
+	void setGCPhase(GCPhase phase);
+
+	/**
+	 * Write barrier of the incremental garbage collector. Must be called
+	 * with every reference that gets stored into a heap object (object
+	 * variables, list nodes, arrays, ...) while the game is running, so that
+	 * objects which only become reachable through an already marked object
+	 * are not freed. The stack and local variables are rescanned by the
+	 * collector instead.
+	 */
+	void writeBarrier(reg_t value) {
+		if (_gcPhase == kGCMarking && value.getSegment())
+			_gcGreyList.push_back(value);
+	}
+
+	/** References stored by the game since the collector last looked. */
+	Common::Array<reg_t> &getGCGreyList() { return _gcGreyList; }
+
+	/** Objects allocated while an incremental collection is in progress. */
+	Common::Array<reg_t> &getGCAllocations() { return _gcAllocations; }
+
+	// Selector lookup cache
+
+	/**
+	 * Result of a selector lookup, as cached by lookupSelector(). Objects
+	 * which share their script data (i.e. an object and its clones) resolve
+	 * selectors the same way, so that data is used as the key.
+	 */
+	struct SelectorCacheEntry {
+		const byte *objectData; ///< Key, nullptr if the entry is unused
+		Selector selector;      ///< Key
+		SelectorType type;
+		int varIndex;           ///< Variable index, for kSelectorVariable
+		reg_t funcAddress;      ///< Method address, for kSelectorMethod
+	};
+
+	SelectorCacheEntry &getSelectorCacheEntry(const byte *objectData, Selector selector) {
+		const uint hash = (uint)((uintptr)objectData >> 1) * 31 + selector;
+		return _selectorCache[hash & (kSelectorCacheSize - 1)];
+	}
+
+	/**
+	 * Drops all cached selector lookups. Called whenever a script is loaded
+	 * or unloaded, as the cache refers to script data.
+	 */
+	void flushSelectorCache();
+
 private:
+	enum {
+		kSelectorCacheSize = 1024 ///< Must be a power of two
+	};
+
+	SelectorCacheEntry _selectorCache[kSelectorCacheSize];
+
+	void trackAllocation(reg_t addr) {
+		if (_gcPhase != kGCIdle)
+			_gcAllocations.push_back(addr);
+	}
+
+	GCPhase _gcPhase;
+	Common::Array<reg_t> _gcGreyList;
+	Common::Array<reg_t> _gcAllocations;
+
 	Common::Array<SegmentObj *> _heap;
 	Common::Array<Class> _classTable; /**< Table of all classes */
 	/** Map script ids to segment ids. */
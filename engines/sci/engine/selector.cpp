@@ -285,6 +285,7 @@ void writeSelector(SegManager *segMan, reg_t object, Selector selectorId, reg_t
 	}
 
 	*address.getPointer(segMan) = value;
+	segMan->writeBarrier(value);
 #ifdef ENABLE_SCI32
 	updateInfoFlagViewVisible(segMan->getObject(object), address.varindex);
 #endif
@@ -323,6 +324,28 @@ void invokeSelector(EngineState *s, reg_t object, int selectorId,
 	run_vm(s); // Start a new vm
 }
 
+static SelectorType resolveSelector(SegManager *segMan, const Object *obj, Selector selectorId, int &varIndex, reg_t &funcAddress) {
+	varIndex = obj->locateVarSelector(segMan, selectorId);
+
+	if (varIndex >= 0) {
+		// Found it as a variable
+		return kSelectorVariable;
+	} else {
+		// Check if it's a method, with recursive lookup in superclasses
+		while (obj) {
+			int index = obj->funcSelectorPosition(selectorId);
+			if (index >= 0) {
+				funcAddress = obj->getFunction(index);
+				return kSelectorMethod;
+			} else {
+				obj = segMan->getObject(obj->getSuperClassSelector());
+			}
+		}
+
+		return kSelectorNone;
+	}
+}
+
 SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector selectorId, ObjVarRef *varp, reg_t *fptr) {
 	const Object *obj = segMan->getObject(obj_location);
 	bool oldScriptHeader = (getSciVersion() == SCI_VERSION_0_EARLY);
@@ -336,31 +359,26 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector sel
 		error("lookupSelector: Attempt to send to non-object or invalid script. Address %04x:%04x", PRINT_REG(obj_location));
 	}
 
-	int index = obj->locateVarSelector(segMan, selectorId);
+	// Walking up the class chain is expensive, so the result is cached
+	const byte *objectData = obj->getBaseObjectData();
+	SegManager::SelectorCacheEntry &entry = segMan->getSelectorCacheEntry(objectData, selectorId);
+	if (entry.objectData != objectData || entry.selector != selectorId || !objectData) {
+		entry.type = resolveSelector(segMan, obj, selectorId, entry.varIndex, entry.funcAddress);
+		entry.objectData = objectData;
+		entry.selector = selectorId;
+	}
 
-	if (index >= 0) {
-		// Found it as a variable
+	if (entry.type == kSelectorVariable) {
 		if (varp) {
 			varp->obj = obj_location;
-			varp->varindex = index;
-		}
-		return kSelectorVariable;
-	} else {
-		// Check if it's a method, with recursive lookup in superclasses
-		while (obj) {
-			index = obj->funcSelectorPosition(selectorId);
-			if (index >= 0) {
-				if (fptr)
-					*fptr = obj->getFunction(index);
-
-				return kSelectorMethod;
-			} else {
-				obj = segMan->getObject(obj->getSuperClassSelector());
-			}
+			varp->varindex = entry.varIndex;
 		}
-
-		return kSelectorNone;
+	} else if (entry.type == kSelectorMethod) {
+		if (fptr)
+			*fptr = entry.funcAddress;
 	}
+
+	return entry.type;
 }
 
 } // End of namespace Sci
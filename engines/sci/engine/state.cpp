@@ -24,6 +24,7 @@
 #include "sci/debug.h"	// for g_debug_sleeptime_factor
 #include "sci/engine/features.h"
 #include "sci/engine/file.h"
+#include "sci/engine/gc.h"
 #include "sci/engine/guest_additions.h"
 #include "sci/engine/kernel.h"
 #include "sci/engine/state.h"
@@ -69,13 +70,17 @@ static const uint16 s_halfWidthSJISMap[256] = {
 EngineState::EngineState(SegManager *segMan) :
 	_segMan(segMan),
 	_msgState(nullptr),
-	_dirseeker() {
+	_dirseeker(),
+	_avoidPathCache(nullptr),
+	_gcState(nullptr) {
 
 	reset(false);
 }
 
 EngineState::~EngineState() {
 	delete _msgState;
+	freeAvoidPathCache();
+	delete _gcState;
 }
 
 void EngineState::reset(bool isRestoring) {
@@ -119,6 +124,7 @@ void EngineState::reset(bool isRestoring) {
 
 	scriptStepCounter = 0;
 	scriptGCInterval = GC_INTERVAL;
+	scriptGCIncremental = false;
 }
 
 void EngineState::speedThrottler(uint32 neededSleep) {
@@ -46,6 +46,8 @@ class FileHandle;
 class DirSeeker;
 class EventManager;
 class MessageState;
+class AvoidPathCache;
+struct GCState;
 class SoundCommandParser;
 class VirtualIndexFile;
 
@@ -137,6 +139,10 @@ struct EngineState : public Common::Serializable {
 
 	uint _chosenQfGImportItem; // Remembers the item selected in QfG import rooms
 
+	// see kpathing.cpp / kAvoidPath
+	AvoidPathCache *_avoidPathCache; // Visibility graphs of recently used polygon sets
+	void freeAvoidPathCache();
+
 	bool _cursorWorkaroundActive; // Refer to GfxCursor::setPosition()
 	int16 _cursorWorkaroundPosCount; // When the cursor is reported to be at the previously set coordinate, we won't disable the workaround unless it happened for this many times
 	Common::Point _cursorWorkaroundPoint;
@@ -172,6 +178,7 @@ struct EngineState : public Common::Serializable {
 
 	int scriptStepCounter; // Counts the number of steps executed
 	int scriptGCInterval; // Number of steps in between gcs
+	bool scriptGCIncremental; // Spread garbage collections over several kernel calls
 
 	uint16 currentRoomNumber() const;
 	void setRoomNumber(uint16 roomNumber);
@@ -188,6 +195,7 @@ struct EngineState : public Common::Serializable {
 	void shrinkStackToBase();
 
 	int gcCountDown; /**< Number of kernel calls until next gc */
+	GCState *_gcState; /**< Incremental garbage collector state, see gc.cpp */
 
 	MessageState *_msgState;
 	void initMessageState();
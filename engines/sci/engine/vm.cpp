@@ -223,6 +223,7 @@ static void _exec_varselectors(EngineState *s) {
 			// varselector access?
 			if (xs.argc) { // write?
 				*var = xs.variables_argp[1];
+				s->_segMan->writeBarrier(*var);
 
 #ifdef ENABLE_SCI32
 				updateInfoFlagViewVisible(s->_segMan->getObject(xs.addr.varp.obj), xs.addr.varp.varindex);
@@ -624,9 +625,11 @@ void run_vm(EngineState *s) {
 			error("run_vm(): program counter gone astray, addr: %d, code buffer size: %d",
 			s->xs->addr.pc.getOffset(), scr->getBufSize());
 
-		// Get opcode
-		byte extOpcode;
-		s->xs->addr.pc.incOffset(readPMachineInstruction(scr->getBuf(s->xs->addr.pc.getOffset()), extOpcode, opparams));
+		// Get opcode, which is only decoded the first time it is run
+		const PMachineInstruction &instruction = scr->getInstruction(s->xs->addr.pc.getOffset());
+		const byte extOpcode = instruction.extOpcode;
+		memcpy(opparams, instruction.opparams, sizeof(opparams));
+		s->xs->addr.pc.incOffset(instruction.size);
 		const byte opcode = extOpcode >> 1;
 		//debug("%s: %d, %d, %d, %d, acc = %04x:%04x, script %d, local script %d", opcodeNames[opcode], opparams[0], opparams[1], opparams[2], opparams[3], PRINT_REG(s->r_acc), scr->getScriptNumber(), local_script->getScriptNumber());
 
@@ -852,9 +855,15 @@ void run_vm(EngineState *s) {
 
 		case op_callk: { // 0x21 (33)
 			// Run the garbage collector, if needed
-			if (s->gcCountDown-- <= 0) {
+			if (s->_segMan->getGCPhase() != SegManager::kGCIdle) {
+				// Continue the incremental collection in progress
+				run_gc_step(s);
+			} else if (s->gcCountDown-- <= 0) {
 				s->gcCountDown = s->scriptGCInterval;
-				run_gc(s);
+				if (s->scriptGCIncremental)
+					run_gc_step(s);
+				else
+					run_gc(s);
 			}
 
 			// Call kernel function
@@ -935,6 +944,7 @@ void run_vm(EngineState *s) {
 					reg_t *var = old_xs->getVarPointer(s->_segMan);
 					if (old_xs->argc) { // write?
 						*var = old_xs->variables_argp[1];
+						s->_segMan->writeBarrier(*var);
 
 #ifdef ENABLE_SCI32
 						updateInfoFlagViewVisible(s->_segMan->getObject(old_xs->addr.varp.obj), old_xs->addr.varp.varindex);
@@ -1121,6 +1131,7 @@ void run_vm(EngineState *s) {
 			}
 
 			opProperty = s->r_acc;
+			s->_segMan->writeBarrier(opProperty);
 #ifdef ENABLE_SCI32
 			updateInfoFlagViewVisible(obj, opparams[0], true);
 #endif
@@ -1151,6 +1162,7 @@ void run_vm(EngineState *s) {
 				                    s->_segMan, BREAK_SELECTORWRITE);
 			}
 			opProperty = newValue;
+			s->_segMan->writeBarrier(opProperty);
 #ifdef ENABLE_SCI32
 			updateInfoFlagViewVisible(obj, opparams[0], true);
 #endif
@@ -1177,6 +1189,7 @@ void run_vm(EngineState *s) {
 				opProperty += 1;
 			else
 				opProperty -= 1;
+			s->_segMan->writeBarrier(opProperty);
 
 			if (g_sci->_debugState._activeBreakpointTypes & BREAK_SELECTORWRITE) {
 				debugPropertyAccess(obj, s->xs->objp, opparams[0], NULL_SELECTOR,
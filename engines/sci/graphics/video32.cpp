@@ -71,6 +71,10 @@ bool VideoPlayer::open(const Common::Path &fileName) {
 	}
 #endif
 
+	// Decode a few frames ahead on a worker thread where the decoder allows
+	// it, so that slow frames do not stall the playback loop
+	_decoder->setReadAhead(4);
+
 	return true;
 }
 
@@ -454,10 +454,18 @@ Common::Rect Font::getBoundingBox(const Common::U32String &input, int x, int y,
 }
 
 int Font::getStringWidth(const Common::String &str) const {
-	return getStringWidthImpl(*this, str);
+	return measureString(str);
 }
 
 int Font::getStringWidth(const Common::U32String &str) const {
+	return measureString(str);
+}
+
+int Font::measureString(const Common::String &str) const {
+	return getStringWidthImpl(*this, str);
+}
+
+int Font::measureString(const Common::U32String &str) const {
 	return getStringWidthImpl(*this, str);
 }
 
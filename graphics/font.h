@@ -300,6 +300,16 @@ public:
 	 */
 	void scaleSingleGlyph(Surface *scaleSurface, int *grayScaleMap, int grayScaleMapSize, int width, int height, int xOffset, int yOffset, int grayLevel, int chr, int srcheight, int srcwidth, float scale) const;
 
+protected:
+	/**
+	 * Compute the width of a string for getStringWidth, by adding up the
+	 * character widths and kerning offsets.
+	 *
+	 * Fonts for which this is costly can override it to cache the results.
+	 */
+	virtual int measureString(const Common::String &str) const;
+	/** @overload */
+	virtual int measureString(const Common::U32String &str) const;
 };
 /** @} */
 } // End of namespace Graphics
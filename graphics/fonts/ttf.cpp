@@ -38,6 +38,7 @@
 #include "common/stream.h"
 #include "common/memstream.h"
 #include "common/hashmap.h"
+#include "common/hash-str.h"
 #include "common/ptr.h"
 #include "common/compression/unzip.h"
 
@@ -180,6 +181,10 @@ public:
 	void drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) const override;
 	void drawChar(ManagedSurface *dst, uint32 chr, int x, int y, uint32 color) const override;
 
+protected:
+	int measureString(const Common::String &str) const override;
+	int measureString(const Common::U32String &str) const override;
+
 private:
 	bool _initialized;
 	FT_StreamRec_ _stream;
@@ -204,6 +209,33 @@ private:
 	bool _allowLateCaching;
 	void assureCached(uint32 chr) const;
 
+	// Glyph images do not own their pixels, they point into atlas pages
+	// which are filled row by row as glyphs get cached.
+	enum {
+		kAtlasPageSize = 256
+	};
+	mutable Common::Array<Surface *> _atlasPages;
+	mutable Surface *_atlasPage;
+	mutable int _atlasX, _atlasY, _atlasRowHeight;
+	void allocateGlyphImage(Surface &image, int w, int h) const;
+
+	// FT_Get_Kerning is comparatively slow, so remember the offsets of
+	// the character pairs we have seen.
+	struct KerningPairHash {
+		uint operator()(uint64 pair) const {
+			return (uint)(pair >> 32) * 31 + (uint)pair;
+		}
+	};
+	typedef Common::HashMap<uint64, int, KerningPairHash> KerningCache;
+	mutable KerningCache _kerningCache;
+
+	// Widths of recently measured strings. Text is usually measured many
+	// times while it is laid out and drawn, e.g. by the GUI on each redraw.
+	typedef Common::HashMap<Common::String, int> StringWidthCache;
+	typedef Common::HashMap<Common::U32String, int> U32StringWidthCache;
+	mutable StringWidthCache _stringWidths;
+	mutable U32StringWidthCache _u32StringWidths;
+
 	Common::SeekableReadStream *readTTFTable(FT_ULong tag) const;
 
 	int computePointSize(int size, TTFSizeMode sizeMode) const;
@@ -224,7 +256,8 @@ TTFFont::TTFFont()
 	: _initialized(false), _stream(), _face(), _ttfFile(0), _width(0), _height(0), _ascent(0),
 	  _descent(0), _glyphs(), _loadFlags(FT_LOAD_TARGET_NORMAL), _renderMode(FT_RENDER_MODE_NORMAL),
 	  _hasKerning(false), _allowLateCaching(false), _fakeBold(false), _fakeItalic(false),
-	  _disposeAfterUse(DisposeAfterUse::NO) {
+	  _disposeAfterUse(DisposeAfterUse::NO), _atlasPage(nullptr), _atlasX(0), _atlasY(0),
+	  _atlasRowHeight(0) {
 }
 
 TTFFont::~TTFFont() {
@@ -235,11 +268,13 @@ TTFFont::~TTFFont() {
 			delete _ttfFile;
 		_ttfFile = 0;
 
-		for (GlyphCache::iterator i = _glyphs.begin(), end = _glyphs.end(); i != end; ++i)
-			i->_value.image.free();
-
 		_initialized = false;
 	}
+
+	for (uint i = 0; i < _atlasPages.size(); ++i) {
+		_atlasPages[i]->free();
+		delete _atlasPages[i];
+	}
 }
 
 
@@ -581,9 +616,43 @@ int TTFFont::getKerningOffset(uint32 left, uint32 right) const {
 	if (!leftGlyph || !rightGlyph)
 		return 0;
 
+	const uint64 pair = ((uint64)leftGlyph << 32) | rightGlyph;
+	KerningCache::const_iterator kerningEntry = _kerningCache.find(pair);
+	if (kerningEntry != _kerningCache.end())
+		return kerningEntry->_value;
+
 	FT_Vector kerningVector;
 	FT_Get_Kerning(_face, leftGlyph, rightGlyph, FT_KERNING_DEFAULT, &kerningVector);
-	return (kerningVector.x / 64);
+	const int offset = kerningVector.x / 64;
+
+	if (_kerningCache.size() >= 4096)
+		_kerningCache.clear();
+	_kerningCache[pair] = offset;
+	return offset;
+}
+
+int TTFFont::measureString(const Common::String &str) const {
+	StringWidthCache::const_iterator widthEntry = _stringWidths.find(str);
+	if (widthEntry != _stringWidths.end())
+		return widthEntry->_value;
+
+	const int width = Font::measureString(str);
+	if (_stringWidths.size() >= 512)
+		_stringWidths.clear();
+	_stringWidths[str] = width;
+	return width;
+}
+
+int TTFFont::measureString(const Common::U32String &str) const {
+	U32StringWidthCache::const_iterator widthEntry = _u32StringWidths.find(str);
+	if (widthEntry != _u32StringWidths.end())
+		return widthEntry->_value;
+
+	const int width = Font::measureString(str);
+	if (_u32StringWidths.size() >= 512)
+		_u32StringWidths.clear();
+	_u32StringWidths[str] = width;
+	return width;
 }
 
 Common::Rect TTFFont::getBoundingBox(uint32 chr) const {
@@ -806,7 +875,7 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	}
 
 
-	glyph.image.create(bitmap->width, bitmap->rows, PixelFormat::createFormatCLUT8());
+	allocateGlyphImage(glyph.image, bitmap->width, bitmap->rows);
 
 	const uint8 *src = bitmap->buffer;
 	int srcPitch = bitmap->pitch;
@@ -821,6 +890,7 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	case FT_PIXEL_MODE_MONO:
 		for (int y = 0; y < (int)bitmap->rows; ++y) {
 			const uint8 *curSrc = src;
+			uint8 *curDst = dst;
 			uint8 mask = 0;
 
 			for (int x = 0; x < (int)bitmap->width; ++x) {
@@ -828,12 +898,13 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 					mask = *curSrc++;
 
 				if (mask & 0x80)
-					*dst = 255;
+					*curDst = 255;
 
 				mask <<= 1;
-				++dst;
+				++curDst;
 			}
 
+			dst += glyph.image.pitch;
 			src += srcPitch;
 		}
 		break;
@@ -848,7 +919,7 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 
 	default:
 		warning("TTFFont::cacheGlyph: Unsupported pixel mode %d", bitmap->pixel_mode);
-		glyph.image.free();
+		glyph.image = Surface();
 		return false;
 	}
 
@@ -861,6 +932,41 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	return true;
 }
 
+void TTFFont::allocateGlyphImage(Surface &image, int w, int h) const {
+	const PixelFormat format = PixelFormat::createFormatCLUT8();
+
+	if (!w || !h) {
+		image.init(w, h, w, nullptr, format);
+		return;
+	}
+
+	// Glyphs which do not fit into a regular page get one of their own
+	if (w > kAtlasPageSize || h > kAtlasPageSize) {
+		Surface *page = new Surface();
+		page->create(w, h, format);
+		_atlasPages.push_back(page);
+		image.init(w, h, page->pitch, page->getPixels(), format);
+		return;
+	}
+
+	if (_atlasX + w > kAtlasPageSize) {
+		_atlasX = 0;
+		_atlasY += _atlasRowHeight;
+		_atlasRowHeight = 0;
+	}
+
+	if (!_atlasPage || _atlasY + h > kAtlasPageSize) {
+		_atlasPage = new Surface();
+		_atlasPage->create(kAtlasPageSize, kAtlasPageSize, format);
+		_atlasPages.push_back(_atlasPage);
+		_atlasX = _atlasY = _atlasRowHeight = 0;
+	}
+
+	image.init(w, h, _atlasPage->pitch, _atlasPage->getBasePtr(_atlasX, _atlasY), format);
+	_atlasX += w;
+	_atlasRowHeight = MAX(_atlasRowHeight, h);
+}
+
 void TTFFont::assureCached(uint32 chr) const {
 	if (!chr || !_allowLateCaching || _glyphs.contains(chr)) {
 		return;
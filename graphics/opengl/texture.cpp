@@ -191,27 +191,25 @@ void Texture::updateArea(const Common::Rect &area, const Graphics::Surface &src)
 	// Set the texture on the active texture unit.
 	bind();
 
-	// Update the actual texture.
-	// Although we have the area of the texture buffer we want to update we
-	// cannot take advantage of the left/right boundaries here because it is
-	// not possible to specify a pitch to glTexSubImage2D. To be precise, with
-	// plain OpenGL we could set GL_UNPACK_ROW_LENGTH to achieve this. However,
-	// OpenGL ES 1.0 does not support GL_UNPACK_ROW_LENGTH. Thus, we are left
-	// with the following options:
-	//
-	// 1) (As we do right now) Simply always update the whole texture lines of
-	//    rect changed. This is simplest to implement. In case performance is
-	//    really an issue we can think of switching to another method.
-	//
-	// 2) Copy the dirty rect to a temporary buffer and upload that by using
-	//    glTexSubImage2D. This is what the Android backend does. It is more
-	//    complicated though.
-	//
-	// 3) Use glTexSubImage2D per line changed. This is what the old OpenGL
-	//    graphics manager did but it is much slower! Thus, we do not use it.
 	GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
-	GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, area.top, src.w, area.height(),
-	                       _glFormat, _glType, src.getBasePtr(0, area.top)));
+
+	// Update the actual texture.
+	// When GL_UNPACK_ROW_LENGTH is available we can specify the pitch of the
+	// source data and upload exactly the area requested. Otherwise, e.g. on
+	// OpenGL ES 1.0 and 2.0 without GL_EXT_unpack_subimage, we update the
+	// whole texture lines of the changed area. The alternatives would be to
+	// copy the area to a temporary buffer, which is what the Android backend
+	// does, or to call glTexSubImage2D per line, which is what the old OpenGL
+	// graphics manager did but it is much slower!
+	if (OpenGLContext.unpackSubImageSupported && src.pitch % src.format.bytesPerPixel == 0) {
+		GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, src.pitch / src.format.bytesPerPixel));
+		GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, area.left, area.top, area.width(), area.height(),
+		                       _glFormat, _glType, src.getBasePtr(area.left, area.top)));
+		GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+	} else {
+		GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, area.top, src.w, area.height(),
+		                       _glFormat, _glType, src.getBasePtr(0, area.top)));
+	}
 }
 
 } // End of namespace OpenGL
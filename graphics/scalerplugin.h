@@ -199,6 +199,13 @@ public:
 	 */
 	virtual bool useOldSource() const { return false; }
 
+	/**
+	 * Whether separate areas can be scaled at the same time by several
+	 * threads sharing one scaler instance. Scalers which keep state between
+	 * calls, like the ones using the old source, must return false.
+	 */
+	virtual bool canScaleInParallel() const { return !useOldSource(); }
+
 protected:
 	Common::Array<uint> _factors;
 };
@@ -56,6 +56,9 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 	_currentTexture = nullptr;
 
 	_clippingEnabled = false;
+
+	if (!depthSpanFunc)
+		selectSpanFuncs();
 }
 
 FrameBuffer::~FrameBuffer() {
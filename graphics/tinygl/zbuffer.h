@@ -360,7 +360,7 @@ private:
 	void putPixelNoTexture(int fbOffset, uint *pz, byte *ps, int _a,
 	                       int x, int y, uint &z, uint &r, uint &g, uint &b, uint &a,
 	                       int &dzdx, int &drdx, int &dgdx, int &dbdx, uint dadx,
-	                       uint &fog, int fog_r, int fog_g, int fog_b, int &dfdx);
+	                       uint &fog, int fog_r, int fog_g, int fog_b, int &dfdx, bool visible = true);
 
 	template <bool kDepthWrite, bool kLightsMode, bool kSmoothMode, bool kFogMode, bool kEnableAlphaTest, bool kEnableScissor, bool kEnableBlending, bool kStencilEnabled, bool kDepthTestEnabled>
 	void putPixelTexture(int fbOffset, const TexelBuffer *texture,
@@ -368,7 +368,7 @@ private:
 	                     int x, int y, uint &z, int &t, int &s,
 	                     uint &r, uint &g, uint &b, uint &a,
 	                     int &dzdx, int &dsdx, int &dtdx, int &drdx, int &dgdx, int &dbdx, uint dadx,
-	                     uint &fog, int fog_r, int fog_g, int fog_b, int &dfdx);
+	                     uint &fog, int fog_r, int fog_g, int fog_b, int &dfdx, bool visible = true);
 
 	template <bool kDepthWrite, bool kEnableScissor, bool kStencilEnabled, bool StippleEnabled, bool kDepthTestEnabled>
 	void putPixelDepth(uint *pz, byte *ps, int _a, int x, int y, uint &z, int &dzdx);
@@ -391,6 +391,32 @@ private:
 		return !_clipRectangle.contains(x, y);
 	}
 
+	// Narrow the span [first, last) of pixels starting at (x, y) to the ones inside the scissor.
+	FORCEINLINE void scissorSpan(int x, int y, int &first, int &last) {
+		if (y < _clipRectangle.top || y >= _clipRectangle.bottom) {
+			last = first;
+			return;
+		}
+		first = MAX<int>(first, _clipRectangle.left - x);
+		last = MIN<int>(last, _clipRectangle.right - x);
+	}
+
+	// Mask of the count (at most 32) pixels starting at (x, y) which are inside the scissor.
+	FORCEINLINE uint32 scissorSpanMask(int x, int y, int count) {
+		int first = 0, last = count;
+		scissorSpan(x, y, first, last);
+		if (first >= last)
+			return 0;
+		const uint32 lastMask = last >= 32 ? 0xffffffff : ((uint32)1 << last) - 1;
+		return lastMask & ~(((uint32)1 << first) - 1);
+	}
+
+	// Mask of the count (at most 32) pixels starting at (x, y) which pass the depth and scissor tests, without writing.
+	FORCEINLINE uint32 visibleSpanMask(uint *pz, int x, int y, uint z, int dzdx, int count, bool enableScissor) {
+		const uint32 mask = depthSpanFunc(pz, z, dzdx, count, _depthFunc, false);
+		return enableScissor ? mask & scissorSpanMask(x, y, count) : mask;
+	}
+
 public:
 
 	FORCEINLINE void writePixel(int pixel, byte aSrc, byte rSrc, byte gSrc, byte bSrc) {
@@ -751,6 +777,27 @@ public:
 	void fillLine(ZBufferPoint *p1, ZBufferPoint *p2);
 	void fillLineZ(ZBufferPoint *p1, ZBufferPoint *p2);
 
+	/**
+	 * Depth test a span of up to 32 pixels starting at pz, the source depth
+	 * being z for the first pixel and advancing by dzdx for each following one.
+	 * The source depth is stored for passing pixels when depthWrite is set.
+	 * Returns a mask with bit i set when pixel i passed the depth test.
+	 */
+	typedef uint32 (*DepthSpanFunc)(uint *pz, uint z, int dzdx, int count, int depthFunc, bool depthWrite);
+	static DepthSpanFunc depthSpanFunc;
+	static void selectSpanFuncs();
+
+	static uint32 depthSpanGeneric(uint *pz, uint z, int dzdx, int count, int depthFunc, bool depthWrite);
+#ifdef SCUMMVM_NEON
+	static uint32 depthSpanNEON(uint *pz, uint z, int dzdx, int count, int depthFunc, bool depthWrite);
+#endif
+#ifdef SCUMMVM_SSE2
+	static uint32 depthSpanSSE2(uint *pz, uint z, int dzdx, int count, int depthFunc, bool depthWrite);
+#endif
+#ifdef SCUMMVM_AVX2
+	static uint32 depthSpanAVX2(uint *pz, uint z, int dzdx, int count, int depthFunc, bool depthWrite);
+#endif
+
 private:
 
 	void fillLineFlatZ(ZBufferPoint *p1, ZBufferPoint *p2);
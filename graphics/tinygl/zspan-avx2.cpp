@@ -0,0 +1,114 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/tinygl/zbuffer.h"
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace TinyGL {
+
+// AVX2 only has signed comparisons, so the depth values are biased first.
+static FORCEINLINE __m256i avx2_cmpgt_epu32(__m256i a, __m256i b) {
+	const __m256i bias = _mm256_set1_epi32((int)0x80000000);
+	return _mm256_cmpgt_epi32(_mm256_xor_si256(a, bias), _mm256_xor_si256(b, bias));
+}
+
+template <int kDepthFunc>
+static FORCEINLINE __m256i avx2_depthTest(__m256i zSrc, __m256i zDst) {
+	switch (kDepthFunc) {
+	case TGL_LESS:
+		return avx2_cmpgt_epu32(zSrc, zDst);
+	case TGL_EQUAL:
+		return _mm256_cmpeq_epi32(zDst, zSrc);
+	case TGL_LEQUAL:
+		return _mm256_xor_si256(avx2_cmpgt_epu32(zDst, zSrc), _mm256_set1_epi32(-1));
+	case TGL_GREATER:
+		return avx2_cmpgt_epu32(zDst, zSrc);
+	case TGL_NOTEQUAL:
+		return _mm256_xor_si256(_mm256_cmpeq_epi32(zDst, zSrc), _mm256_set1_epi32(-1));
+	case TGL_GEQUAL:
+		return _mm256_xor_si256(avx2_cmpgt_epu32(zSrc, zDst), _mm256_set1_epi32(-1));
+	default:
+		return _mm256_set1_epi32(-1);
+	}
+}
+
+template <int kDepthFunc>
+static uint32 depthSpanAVX2(uint *pz, uint z, int dzdx, int count, bool depthWrite) {
+	uint32 mask = 0;
+	int i = 0;
+
+	// Depth values wrap around like the scalar rasterizer does.
+	const uint step = (uint)dzdx;
+	__m256i zSrc = _mm256_add_epi32(_mm256_set1_epi32(z),
+	                                _mm256_set_epi32(7 * step, 6 * step, 5 * step, 4 * step, 3 * step, 2 * step, step, 0));
+	const __m256i zStep = _mm256_set1_epi32(8 * step);
+	for (; i + 8 <= count; i += 8) {
+		__m256i zDst = _mm256_loadu_si256((const __m256i *)(pz + i));
+		__m256i pass = avx2_depthTest<kDepthFunc>(zSrc, zDst);
+		if (depthWrite) {
+			zDst = _mm256_blendv_epi8(zDst, zSrc, pass);
+			_mm256_storeu_si256((__m256i *)(pz + i), zDst);
+		}
+		mask |= (uint32)_mm256_movemask_ps(_mm256_castsi256_ps(pass)) << i;
+		zSrc = _mm256_add_epi32(zSrc, zStep);
+	}
+
+	if (i < count)
+		mask |= FrameBuffer::depthSpanGeneric(pz + i, z + i * step, dzdx, count - i, kDepthFunc, depthWrite) << i;
+	return mask;
+}
+
+uint32 FrameBuffer::depthSpanAVX2(uint *pz, uint z, int dzdx, int count, int depthFunc, bool depthWrite) {
+	switch (depthFunc) {
+	case TGL_LESS:
+		return TinyGL::depthSpanAVX2<TGL_LESS>(pz, z, dzdx, count, depthWrite);
+	case TGL_EQUAL:
+		return TinyGL::depthSpanAVX2<TGL_EQUAL>(pz, z, dzdx, count, depthWrite);
+	case TGL_LEQUAL:
+		return TinyGL::depthSpanAVX2<TGL_LEQUAL>(pz, z, dzdx, count, depthWrite);
+	case TGL_GREATER:
+		return TinyGL::depthSpanAVX2<TGL_GREATER>(pz, z, dzdx, count, depthWrite);
+	case TGL_NOTEQUAL:
+		return TinyGL::depthSpanAVX2<TGL_NOTEQUAL>(pz, z, dzdx, count, depthWrite);
+	case TGL_GEQUAL:
+		return TinyGL::depthSpanAVX2<TGL_GEQUAL>(pz, z, dzdx, count, depthWrite);
+	default:
+		return depthSpanGeneric(pz, z, dzdx, count, depthFunc, depthWrite);
+	}
+}
+
+} // end of namespace TinyGL
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
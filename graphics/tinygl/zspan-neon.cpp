@@ -0,0 +1,123 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "graphics/tinygl/zbuffer.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+namespace TinyGL {
+
+template <int kDepthFunc>
+static FORCEINLINE uint32x4_t neon_depthTest(uint32x4_t zSrc, uint32x4_t zDst) {
+	switch (kDepthFunc) {
+	case TGL_LESS:
+		return vcltq_u32(zDst, zSrc);
+	case TGL_EQUAL:
+		return vceqq_u32(zDst, zSrc);
+	case TGL_LEQUAL:
+		return vcleq_u32(zDst, zSrc);
+	case TGL_GREATER:
+		return vcgtq_u32(zDst, zSrc);
+	case TGL_NOTEQUAL:
+		return vmvnq_u32(vceqq_u32(zDst, zSrc));
+	case TGL_GEQUAL:
+		return vcgeq_u32(zDst, zSrc);
+	default:
+		return vdupq_n_u32(0xffffffff);
+	}
+}
+
+template <int kDepthFunc>
+static uint32 depthSpanNEON(uint *pz, uint z, int dzdx, int count, bool depthWrite) {
+	static const uint32 laneIndex[4] = { 0, 1, 2, 3 };
+	static const uint32 laneBits[4] = { 1, 2, 4, 8 };
+	uint32 mask = 0;
+	int i = 0;
+
+	// Depth values wrap around like the scalar rasterizer does.
+	const uint step = (uint)dzdx;
+	uint32x4_t zSrc = vmlaq_n_u32(vdupq_n_u32(z), vld1q_u32(laneIndex), step);
+	const uint32x4_t zStep = vdupq_n_u32(4 * step);
+	const uint32x4_t bits = vld1q_u32(laneBits);
+	for (; i + 4 <= count; i += 4) {
+		uint32x4_t zDst = vld1q_u32(pz + i);
+		uint32x4_t pass = neon_depthTest<kDepthFunc>(zSrc, zDst);
+		if (depthWrite) {
+			vst1q_u32(pz + i, vbslq_u32(pass, zSrc, zDst));
+		}
+		uint32x4_t passBits = vandq_u32(pass, bits);
+		uint32x2_t sum = vadd_u32(vget_low_u32(passBits), vget_high_u32(passBits));
+		mask |= vget_lane_u32(vpadd_u32(sum, sum), 0) << i;
+		zSrc = vaddq_u32(zSrc, zStep);
+	}
+
+	if (i < count)
+		mask |= FrameBuffer::depthSpanGeneric(pz + i, z + i * step, dzdx, count - i, kDepthFunc, depthWrite) << i;
+	return mask;
+}
+
+uint32 FrameBuffer::depthSpanNEON(uint *pz, uint z, int dzdx, int count, int depthFunc, bool depthWrite) {
+	switch (depthFunc) {
+	case TGL_LESS:
+		return TinyGL::depthSpanNEON<TGL_LESS>(pz, z, dzdx, count, depthWrite);
+	case TGL_EQUAL:
+		return TinyGL::depthSpanNEON<TGL_EQUAL>(pz, z, dzdx, count, depthWrite);
+	case TGL_LEQUAL:
+		return TinyGL::depthSpanNEON<TGL_LEQUAL>(pz, z, dzdx, count, depthWrite);
+	case TGL_GREATER:
+		return TinyGL::depthSpanNEON<TGL_GREATER>(pz, z, dzdx, count, depthWrite);
+	case TGL_NOTEQUAL:
+		return TinyGL::depthSpanNEON<TGL_NOTEQUAL>(pz, z, dzdx, count, depthWrite);
+	case TGL_GEQUAL:
+		return TinyGL::depthSpanNEON<TGL_GEQUAL>(pz, z, dzdx, count, depthWrite);
+	default:
+		return depthSpanGeneric(pz, z, dzdx, count, depthFunc, depthWrite);
+	}
+}
+
+} // end of namespace TinyGL
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#endif // SCUMMVM_NEON
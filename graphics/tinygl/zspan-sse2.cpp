@@ -0,0 +1,121 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/tinygl/zbuffer.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace TinyGL {
+
+// SSE2 only has signed comparisons, so the depth values are biased first.
+static FORCEINLINE __m128i sse2_cmpgt_epu32(__m128i a, __m128i b) {
+	const __m128i bias = _mm_set1_epi32((int)0x80000000);
+	return _mm_cmpgt_epi32(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+}
+
+template <int kDepthFunc>
+static FORCEINLINE __m128i sse2_depthTest(__m128i zSrc, __m128i zDst) {
+	switch (kDepthFunc) {
+	case TGL_LESS:
+		return sse2_cmpgt_epu32(zSrc, zDst);
+	case TGL_EQUAL:
+		return _mm_cmpeq_epi32(zDst, zSrc);
+	case TGL_LEQUAL:
+		return _mm_xor_si128(sse2_cmpgt_epu32(zDst, zSrc), _mm_set1_epi32(-1));
+	case TGL_GREATER:
+		return sse2_cmpgt_epu32(zDst, zSrc);
+	case TGL_NOTEQUAL:
+		return _mm_xor_si128(_mm_cmpeq_epi32(zDst, zSrc), _mm_set1_epi32(-1));
+	case TGL_GEQUAL:
+		return _mm_xor_si128(sse2_cmpgt_epu32(zSrc, zDst), _mm_set1_epi32(-1));
+	default:
+		return _mm_set1_epi32(-1);
+	}
+}
+
+template <int kDepthFunc>
+static uint32 depthSpanSSE2(uint *pz, uint z, int dzdx, int count, bool depthWrite) {
+	uint32 mask = 0;
+	int i = 0;
+
+	// Depth values wrap around like the scalar rasterizer does.
+	const uint step = (uint)dzdx;
+	__m128i zSrc = _mm_add_epi32(_mm_set1_epi32(z), _mm_set_epi32(3 * step, 2 * step, step, 0));
+	const __m128i zStep = _mm_set1_epi32(4 * step);
+	for (; i + 4 <= count; i += 4) {
+		__m128i zDst = _mm_loadu_si128((const __m128i *)(pz + i));
+		__m128i pass = sse2_depthTest<kDepthFunc>(zSrc, zDst);
+		if (depthWrite) {
+			zDst = _mm_or_si128(_mm_and_si128(pass, zSrc), _mm_andnot_si128(pass, zDst));
+			_mm_storeu_si128((__m128i *)(pz + i), zDst);
+		}
+		mask |= (uint32)_mm_movemask_ps(_mm_castsi128_ps(pass)) << i;
+		zSrc = _mm_add_epi32(zSrc, zStep);
+	}
+
+	if (i < count)
+		mask |= FrameBuffer::depthSpanGeneric(pz + i, z + i * step, dzdx, count - i, kDepthFunc, depthWrite) << i;
+	return mask;
+}
+
+uint32 FrameBuffer::depthSpanSSE2(uint *pz, uint z, int dzdx, int count, int depthFunc, bool depthWrite) {
+	switch (depthFunc) {
+	case TGL_LESS:
+		return TinyGL::depthSpanSSE2<TGL_LESS>(pz, z, dzdx, count, depthWrite);
+	case TGL_EQUAL:
+		return TinyGL::depthSpanSSE2<TGL_EQUAL>(pz, z, dzdx, count, depthWrite);
+	case TGL_LEQUAL:
+		return TinyGL::depthSpanSSE2<TGL_LEQUAL>(pz, z, dzdx, count, depthWrite);
+	case TGL_GREATER:
+		return TinyGL::depthSpanSSE2<TGL_GREATER>(pz, z, dzdx, count, depthWrite);
+	case TGL_NOTEQUAL:
+		return TinyGL::depthSpanSSE2<TGL_NOTEQUAL>(pz, z, dzdx, count, depthWrite);
+	case TGL_GEQUAL:
+		return TinyGL::depthSpanSSE2<TGL_GEQUAL>(pz, z, dzdx, count, depthWrite);
+	default:
+		return depthSpanGeneric(pz, z, dzdx, count, depthFunc, depthWrite);
+	}
+}
+
+} // end of namespace TinyGL
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
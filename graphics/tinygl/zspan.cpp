@@ -0,0 +1,102 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/system.h"
+
+#include "graphics/tinygl/zbuffer.h"
+
+namespace TinyGL {
+
+// Initialize this to nullptr at the start
+FrameBuffer::DepthSpanFunc FrameBuffer::depthSpanFunc = nullptr;
+
+// Pick the span functions matching the SIMD features of the host cpu.
+void FrameBuffer::selectSpanFuncs() {
+	depthSpanFunc = depthSpanGeneric;
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) depthSpanFunc = depthSpanNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) depthSpanFunc = depthSpanSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) depthSpanFunc = depthSpanAVX2;
+#endif
+}
+
+template <int kDepthFunc>
+static FORCEINLINE bool depthTest(uint zSrc, uint zDst) {
+	switch (kDepthFunc) {
+	case TGL_LESS:
+		return zDst < zSrc;
+	case TGL_EQUAL:
+		return zDst == zSrc;
+	case TGL_LEQUAL:
+		return zDst <= zSrc;
+	case TGL_GREATER:
+		return zDst > zSrc;
+	case TGL_NOTEQUAL:
+		return zDst != zSrc;
+	case TGL_GEQUAL:
+		return zDst >= zSrc;
+	case TGL_ALWAYS:
+		return true;
+	default:
+		return false;
+	}
+}
+
+template <int kDepthFunc>
+static uint32 depthSpan(uint *pz, uint z, int dzdx, int count, bool depthWrite) {
+	uint32 mask = 0;
+	for (int i = 0; i < count; i++) {
+		if (depthTest<kDepthFunc>(z, pz[i])) {
+			if (depthWrite)
+				pz[i] = z;
+			mask |= (uint32)1 << i;
+		}
+		z += dzdx;
+	}
+	return mask;
+}
+
+uint32 FrameBuffer::depthSpanGeneric(uint *pz, uint z, int dzdx, int count, int depthFunc, bool depthWrite) {
+	switch (depthFunc) {
+	case TGL_LESS:
+		return depthSpan<TGL_LESS>(pz, z, dzdx, count, depthWrite);
+	case TGL_EQUAL:
+		return depthSpan<TGL_EQUAL>(pz, z, dzdx, count, depthWrite);
+	case TGL_LEQUAL:
+		return depthSpan<TGL_LEQUAL>(pz, z, dzdx, count, depthWrite);
+	case TGL_GREATER:
+		return depthSpan<TGL_GREATER>(pz, z, dzdx, count, depthWrite);
+	case TGL_NOTEQUAL:
+		return depthSpan<TGL_NOTEQUAL>(pz, z, dzdx, count, depthWrite);
+	case TGL_GEQUAL:
+		return depthSpan<TGL_GEQUAL>(pz, z, dzdx, count, depthWrite);
+	case TGL_ALWAYS:
+		return depthSpan<TGL_ALWAYS>(pz, z, dzdx, count, depthWrite);
+	default:
+		return 0;
+	}
+}
+
+} // end of namespace TinyGL
@@ -49,7 +49,11 @@ template <bool kDepthWrite, bool kSmoothMode, bool kFogMode, bool kEnableAlphaTe
 void FrameBuffer::putPixelNoTexture(int fbOffset, uint *pz, byte *ps, int _a,
                                     int x, int y, uint &z, uint &r, uint &g, uint &b, uint &a,
                                     int &dzdx, int &drdx, int &dgdx, int &dbdx, uint dadx,
-                                    uint &fog, int fog_r, int fog_g, int fog_b, int &dfdx) {
+                                    uint &fog, int fog_r, int fog_g, int fog_b, int &dfdx, bool visible) {
+	if (!visible) {
+		goto end;
+	}
+
 	if (kEnableScissor && scissorPixel(x + _a, y)) {
 		goto end;
 	}
@@ -98,7 +102,11 @@ void FrameBuffer::putPixelTexture(int fbOffset, const TexelBuffer *texture,
                                   int x, int y, uint &z, int &t, int &s,
                                   uint &r, uint &g, uint &b, uint &a,
                                   int &dzdx, int &dsdx, int &dtdx, int &drdx, int &dgdx, int &dbdx, uint dadx,
-                                  uint &fog, int fog_r, int fog_g, int fog_b, int &dfdx) {
+                                  uint &fog, int fog_r, int fog_g, int fog_b, int &dfdx, bool visible) {
+	if (!visible) {
+		goto end;
+	}
+
 	if (kEnableScissor && scissorPixel(x + _a, y)) {
 		goto end;
 	}
@@ -462,30 +470,47 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 				if (kStencilEnabled) {
 					ps = ps1 + x1;
 				}
-				while (n >= 3) {
-					putPixelDepth<kDepthWrite, kEnableScissor, kStencilEnabled, kStippleEnabled, kDepthTestEnabled>(pz, ps, 0, x, y, z, dzdx);
-					putPixelDepth<kDepthWrite, kEnableScissor, kStencilEnabled, kStippleEnabled, kDepthTestEnabled>(pz, ps, 1, x, y, z, dzdx);
-					putPixelDepth<kDepthWrite, kEnableScissor, kStencilEnabled, kStippleEnabled, kDepthTestEnabled>(pz, ps, 2, x, y, z, dzdx);
-					putPixelDepth<kDepthWrite, kEnableScissor, kStencilEnabled, kStippleEnabled, kDepthTestEnabled>(pz, ps, 3, x, y, z, dzdx);
-					if (kInterpZ) {
-						pz += 4;
+				if (kInterpZ && !kStencilEnabled) {
+					// Without stencil the span is a plain depth test on the pixels inside the scissor.
+					const int depthFunc = kDepthTestEnabled ? _depthFunc : TGL_ALWAYS;
+					int first = 0, last = n + 1;
+					if (kEnableScissor) {
+						scissorSpan(x, y, first, last);
 					}
-					if (kStencilEnabled) {
-						ps += 4;
+					pz += first;
+					z += first * dzdx;
+					for (int i = first; i < last; i += 32) {
+						const int count = MIN(last - i, 32);
+						depthSpanFunc(pz, z, dzdx, count, depthFunc, kDepthWrite);
+						pz += count;
+						z += count * dzdx;
 					}
-					n -= 4;
-					x += 4;
-				}
-				while (n >= 0) {
-					putPixelDepth<kDepthWrite, kEnableScissor, kStencilEnabled, kStippleEnabled, kDepthTestEnabled>(pz, ps, 0, x, y, z, dzdx);
-					if (kInterpZ) {
-						pz += 1;
+				} else {
+					while (n >= 3) {
+						putPixelDepth<kDepthWrite, kEnableScissor, kStencilEnabled, kStippleEnabled, kDepthTestEnabled>(pz, ps, 0, x, y, z, dzdx);
+						putPixelDepth<kDepthWrite, kEnableScissor, kStencilEnabled, kStippleEnabled, kDepthTestEnabled>(pz, ps, 1, x, y, z, dzdx);
+						putPixelDepth<kDepthWrite, kEnableScissor, kStencilEnabled, kStippleEnabled, kDepthTestEnabled>(pz, ps, 2, x, y, z, dzdx);
+						putPixelDepth<kDepthWrite, kEnableScissor, kStencilEnabled, kStippleEnabled, kDepthTestEnabled>(pz, ps, 3, x, y, z, dzdx);
+						if (kInterpZ) {
+							pz += 4;
+						}
+						if (kStencilEnabled) {
+							ps += 4;
+						}
+						n -= 4;
+						x += 4;
 					}
-					if (kStencilEnabled) {
-						ps += 1;
+					while (n >= 0) {
+						putPixelDepth<kDepthWrite, kEnableScissor, kStencilEnabled, kStippleEnabled, kDepthTestEnabled>(pz, ps, 0, x, y, z, dzdx);
+						if (kInterpZ) {
+							pz += 1;
+						}
+						if (kStencilEnabled) {
+							ps += 1;
+						}
+						n -= 1;
+						x += 1;
 					}
-					n -= 1;
-					x += 1;
 				}
 			} else if (!(kInterpST || kInterpSTZ)) {
 				uint *pz;
@@ -508,15 +533,53 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 				if (kStencilEnabled) {
 					ps = ps1 + x1;
 				}
+				// Without stencil, depth test up to 32 pixels at once and use the
+				// result for the blocks they contain
+				const bool kBlockTest = kInterpZ && kDepthTestEnabled && !kStencilEnabled;
+				uint32 visibleMask = 0;
+				int blockShift = 32;
 				while (n >= 3) {
-					putPixelNoTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kStippleEnabled, kDepthTestEnabled>
-					                 (pp, pz, ps, 0, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
-					putPixelNoTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kStippleEnabled, kDepthTestEnabled>
-					                 (pp, pz, ps, 1, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
-					putPixelNoTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kStippleEnabled, kDepthTestEnabled>
-					                 (pp, pz, ps, 2, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
-					putPixelNoTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kStippleEnabled, kDepthTestEnabled>
-					                 (pp, pz, ps, 3, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+					uint32 visible = 0;
+					if (kBlockTest) {
+						if (blockShift == 32) {
+							visibleMask = visibleSpanMask(pz, x, y, z, dzdx, MIN((n + 1) & ~3, 32), kEnableScissor);
+							blockShift = 0;
+						}
+						visible = (visibleMask >> blockShift) & 0xf;
+						blockShift += 4;
+					}
+					if (kBlockTest && visible == 0) {
+						// All 4 pixels are hidden, only step the interpolated values.
+						z += 4 * dzdx;
+						if (kFogMode) {
+							fog += 4 * dfdx;
+						}
+						if (kSmoothMode) {
+							r += 4 * drdx;
+							g += 4 * dgdx;
+							b += 4 * dbdx;
+							a += 4 * dadx;
+						}
+					} else if (kBlockTest) {
+						// The depth and scissor tests are done, only draw the visible pixels.
+						putPixelNoTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, false, kBlendingEnabled, false, kStippleEnabled, false>
+						                 (pp, pz, ps, 0, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx, visible & 1);
+						putPixelNoTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, false, kBlendingEnabled, false, kStippleEnabled, false>
+						                 (pp, pz, ps, 1, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx, visible & 2);
+						putPixelNoTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, false, kBlendingEnabled, false, kStippleEnabled, false>
+						                 (pp, pz, ps, 2, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx, visible & 4);
+						putPixelNoTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, false, kBlendingEnabled, false, kStippleEnabled, false>
+						                 (pp, pz, ps, 3, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx, visible & 8);
+					} else {
+						putPixelNoTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kStippleEnabled, kDepthTestEnabled>
+						                 (pp, pz, ps, 0, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+						putPixelNoTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kStippleEnabled, kDepthTestEnabled>
+						                 (pp, pz, ps, 1, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+						putPixelNoTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kStippleEnabled, kDepthTestEnabled>
+						                 (pp, pz, ps, 2, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+						putPixelNoTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kStippleEnabled, kDepthTestEnabled>
+						                 (pp, pz, ps, 3, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+					}
 					pp += 4;
 					if (kInterpZ) {
 						pz += 4;
@@ -570,6 +633,11 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 				g = g1;
 				b = b1;
 				a = a1;
+				// Without stencil, depth test up to 32 pixels at once and use the
+				// result for the blocks they contain
+				const bool kBlockTest = kInterpZ && kDepthTestEnabled && !kStencilEnabled;
+				uint32 visibleMask = 0;
+				int blockShift = 32;
 				while (n >= (NB_INTERP - 1)) {
 					{
 						float ss, tt;
@@ -582,9 +650,38 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 						fz += fndzdx;
 						zinv = (float)(1.0 / fz);
 					}
-					for (int _a = 0; _a < NB_INTERP; _a++) {
-						putPixelTexture<kDepthWrite, kInterpRGB, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
-						               (pp, texture, _wrapS, _wrapT, pz, ps, _a, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+					uint32 visible = 0;
+					if (kBlockTest) {
+						if (blockShift == 32) {
+							visibleMask = visibleSpanMask(pz, x, y, z, dzdx, MIN((n + 1) & ~(NB_INTERP - 1), 32), kEnableScissor);
+							blockShift = 0;
+						}
+						visible = (visibleMask >> blockShift) & 0xff;
+						blockShift += NB_INTERP;
+					}
+					if (kBlockTest && visible == 0) {
+						// The whole block is hidden, skip texel fetches and only step the interpolated values.
+						z += NB_INTERP * dzdx;
+						if (kFogMode) {
+							fog += NB_INTERP * dfdx;
+						}
+						if (kSmoothMode) {
+							a += NB_INTERP * dadx;
+							r += NB_INTERP * drdx;
+							g += NB_INTERP * dgdx;
+							b += NB_INTERP * dbdx;
+						}
+					} else if (kBlockTest) {
+						// The depth and scissor tests are done, only draw the visible pixels.
+						for (int _a = 0; _a < NB_INTERP; _a++) {
+							putPixelTexture<kDepthWrite, kInterpRGB, kSmoothMode, kFogMode, kAlphaTestEnabled, false, kBlendingEnabled, false, false>
+							               (pp, texture, _wrapS, _wrapT, pz, ps, _a, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx, (visible >> _a) & 1);
+						}
+					} else {
+						for (int _a = 0; _a < NB_INTERP; _a++) {
+							putPixelTexture<kDepthWrite, kInterpRGB, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
+							               (pp, texture, _wrapS, _wrapT, pz, ps, _a, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+						}
 					}
 					pp += NB_INTERP;
 					if (kInterpZ) {
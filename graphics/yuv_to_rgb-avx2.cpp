@@ -0,0 +1,141 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Graphics {
+
+struct RowConstsAVX2 {
+	RowConstsAVX2(const YUVToRGBRowParams &params) :
+		itu(params.itu),
+		lumaMin(_mm256_set1_epi16(params.lumaMin)), lumaMax(_mm256_set1_epi16(params.lumaMax)),
+		rLoss(_mm_cvtsi32_si128(params.rLoss)), gLoss(_mm_cvtsi32_si128(params.gLoss)), bLoss(_mm_cvtsi32_si128(params.bLoss)),
+		rShift(_mm_cvtsi32_si128(params.rShift)), gShift(_mm_cvtsi32_si128(params.gShift)), bShift(_mm_cvtsi32_si128(params.bShift)),
+		aMask16(_mm256_set1_epi16((int16)params.aMask)), aMask32(_mm256_set1_epi32(params.aMask)) {}
+
+	bool itu;
+	__m256i lumaMin, lumaMax;
+	__m128i rLoss, gLoss, bLoss;
+	__m128i rShift, gShift, bShift;
+	__m256i aMask16, aMask32;
+};
+
+// The chroma offset sign(c) * trunc(|c| * factor), see YUVToRGBLookup
+template<bool plusOne>
+static FORCEINLINE __m256i chromaOffsetAVX2(__m256i c, int fraction) {
+	const __m256i magnitude = _mm256_abs_epi16(c);
+	__m256i offset = _mm256_mulhi_epu16(magnitude, _mm256_set1_epi16((int16)fraction));
+	if (plusOne)
+		offset = _mm256_add_epi16(offset, magnitude);
+	return _mm256_sign_epi16(offset, c);
+}
+
+static FORCEINLINE __m256i channelAVX2(__m256i y, __m256i offset, __m128i loss, const RowConstsAVX2 &c) {
+	__m256i x = _mm256_min_epi16(_mm256_max_epi16(_mm256_add_epi16(y, offset), c.lumaMin), c.lumaMax);
+	if (c.itu) {
+		x = _mm256_sub_epi16(x, _mm256_set1_epi16(16));
+		x = _mm256_add_epi16(x, _mm256_mulhi_epu16(x, _mm256_set1_epi16(kYUVITUFraction)));
+	}
+	return _mm256_srl_epi16(x, loss);
+}
+
+static FORCEINLINE __m256i widenAVX2(__m128i x, __m128i shift) {
+	return _mm256_sll_epi32(_mm256_cvtepu16_epi32(x), shift);
+}
+
+// Convert 16 pixels from 16-bit luma and chroma values
+template<typename PixelInt>
+static FORCEINLINE void convert16AVX2(byte *dst, __m256i y, __m256i u, __m256i v, const RowConstsAVX2 &c) {
+	const __m256i bias = _mm256_set1_epi16(128);
+	const __m256i cb = _mm256_sub_epi16(u, bias);
+	const __m256i cr = _mm256_sub_epi16(v, bias);
+
+	const __m256i rOffset = chromaOffsetAVX2<true>(cr, kYUVCrToRFraction);
+	const __m256i gOffset = _mm256_sub_epi16(_mm256_setzero_si256(), _mm256_add_epi16(chromaOffsetAVX2<false>(cr, kYUVCrToGFraction), chromaOffsetAVX2<false>(cb, kYUVCbToGFraction)));
+	const __m256i bOffset = chromaOffsetAVX2<true>(cb, kYUVCbToBFraction);
+
+	const __m256i r = channelAVX2(y, rOffset, c.rLoss, c);
+	const __m256i g = channelAVX2(y, gOffset, c.gLoss, c);
+	const __m256i b = channelAVX2(y, bOffset, c.bLoss, c);
+
+	if (sizeof(PixelInt) == 2) {
+		__m256i pixels = _mm256_or_si256(_mm256_sll_epi16(r, c.rShift), _mm256_sll_epi16(g, c.gShift));
+		pixels = _mm256_or_si256(pixels, _mm256_or_si256(_mm256_sll_epi16(b, c.bShift), c.aMask16));
+		_mm256_storeu_si256((__m256i *)dst, pixels);
+	} else {
+		__m256i lo = _mm256_or_si256(widenAVX2(_mm256_castsi256_si128(r), c.rShift), widenAVX2(_mm256_castsi256_si128(g), c.gShift));
+		__m256i hi = _mm256_or_si256(widenAVX2(_mm256_extracti128_si256(r, 1), c.rShift), widenAVX2(_mm256_extracti128_si256(g, 1), c.gShift));
+		lo = _mm256_or_si256(lo, _mm256_or_si256(widenAVX2(_mm256_castsi256_si128(b), c.bShift), c.aMask32));
+		hi = _mm256_or_si256(hi, _mm256_or_si256(widenAVX2(_mm256_extracti128_si256(b, 1), c.bShift), c.aMask32));
+		_mm256_storeu_si256((__m256i *)dst, lo);
+		_mm256_storeu_si256((__m256i *)(dst + 32), hi);
+	}
+}
+
+template<typename PixelInt, bool halfChroma>
+static int convertRowAVX2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowParams &params) {
+	const RowConstsAVX2 c(params);
+
+	int x = 0;
+	for (; x + 16 <= width; x += 16) {
+		const __m128i y = _mm_loadu_si128((const __m128i *)(ySrc + x));
+		__m128i u, v;
+		if (halfChroma) {
+			u = _mm_loadl_epi64((const __m128i *)(uSrc + x / 2));
+			v = _mm_loadl_epi64((const __m128i *)(vSrc + x / 2));
+			u = _mm_unpacklo_epi8(u, u);
+			v = _mm_unpacklo_epi8(v, v);
+		} else {
+			u = _mm_loadu_si128((const __m128i *)(uSrc + x));
+			v = _mm_loadu_si128((const __m128i *)(vSrc + x));
+		}
+
+		convert16AVX2<PixelInt>(dst + x * sizeof(PixelInt), _mm256_cvtepu8_epi16(y), _mm256_cvtepu8_epi16(u), _mm256_cvtepu8_epi16(v), c);
+	}
+
+	return x;
+}
+
+const YUVToRGBFuncs yuvToRGBAVX2Funcs = {
+	convertRowAVX2<uint16, false>,
+	convertRowAVX2<uint32, false>,
+	convertRowAVX2<uint16, true>,
+	convertRowAVX2<uint32, true>
+};
+
+} // End of namespace Graphics
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,166 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+namespace Graphics {
+
+struct RowConstsNEON {
+	RowConstsNEON(const YUVToRGBRowParams &params) :
+		itu(params.itu),
+		lumaMin(vdupq_n_s16(params.lumaMin)), lumaMax(vdupq_n_s16(params.lumaMax)),
+		rLoss(vdupq_n_s16(-params.rLoss)), gLoss(vdupq_n_s16(-params.gLoss)), bLoss(vdupq_n_s16(-params.bLoss)),
+		rShift16(vdupq_n_s16(params.rShift)), gShift16(vdupq_n_s16(params.gShift)), bShift16(vdupq_n_s16(params.bShift)),
+		rShift32(vdupq_n_s32(params.rShift)), gShift32(vdupq_n_s32(params.gShift)), bShift32(vdupq_n_s32(params.bShift)),
+		aMask16(vdupq_n_u16((uint16)params.aMask)), aMask32(vdupq_n_u32(params.aMask)) {}
+
+	bool itu;
+	int16x8_t lumaMin, lumaMax;
+	int16x8_t rLoss, gLoss, bLoss;
+	int16x8_t rShift16, gShift16, bShift16;
+	int32x4_t rShift32, gShift32, bShift32;
+	uint16x8_t aMask16;
+	uint32x4_t aMask32;
+};
+
+static FORCEINLINE uint16x8_t mulhiNEON(uint16x8_t x, uint16 factor) {
+	const uint16x4_t lo = vshrn_n_u32(vmull_n_u16(vget_low_u16(x), factor), 16);
+	const uint16x4_t hi = vshrn_n_u32(vmull_n_u16(vget_high_u16(x), factor), 16);
+	return vcombine_u16(lo, hi);
+}
+
+// The chroma offset sign(c) * trunc(|c| * factor), see YUVToRGBLookup
+template<bool plusOne>
+static FORCEINLINE int16x8_t chromaOffsetNEON(int16x8_t c, uint16 fraction) {
+	const uint16x8_t magnitude = vreinterpretq_u16_s16(vabsq_s16(c));
+	uint16x8_t offset = mulhiNEON(magnitude, fraction);
+	if (plusOne)
+		offset = vaddq_u16(offset, magnitude);
+	const int16x8_t result = vreinterpretq_s16_u16(offset);
+	return vbslq_s16(vcltq_s16(c, vdupq_n_s16(0)), vnegq_s16(result), result);
+}
+
+static FORCEINLINE uint16x8_t channelNEON(int16x8_t y, int16x8_t offset, int16x8_t loss, const RowConstsNEON &c) {
+	uint16x8_t x = vreinterpretq_u16_s16(vminq_s16(vmaxq_s16(vaddq_s16(y, offset), c.lumaMin), c.lumaMax));
+	if (c.itu) {
+		x = vsubq_u16(x, vdupq_n_u16(16));
+		x = vaddq_u16(x, mulhiNEON(x, kYUVITUFraction));
+	}
+	return vshlq_u16(x, loss);
+}
+
+// Convert 8 pixels from 16-bit luma and chroma values
+template<typename PixelInt>
+static FORCEINLINE void convert8NEON(byte *dst, int16x8_t y, int16x8_t u, int16x8_t v, const RowConstsNEON &c) {
+	const int16x8_t bias = vdupq_n_s16(128);
+	const int16x8_t cb = vsubq_s16(u, bias);
+	const int16x8_t cr = vsubq_s16(v, bias);
+
+	const int16x8_t rOffset = chromaOffsetNEON<true>(cr, kYUVCrToRFraction);
+	const int16x8_t gOffset = vnegq_s16(vaddq_s16(chromaOffsetNEON<false>(cr, kYUVCrToGFraction), chromaOffsetNEON<false>(cb, kYUVCbToGFraction)));
+	const int16x8_t bOffset = chromaOffsetNEON<true>(cb, kYUVCbToBFraction);
+
+	const uint16x8_t r = channelNEON(y, rOffset, c.rLoss, c);
+	const uint16x8_t g = channelNEON(y, gOffset, c.gLoss, c);
+	const uint16x8_t b = channelNEON(y, bOffset, c.bLoss, c);
+
+	if (sizeof(PixelInt) == 2) {
+		uint16x8_t pixels = vorrq_u16(vshlq_u16(r, c.rShift16), vshlq_u16(g, c.gShift16));
+		pixels = vorrq_u16(pixels, vorrq_u16(vshlq_u16(b, c.bShift16), c.aMask16));
+		vst1q_u8(dst, vreinterpretq_u8_u16(pixels));
+	} else {
+		uint32x4_t lo = vorrq_u32(vshlq_u32(vmovl_u16(vget_low_u16(r)), c.rShift32), vshlq_u32(vmovl_u16(vget_low_u16(g)), c.gShift32));
+		uint32x4_t hi = vorrq_u32(vshlq_u32(vmovl_u16(vget_high_u16(r)), c.rShift32), vshlq_u32(vmovl_u16(vget_high_u16(g)), c.gShift32));
+		lo = vorrq_u32(lo, vorrq_u32(vshlq_u32(vmovl_u16(vget_low_u16(b)), c.bShift32), c.aMask32));
+		hi = vorrq_u32(hi, vorrq_u32(vshlq_u32(vmovl_u16(vget_high_u16(b)), c.bShift32), c.aMask32));
+		vst1q_u8(dst, vreinterpretq_u8_u32(lo));
+		vst1q_u8(dst + 16, vreinterpretq_u8_u32(hi));
+	}
+}
+
+static FORCEINLINE int16x8_t widenNEON(uint8x8_t x) {
+	return vreinterpretq_s16_u16(vmovl_u8(x));
+}
+
+template<typename PixelInt, bool halfChroma>
+static int convertRowNEON(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowParams &params) {
+	const RowConstsNEON c(params);
+
+	int x = 0;
+	for (; x + 16 <= width; x += 16) {
+		const uint8x16_t y = vld1q_u8(ySrc + x);
+		uint8x16_t u, v;
+		if (halfChroma) {
+			const uint8x8_t halfU = vld1_u8(uSrc + x / 2);
+			const uint8x8_t halfV = vld1_u8(vSrc + x / 2);
+			const uint8x8x2_t zipU = vzip_u8(halfU, halfU);
+			const uint8x8x2_t zipV = vzip_u8(halfV, halfV);
+			u = vcombine_u8(zipU.val[0], zipU.val[1]);
+			v = vcombine_u8(zipV.val[0], zipV.val[1]);
+		} else {
+			u = vld1q_u8(uSrc + x);
+			v = vld1q_u8(vSrc + x);
+		}
+
+		convert8NEON<PixelInt>(dst + x * sizeof(PixelInt), widenNEON(vget_low_u8(y)), widenNEON(vget_low_u8(u)), widenNEON(vget_low_u8(v)), c);
+		convert8NEON<PixelInt>(dst + (x + 8) * sizeof(PixelInt), widenNEON(vget_high_u8(y)), widenNEON(vget_high_u8(u)), widenNEON(vget_high_u8(v)), c);
+	}
+
+	return x;
+}
+
+const YUVToRGBFuncs yuvToRGBNEONFuncs = {
+	convertRowNEON<uint16, false>,
+	convertRowNEON<uint32, false>,
+	convertRowNEON<uint16, true>,
+	convertRowNEON<uint32, true>
+};
+
+} // End of namespace Graphics
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,149 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace Graphics {
+
+struct RowConstsSSE2 {
+	RowConstsSSE2(const YUVToRGBRowParams &params) :
+		itu(params.itu),
+		lumaMin(_mm_set1_epi16(params.lumaMin)), lumaMax(_mm_set1_epi16(params.lumaMax)),
+		rLoss(_mm_cvtsi32_si128(params.rLoss)), gLoss(_mm_cvtsi32_si128(params.gLoss)), bLoss(_mm_cvtsi32_si128(params.bLoss)),
+		rShift(_mm_cvtsi32_si128(params.rShift)), gShift(_mm_cvtsi32_si128(params.gShift)), bShift(_mm_cvtsi32_si128(params.bShift)),
+		aMask16(_mm_set1_epi16((int16)params.aMask)), aMask32(_mm_set1_epi32(params.aMask)) {}
+
+	bool itu;
+	__m128i lumaMin, lumaMax;
+	__m128i rLoss, gLoss, bLoss;
+	__m128i rShift, gShift, bShift;
+	__m128i aMask16, aMask32;
+};
+
+// The chroma offset sign(c) * trunc(|c| * factor), see YUVToRGBLookup
+template<bool plusOne>
+static FORCEINLINE __m128i chromaOffsetSSE2(__m128i c, int fraction) {
+	const __m128i sign = _mm_srai_epi16(c, 15);
+	const __m128i magnitude = _mm_sub_epi16(_mm_xor_si128(c, sign), sign);
+	__m128i offset = _mm_mulhi_epu16(magnitude, _mm_set1_epi16((int16)fraction));
+	if (plusOne)
+		offset = _mm_add_epi16(offset, magnitude);
+	return _mm_sub_epi16(_mm_xor_si128(offset, sign), sign);
+}
+
+static FORCEINLINE __m128i channelSSE2(__m128i y, __m128i offset, __m128i loss, const RowConstsSSE2 &c) {
+	__m128i x = _mm_min_epi16(_mm_max_epi16(_mm_add_epi16(y, offset), c.lumaMin), c.lumaMax);
+	if (c.itu) {
+		x = _mm_sub_epi16(x, _mm_set1_epi16(16));
+		x = _mm_add_epi16(x, _mm_mulhi_epu16(x, _mm_set1_epi16(kYUVITUFraction)));
+	}
+	return _mm_srl_epi16(x, loss);
+}
+
+// Convert 8 pixels from 16-bit luma and chroma values
+template<typename PixelInt>
+static FORCEINLINE void convert8SSE2(byte *dst, __m128i y, __m128i u, __m128i v, const RowConstsSSE2 &c) {
+	const __m128i bias = _mm_set1_epi16(128);
+	const __m128i cb = _mm_sub_epi16(u, bias);
+	const __m128i cr = _mm_sub_epi16(v, bias);
+
+	const __m128i rOffset = chromaOffsetSSE2<true>(cr, kYUVCrToRFraction);
+	const __m128i gOffset = _mm_sub_epi16(_mm_setzero_si128(), _mm_add_epi16(chromaOffsetSSE2<false>(cr, kYUVCrToGFraction), chromaOffsetSSE2<false>(cb, kYUVCbToGFraction)));
+	const __m128i bOffset = chromaOffsetSSE2<true>(cb, kYUVCbToBFraction);
+
+	const __m128i r = channelSSE2(y, rOffset, c.rLoss, c);
+	const __m128i g = channelSSE2(y, gOffset, c.gLoss, c);
+	const __m128i b = channelSSE2(y, bOffset, c.bLoss, c);
+
+	if (sizeof(PixelInt) == 2) {
+		__m128i pixels = _mm_or_si128(_mm_sll_epi16(r, c.rShift), _mm_sll_epi16(g, c.gShift));
+		pixels = _mm_or_si128(pixels, _mm_or_si128(_mm_sll_epi16(b, c.bShift), c.aMask16));
+		_mm_storeu_si128((__m128i *)dst, pixels);
+	} else {
+		const __m128i zero = _mm_setzero_si128();
+		__m128i lo = _mm_or_si128(_mm_sll_epi32(_mm_unpacklo_epi16(r, zero), c.rShift), _mm_sll_epi32(_mm_unpacklo_epi16(g, zero), c.gShift));
+		__m128i hi = _mm_or_si128(_mm_sll_epi32(_mm_unpackhi_epi16(r, zero), c.rShift), _mm_sll_epi32(_mm_unpackhi_epi16(g, zero), c.gShift));
+		lo = _mm_or_si128(lo, _mm_or_si128(_mm_sll_epi32(_mm_unpacklo_epi16(b, zero), c.bShift), c.aMask32));
+		hi = _mm_or_si128(hi, _mm_or_si128(_mm_sll_epi32(_mm_unpackhi_epi16(b, zero), c.bShift), c.aMask32));
+		_mm_storeu_si128((__m128i *)dst, lo);
+		_mm_storeu_si128((__m128i *)(dst + 16), hi);
+	}
+}
+
+template<typename PixelInt, bool halfChroma>
+static int convertRowSSE2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowParams &params) {
+	const RowConstsSSE2 c(params);
+	const __m128i zero = _mm_setzero_si128();
+
+	int x = 0;
+	for (; x + 16 <= width; x += 16) {
+		const __m128i y = _mm_loadu_si128((const __m128i *)(ySrc + x));
+		__m128i u, v;
+		if (halfChroma) {
+			u = _mm_loadl_epi64((const __m128i *)(uSrc + x / 2));
+			v = _mm_loadl_epi64((const __m128i *)(vSrc + x / 2));
+			u = _mm_unpacklo_epi8(u, u);
+			v = _mm_unpacklo_epi8(v, v);
+		} else {
+			u = _mm_loadu_si128((const __m128i *)(uSrc + x));
+			v = _mm_loadu_si128((const __m128i *)(vSrc + x));
+		}
+
+		convert8SSE2<PixelInt>(dst + x * sizeof(PixelInt), _mm_unpacklo_epi8(y, zero), _mm_unpacklo_epi8(u, zero), _mm_unpacklo_epi8(v, zero), c);
+		convert8SSE2<PixelInt>(dst + (x + 8) * sizeof(PixelInt), _mm_unpackhi_epi8(y, zero), _mm_unpackhi_epi8(u, zero), _mm_unpackhi_epi8(v, zero), c);
+	}
+
+	return x;
+}
+
+const YUVToRGBFuncs yuvToRGBSSE2Funcs = {
+	convertRowSSE2<uint16, false>,
+	convertRowSSE2<uint32, false>,
+	convertRowSSE2<uint16, true>,
+	convertRowSSE2<uint32, true>
+};
+
+} // End of namespace Graphics
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
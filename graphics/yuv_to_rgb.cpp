@@ -82,8 +82,11 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/system.h"
+
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_intern.h"
 
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVToRGBManager);
@@ -99,10 +102,12 @@ public:
 	YUVToRGBManager::LuminanceScale getScale() const { return _scale; }
 	const int16 *getColorTable() const { return _colorTab; }
 	const byte *getClipTable() const { return _clipTable; }
+	const YUVToRGBRowParams &getRowParams() const { return _rowParams; }
 
 private:
 	Graphics::PixelFormat _format;
 	YUVToRGBManager::LuminanceScale _scale;
+	YUVToRGBRowParams _rowParams;
 	int16 _colorTab[4 * 256]; // 2048 bytes
 	byte _clipTable[3 * 768];
 };
@@ -179,23 +184,71 @@ YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::Lu
 		Cb_g_tab[i] = (int16) (-(0.114 / 0.331) * CB);
 		Cb_b_tab[i] = (int16) ( (0.587 / 0.331) * CB) + b_offset + 256;
 	}
+
+	// The same conversion for the SIMD kernels
+	_rowParams.lumaMin = (scale == YUVToRGBManager::kScaleFull) ? 0 : 16;
+	_rowParams.lumaMax = (scale == YUVToRGBManager::kScaleFull) ? 255 : 235;
+	_rowParams.itu = (scale == YUVToRGBManager::kScaleITU);
+	_rowParams.rLoss = format.rLoss;
+	_rowParams.gLoss = format.gLoss;
+	_rowParams.bLoss = format.bLoss;
+	_rowParams.rShift = format.rShift;
+	_rowParams.gShift = format.gShift;
+	_rowParams.bShift = format.bShift;
+	_rowParams.aMask = (0xFF >> format.aLoss) << format.aShift;
+}
+
+const YUVToRGBFuncs yuvToRGBGenericFuncs = { nullptr, nullptr, nullptr, nullptr };
+
+const YUVToRGBFuncs *yuvToRGBFuncs = nullptr;
+
+const YUVToRGBFuncs *getYUVToRGBFuncs() {
+	if (yuvToRGBFuncs)
+		return yuvToRGBFuncs;
+
+	yuvToRGBFuncs = &yuvToRGBGenericFuncs;
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) yuvToRGBFuncs = &yuvToRGBNEONFuncs;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) yuvToRGBFuncs = &yuvToRGBSSE2Funcs;
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) yuvToRGBFuncs = &yuvToRGBAVX2Funcs;
+#endif
+	return yuvToRGBFuncs;
 }
 
 YUVToRGBManager::YUVToRGBManager() {
-	_lookup = 0;
 }
 
 YUVToRGBManager::~YUVToRGBManager() {
-	delete _lookup;
+	for (uint i = 0; i < _lookups.size(); i++)
+		delete _lookups[i];
 }
 
 const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, YUVToRGBManager::LuminanceScale scale) {
-	if (_lookup && _lookup->getFormat() == format && _lookup->getScale() == scale)
-		return _lookup;
+	Common::StackLock lock(_lookupMutex);
 
-	delete _lookup;
-	_lookup = new YUVToRGBLookup(format, scale);
-	return _lookup;
+	// Most recently created first, that is the one usually wanted
+	for (uint i = _lookups.size(); i > 0; i--) {
+		if (_lookups[i - 1]->getFormat() == format && _lookups[i - 1]->getScale() == scale)
+			return _lookups[i - 1];
+	}
+
+	YUVToRGBLookup *lookup = new YUVToRGBLookup(format, scale);
+	_lookups.push_back(lookup);
+	return lookup;
+}
+
+void YUVToRGBManager::prepare(const Graphics::PixelFormat &format) {
+	// There is no conversion to palettized surfaces
+	if (format.bytesPerPixel == 1)
+		return;
+
+	getYUVToRGBFuncs();
+	getLookup(format, kScaleFull);
+	getLookup(format, kScaleITU);
 }
 
 #define PUT_PIXEL(s, d) \
@@ -203,7 +256,7 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, Y
 	*((PixelInt *)(d)) = ((L[cr_r] << r_shift) | (L[crb_g] << g_shift) | (L[cb_b] << b_shift) | a_mask)
 
 template<typename PixelInt>
-void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, YUVToRGBRowFunc rowFunc, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Keep the tables in pointers here to avoid a dereference on each pixel
 	const int16 *Cr_r_tab = lookup->getColorTable();
 	const int16 *Cr_g_tab = Cr_r_tab + 256;
@@ -217,7 +270,14 @@ void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 	const PixelInt a_mask = (0xFF >> lookup->getFormat().aLoss) << lookup->getFormat().aShift;
 
 	for (int h = 0; h < yHeight; h++) {
-		for (int w = 0; w < yWidth; w++) {
+		// Let the SIMD kernel do as much of the row as it can
+		int w = rowFunc ? rowFunc(dstPtr, ySrc, uSrc, vSrc, yWidth, lookup->getRowParams()) : 0;
+		dstPtr += w * sizeof(PixelInt);
+		ySrc += w;
+		uSrc += w;
+		vSrc += w;
+
+		for (; w < yWidth; w++) {
 			const byte *L;
 
 			int16 cr_r  = Cr_r_tab[*vSrc];
@@ -245,16 +305,17 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert(ySrc && uSrc && vSrc);
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
+	const YUVToRGBFuncs *funcs = getYUVToRGBFuncs();
 
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUV444ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV444ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, funcs->row444To16, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 	else
-		convertYUV444ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV444ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, funcs->row444To32, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 }
 
 template<typename PixelInt>
-void convertYUV422ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void convertYUV422ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, YUVToRGBRowFunc rowFunc, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	int halfWidth = yWidth >> 1;
 
 	// Keep the tables in pointers here to avoid a dereference on each pixel
@@ -270,7 +331,14 @@ void convertYUV422ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 	const PixelInt a_mask = (0xFF >> lookup->getFormat().aLoss) << lookup->getFormat().aShift;
 
 	for (int h = 0; h < yHeight; h++) {
-		for (int w = 0; w < halfWidth; w++) {
+		// Let the SIMD kernel do as much of the row as it can
+		int w = rowFunc ? rowFunc(dstPtr, ySrc, uSrc, vSrc, yWidth, lookup->getRowParams()) >> 1 : 0;
+		dstPtr += w * 2 * sizeof(PixelInt);
+		ySrc += w * 2;
+		uSrc += w;
+		vSrc += w;
+
+		for (; w < halfWidth; w++) {
 			const byte *L;
 
 			int16 cr_r  = Cr_r_tab[*vSrc];
@@ -302,16 +370,17 @@ void YUVToRGBManager::convert422(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yWidth & 1) == 0);
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
+	const YUVToRGBFuncs *funcs = getYUVToRGBFuncs();
 
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUV422ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV422ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, funcs->row422To16, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 	else
-		convertYUV422ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV422ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, funcs->row422To32, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 }
 
 template<typename PixelInt>
-void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, YUVToRGBRowFunc rowFunc, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	int halfHeight = yHeight >> 1;
 	int halfWidth = yWidth >> 1;
 
@@ -328,7 +397,19 @@ void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 	const PixelInt a_mask = (0xFF >> lookup->getFormat().aLoss) << lookup->getFormat().aShift;
 
 	for (int h = 0; h < halfHeight; h++) {
-		for (int w = 0; w < halfWidth; w++) {
+		// Let the SIMD kernel do as much of both rows as it can
+		int w = 0;
+		if (rowFunc) {
+			w = rowFunc(dstPtr, ySrc, uSrc, vSrc, yWidth, lookup->getRowParams());
+			rowFunc(dstPtr + dstPitch, ySrc + yPitch, uSrc, vSrc, yWidth, lookup->getRowParams());
+			w >>= 1;
+		}
+		dstPtr += w * 2 * sizeof(PixelInt);
+		ySrc += w * 2;
+		uSrc += w;
+		vSrc += w;
+
+		for (; w < halfWidth; w++) {
 			const byte *L;
 
 			int16 cr_r  = Cr_r_tab[*vSrc];
@@ -363,12 +444,13 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yHeight & 1) == 0);
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
+	const YUVToRGBFuncs *funcs = getYUVToRGBFuncs();
 
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, funcs->row422To16, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 	else
-		convertYUV420ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV420ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, funcs->row422To32, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 }
 
 #define PUT_PIXELA(s, a, d) \
@@ -38,6 +38,8 @@
 #define GRAPHICS_YUV_TO_RGB_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
+#include "common/mutex.h"
 #include "common/singleton.h"
 #include "graphics/surface.h"
 
@@ -135,6 +137,16 @@ public:
 	 */
 	void convert410(Graphics::Surface *dst, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
 
+	/**
+	 * Set up everything needed to convert to the given format, so that the
+	 * conversion functions can then be called from a job thread.
+	 *
+	 * This must be called from the main thread.
+	 *
+	 * @param format  the format of the destination surfaces
+	 */
+	void prepare(const Graphics::PixelFormat &format);
+
 private:
 	friend class Common::Singleton<SingletonBaseType>;
 	YUVToRGBManager();
@@ -142,7 +154,10 @@ private:
 
 	const YUVToRGBLookup *getLookup(Graphics::PixelFormat format, LuminanceScale scale);
 
-	YUVToRGBLookup *_lookup;
+	// Lookups are kept until the manager is destroyed, as another thread
+	// may still be converting with them
+	Common::Array<YUVToRGBLookup *> _lookups;
+	Common::Mutex _lookupMutex;
 };
  /** @} */
 } // End of namespace Graphics
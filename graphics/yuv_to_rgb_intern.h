@@ -0,0 +1,93 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_YUV_TO_RGB_INTERN_H
+#define GRAPHICS_YUV_TO_RGB_INTERN_H
+
+#include "common/scummsys.h"
+
+namespace Graphics {
+
+/**
+ * Everything the SIMD row kernels need to reproduce the lookup tables of
+ * one pixel format and luminance scale.
+ */
+struct YUVToRGBRowParams {
+	int16 lumaMin;  ///< Lowest value of luma plus chroma offset before scaling
+	int16 lumaMax;  ///< Highest value of luma plus chroma offset before scaling
+	bool itu;       ///< Whether the clipped values are expanded from [16, 235] to [0, 255]
+	byte rLoss, gLoss, bLoss;
+	byte rShift, gShift, bShift;
+	uint32 aMask;
+};
+
+/**
+ * Fixed-point factors of the chroma offsets and of the ITU range expansion,
+ * applied to absolute values as x * integer part + (x * fraction) >> 16.
+ * They reproduce the truncated values of the lookup tables exactly.
+ */
+enum {
+	kYUVCrToRFraction = 26303, ///< 0.419 / 0.299, integer part 1
+	kYUVCrToGFraction = 46767, ///< 0.299 / 0.419, integer part 0
+	kYUVCbToGFraction = 22572, ///< 0.114 / 0.331, integer part 0
+	kYUVCbToBFraction = 50687, ///< 0.587 / 0.331, integer part 1
+	kYUVITUFraction   = 10775  ///< 255 / 219, integer part 1
+};
+
+/**
+ * Convert the start of a row of pixels to 16 or 32 bits per pixel. The 444
+ * kernels read one chroma sample per pixel, the 422 kernels one per two.
+ *
+ * @return The number of pixels converted, a multiple of the block size of
+ *         the kernel. The caller converts the rest of the row.
+ */
+typedef int (*YUVToRGBRowFunc)(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowParams &params);
+
+/** The row kernels of an instruction set, null ones fall back to the lookup tables. */
+struct YUVToRGBFuncs {
+	YUVToRGBRowFunc row444To16;
+	YUVToRGBRowFunc row444To32;
+	YUVToRGBRowFunc row422To16;
+	YUVToRGBRowFunc row422To32;
+};
+
+extern const YUVToRGBFuncs yuvToRGBGenericFuncs;
+#ifdef SCUMMVM_NEON
+extern const YUVToRGBFuncs yuvToRGBNEONFuncs;
+#endif
+#ifdef SCUMMVM_SSE2
+extern const YUVToRGBFuncs yuvToRGBSSE2Funcs;
+#endif
+#ifdef SCUMMVM_AVX2
+extern const YUVToRGBFuncs yuvToRGBAVX2Funcs;
+#endif
+
+/**
+ * The row kernels used by the conversions.
+ * If unset, the first conversion picks the ones best suited to the CPU.
+ */
+extern const YUVToRGBFuncs *yuvToRGBFuncs;
+
+const YUVToRGBFuncs *getYUVToRGBFuncs();
+
+} // End of namespace Graphics
+
+#endif
@@ -23,6 +23,7 @@
 #include "common/algorithm.h"
 #include "common/config-manager.h"
 #include "common/debug.h"
+#include "common/jobsystem.h"
 #include "common/system.h"
 #include "common/taskbar.h"
 #include "common/translation.h"
@@ -46,7 +47,10 @@ enum {
 	// Upper bound (im milliseconds) we want to spend in handleTickle.
 	// Setting this low makes the GUI more responsive but also slows
 	// down the scanning.
-	kMaxScanTime = 50
+	kMaxScanTime = 50,
+
+	// Number of directories listed and hashed at once, per thread.
+	kScanBatchSizePerThread = 4
 };
 
 enum {
@@ -58,6 +62,8 @@ enum {
 
 MassAddDialog::MassAddDialog(const Common::FSNode &startDir)
 	: Dialog("MassAdd"),
+	_nextListedDir(0),
+	_listTimePerDir(0),
 	_dirsScanned(0),
 	_oldGamesCount(0),
 	_dirTotal(0),
@@ -158,6 +164,8 @@ void MassAddDialog::handleCommand(CommandSender *sender, uint32 cmd, uint32 data
 	} else if (cmd == kCancelCmd) {
 		// User cancelled, so we don't do anything and just leave.
 		_games.clear();
+		ADCacheMan.savePersistentCache();
+		ADCacheMan.clearPrefetched();
 		close();
 	} else if (cmd == kListSelectionChangedCmd) {
 		// Select / unselect game from list
@@ -183,21 +191,58 @@ void MassAddDialog::updateGameList() {
 	}
 }
 
+void MassAddDialog::listNextBatch(uint32 timeLeft) {
+	// Directories are listed in batches, so that their I/O can overlap on
+	// the job system. Once the cost of a directory is known, only list as
+	// many as fit into the time left.
+	uint batchSize = g_system->getJobSystem()->getConcurrency() * kScanBatchSizePerThread;
+	if (_listTimePerDir > 0)
+		batchSize = CLIP<uint>(timeLeft * 1000 / _listTimePerDir, 1, batchSize);
+
+	Common::FSList dirs;
+	while (!_scanStack.empty() && dirs.size() < batchSize)
+		dirs.push_back(_scanStack.pop());
+
+	const uint32 start = g_system->getMillis();
+	Common::Array<Common::FSList> contents;
+	Common::Array<bool> listed;
+	EngineMan.listDirectories(dirs, contents, listed);
+
+	const uint32 timePerDir = (g_system->getMillis() - start) * 1000 / dirs.size();
+	_listTimePerDir = (_listTimePerDir + timePerDir) / 2;
+
+	_listedDirs.clear();
+	_listedContents.clear();
+	_nextListedDir = 0;
+	for (uint i = 0; i < dirs.size(); i++) {
+		if (listed[i]) {
+			_listedDirs.push_back(dirs[i]);
+			_listedContents.push_back(contents[i]);
+		}
+	}
+}
+
 void MassAddDialog::handleTickle() {
-	if (_scanStack.empty())
+	if (_scanStack.empty() && _nextListedDir == _listedDirs.size())
 		return;	// We have finished scanning
 
 	uint32 t = g_system->getMillis();
 
-	// Perform a breadth-first scan of the filesystem.
-	while (!_scanStack.empty() && (g_system->getMillis() - t) < kMaxScanTime) {
-		Common::FSNode dir = _scanStack.pop();
+	// Perform a breadth-first scan of the filesystem. The time limit is
+	// checked before every directory.
+	while ((g_system->getMillis() - t) < kMaxScanTime) {
+		if (_nextListedDir == _listedDirs.size()) {
+			if (_scanStack.empty())
+				break;
 
-		Common::FSList files;
-		if (!dir.getChildren(files, Common::FSNode::kListAll)) {
+			listNextBatch(kMaxScanTime - (g_system->getMillis() - t));
 			continue;
 		}
 
+		const Common::FSNode &dir = _listedDirs[_nextListedDir];
+		const Common::FSList &files = _listedContents[_nextListedDir];
+		_nextListedDir++;
+
 		// Run the detector on the dir
 		DetectionResults detectionResults = EngineMan.detectGames(files, (ADGF_WARNING | ADGF_UNSUPPORTED), true);
 
@@ -276,7 +321,11 @@ void MassAddDialog::handleTickle() {
 	// Update the dialog
 	Common::U32String buf;
 
-	if (_scanStack.empty()) {
+	if (_scanStack.empty() && _nextListedDir == _listedDirs.size()) {
+		// Flush the hashes computed during the scan
+		ADCacheMan.savePersistentCache();
+		ADCacheMan.clearPrefetched();
+
 		// Enable the OK button
 		_okButton->setEnabled(true);
 
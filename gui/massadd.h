@@ -52,7 +52,16 @@ private:
 	Common::Stack<Common::FSNode>  _scanStack;
 	DetectedGames _games;
 
+	/** Directories which were listed, but not run through the detectors yet */
+	Common::FSList _listedDirs;
+	Common::Array<Common::FSList> _listedContents;
+	uint _nextListedDir;
+
+	/** Average time spent listing a directory and hashing its files, in microseconds */
+	uint32 _listTimePerDir;
+
 	void updateGameList();
+	void listNextBatch(uint32 timeLeft);
 
 	/**
 	 * Map each path occurring in the config file to the target(s) using that path.
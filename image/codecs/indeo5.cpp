@@ -77,11 +77,16 @@ const Graphics::Surface *Indeo5Decoder::decodeFrame(Common::SeekableReadStream &
 	if (!isIndeo5(stream))
 		return nullptr;
 
-	// Set up the frame data buffer
-	byte *frameData = new byte[stream.size()];
-	stream.read(frameData, stream.size());
-	_ctx._frameData = frameData;
-	_ctx._frameSize = stream.size();
+	// Set up the frame data buffer, parsing in place when the stream allows it
+	uint32 frameSize = stream.size();
+	byte *frameData = nullptr;
+	_ctx._frameData = stream.tryGetContiguousView(frameSize);
+	if (!_ctx._frameData) {
+		frameData = new byte[frameSize];
+		stream.read(frameData, frameSize);
+		_ctx._frameData = frameData;
+	}
+	_ctx._frameSize = frameSize;
 
 	// Set up the GetBits instance for reading the data
 	_ctx._gb = new GetBits(_ctx._frameData, _ctx._frameSize);
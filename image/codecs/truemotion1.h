@@ -50,7 +50,8 @@ private:
 	Graphics::Surface *_surface;
 
 	int _mbChangeBitsRowSize;
-	byte *_buf, *_mbChangeBits, *_indexStream;
+	const byte *_buf, *_mbChangeBits, *_indexStream;
+	byte *_ownedBuf;
 	int _indexStreamSize;
 
 	int _flags;
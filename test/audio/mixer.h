@@ -0,0 +1,128 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixer_intern.h"
+#include "audio/rate_intern.h"
+
+#include "helper.h"
+#include "../null_osystem.h"
+
+class MixerTestSuite : public CxxTest::TestSuite
+{
+	const Audio::MixSamplesFunc *_savedMixSamplesFuncs;
+public:
+	// The tests select the mixing kernels, put back whatever was in use
+	void setUp() {
+		_savedMixSamplesFuncs = Audio::mixSamplesFuncs;
+	}
+
+	void tearDown() {
+		Audio::mixSamplesFuncs = _savedMixSamplesFuncs;
+	}
+
+	void test_parameter_changes_are_visible_before_mixing() {
+		Common::install_null_g_system();
+		Audio::mixSamplesFuncs = Audio::mixSamplesGenericFuncs;
+
+		Audio::MixerImpl mixerImpl(11025);
+		mixerImpl.setReady(true);
+		Audio::Mixer &mixer = mixerImpl;
+
+		int16 *sine = 0;
+		Audio::SoundHandle handle;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &handle, createSineStream<int16>(11025, 1, &sine, false, false), 42, 0);
+
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+		TS_ASSERT(mixer.isSoundIDActive(42));
+		TS_ASSERT(!mixer.isSoundIDActive(43));
+		TS_ASSERT_EQUALS(mixer.getSoundID(handle), 42);
+		TS_ASSERT(mixer.hasActiveChannelOfType(Audio::Mixer::kSFXSoundType));
+		TS_ASSERT(!mixer.hasActiveChannelOfType(Audio::Mixer::kMusicSoundType));
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), 0);
+		TS_ASSERT_EQUALS(mixer.getChannelRate(handle), (uint32)11025);
+
+		// A silent channel mixes silence
+		TS_ASSERT(isSilent(mixerImpl));
+
+		// Queued changes are reported right away and applied by the next mix
+		mixer.setChannelVolume(handle, 200);
+		mixer.setChannelBalance(handle, -50);
+		mixer.setChannelRate(handle, 22050);
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), 200);
+		TS_ASSERT_EQUALS(mixer.getChannelBalance(handle), -50);
+		TS_ASSERT_EQUALS(mixer.getChannelRate(handle), (uint32)22050);
+		TS_ASSERT(!isSilent(mixerImpl));
+
+		mixer.resetChannelRate(handle);
+		TS_ASSERT_EQUALS(mixer.getChannelRate(handle), (uint32)11025);
+
+		mixer.stopHandle(handle);
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+		TS_ASSERT(!mixer.isSoundIDActive(42));
+		TS_ASSERT_EQUALS(mixer.getSoundID(handle), 0);
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), 0);
+
+		// Changes to stopped sounds are ignored
+		mixer.setChannelVolume(handle, 100);
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), 0);
+
+		delete[] sine;
+	}
+
+	void test_full_command_queue() {
+		Common::install_null_g_system();
+		Audio::mixSamplesFuncs = Audio::mixSamplesGenericFuncs;
+
+		Audio::MixerImpl mixerImpl(11025);
+		mixerImpl.setReady(true);
+		Audio::Mixer &mixer = mixerImpl;
+
+		int16 *sine = 0;
+		Audio::SoundHandle handle;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &handle, createSineStream<int16>(11025, 1, &sine, false, false), -1, 255);
+
+		// Without a mixer callback draining the queue, the changes still
+		// have to arrive in order
+		for (int i = 0; i < 1000; i++)
+			mixer.setChannelVolume(handle, i % 200);
+		mixer.setChannelVolume(handle, 0);
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), 0);
+		TS_ASSERT(isSilent(mixerImpl));
+
+		delete[] sine;
+	}
+
+	void test_finished_sounds_are_released() {
+		Common::install_null_g_system();
+		Audio::mixSamplesFuncs = Audio::mixSamplesGenericFuncs;
+
+		Audio::MixerImpl mixerImpl(11025);
+		mixerImpl.setReady(true);
+		Audio::Mixer &mixer = mixerImpl;
+
+		int16 *sine = 0;
+		Audio::SoundHandle handle;
+		mixer.playStream(Audio::Mixer::kSpeechSoundType, &handle, createSineStream<int16>(11025, 1, &sine, false, false));
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+
+		// One second of sound, mixed in chunks
+		int16 buffer[2 * 1024];
+		for (int i = 0; i < 12; i++)
+			mixerImpl.mixCallback((byte *)buffer, sizeof(buffer));
+
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+		TS_ASSERT(!mixer.hasActiveChannelOfType(Audio::Mixer::kSpeechSoundType));
+
+		delete[] sine;
+	}
+
+private:
+	bool isSilent(Audio::MixerImpl &mixer) {
+		int16 buffer[2 * 256];
+		mixer.mixCallback((byte *)buffer, sizeof(buffer));
+
+		for (int i = 0; i < ARRAYSIZE(buffer); i++)
+			if (buffer[i] != 0)
+				return false;
+		return true;
+	}
+};
@@ -0,0 +1,175 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "audio/rate_intern.h"
+#include "common/random.h"
+
+#include "helper.h"
+#include "../null_osystem.h"
+
+class RateConverterTestSuite : public CxxTest::TestSuite
+{
+	const Audio::MixSamplesFunc *_savedMixSamplesFuncs;
+	Audio::DotProductFunc _savedDotProductFunc;
+public:
+	// The tests select the kernels, put back whatever was in use
+	void setUp() {
+		_savedMixSamplesFuncs = Audio::mixSamplesFuncs;
+		_savedDotProductFunc = Audio::dotProductFunc;
+	}
+
+	void tearDown() {
+		Audio::mixSamplesFuncs = _savedMixSamplesFuncs;
+		Audio::dotProductFunc = _savedDotProductFunc;
+	}
+
+	void test_mix_kernels() {
+		Common::install_null_g_system();
+
+#if defined(SCUMMVM_NEON) && !defined(OUTPUT_UNSIGNED_AUDIO)
+		checkKernels(Audio::mixSamplesNEONFuncs);
+#endif
+#if defined(SCUMMVM_SSE2) && !defined(OUTPUT_UNSIGNED_AUDIO)
+		if (instrset_detect() >= 2)
+			checkKernels(Audio::mixSamplesSSE2Funcs);
+#endif
+	}
+
+	void test_copy_convert() {
+		Common::install_null_g_system();
+		Audio::mixSamplesFuncs = Audio::mixSamplesGenericFuncs;
+
+		int16 *sine = 0;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(11025, 1, &sine, false, true);
+		Audio::RateConverter *converter = Audio::makeRateConverter(11025, 11025, true, true, true);
+
+		int16 buffer[2 * 1000];
+		memset(buffer, 0, sizeof(buffer));
+		TS_ASSERT_EQUALS(converter->convert(*s, buffer, 1000, 128, 256), 1000);
+
+		// Reversed stereo, left channel at half volume
+		for (int i = 0; i < 1000; i++) {
+			TS_ASSERT_EQUALS(buffer[i * 2], sine[i * 2 + 1]);
+			TS_ASSERT_EQUALS(buffer[i * 2 + 1], sine[i * 2] * 128 / 256);
+		}
+
+		delete converter;
+		delete s;
+		delete[] sine;
+	}
+
+	void test_interpolate_convert() {
+		Common::install_null_g_system();
+		Audio::mixSamplesFuncs = Audio::mixSamplesGenericFuncs;
+
+		int16 *sine = 0;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(11025, 1, &sine, false, false);
+		Audio::RateConverter *converter = Audio::makeRateConverter(11025, 22050, false, true, false);
+
+		// Mixing a second of audio in odd chunks gives the same result as
+		// upsampling it in one go
+		int16 buffer[2 * 22050];
+		memset(buffer, 0, sizeof(buffer));
+		int pos = 0;
+		while (pos < 22050) {
+			const int chunk = MIN(22050 - pos, 333);
+			TS_ASSERT_EQUALS(converter->convert(*s, buffer + pos * 2, chunk, 256, 256), chunk);
+			pos += chunk;
+		}
+
+		// Every other output sample is an input sample, the others lie
+		// between their neighbours
+		for (int i = 1; i < 11025; i++) {
+			TS_ASSERT_EQUALS(buffer[i * 4], sine[i - 1]);
+			TS_ASSERT_EQUALS(buffer[i * 4 + 1], sine[i - 1]);
+			TS_ASSERT_LESS_THAN_EQUALS(MIN(sine[i - 1], sine[i]), buffer[i * 4 + 2]);
+			TS_ASSERT_LESS_THAN_EQUALS(buffer[i * 4 + 2], MAX(sine[i - 1], sine[i]));
+		}
+
+		delete converter;
+		delete s;
+		delete[] sine;
+	}
+
+	void test_dot_product() {
+		Common::install_null_g_system();
+
+		Common::RandomSource rnd("rate");
+		int16 a[64], b[64];
+		for (int iter = 0; iter < 100; iter++) {
+			for (int i = 0; i < 64; i++) {
+				a[i] = rnd.getRandomNumber(65535) - 32768;
+				b[i] = rnd.getRandomNumber(32767) - 16384;
+			}
+
+			const int32 expected = Audio::dotProductGeneric(a, b, 64);
+#ifdef SCUMMVM_NEON
+			TS_ASSERT_EQUALS(Audio::dotProductNEON(a, b, 64), expected);
+#endif
+#ifdef SCUMMVM_SSE2
+			if (instrset_detect() >= 2)
+				TS_ASSERT_EQUALS(Audio::dotProductSSE2(a, b, 64), expected);
+#endif
+		}
+	}
+
+	void test_sinc_convert() {
+		Common::install_null_g_system();
+		Audio::mixSamplesFuncs = Audio::mixSamplesGenericFuncs;
+		Audio::dotProductFunc = Audio::dotProductGeneric;
+
+		for (int quality = 1; quality <= 3; quality++) {
+			// One period of a slow sine
+			Audio::SeekableAudioStream *s = createSineStream<int16>(1100, 1, nullptr, false, false);
+			Audio::RateConverter *converter = Audio::makeRateConverter(1100, 2200, false, false, false, quality);
+
+			int16 buffer[2300];
+			memset(buffer, 0, sizeof(buffer));
+			int pos = 0, frames;
+			while ((frames = converter->convert(*s, buffer + pos, MIN(2300 - pos, 100), 256, 256)) > 0)
+				pos += frames;
+
+			// The samples held back by the filter come out at the end
+			TS_ASSERT_EQUALS(pos, 2200);
+			TS_ASSERT(!converter->needsDraining());
+
+			// Away from the edges, the output follows the sine closely
+			for (int i = 100; i < 2100; i++) {
+				const int16 expected = (int16)(sin((double)i / 2200 * 2 * M_PI) * 32767);
+				TS_ASSERT_LESS_THAN_EQUALS(ABS(buffer[i] - expected), 8);
+			}
+
+			delete converter;
+			delete s;
+		}
+	}
+
+private:
+	void checkKernels(const Audio::MixSamplesFunc *funcs) {
+		Common::RandomSource rnd("rate");
+		const int maxFrames = 37;
+		int16 in[2 * maxFrames], expected[2 * maxFrames], actual[2 * maxFrames];
+
+		for (int layout = 0; layout < Audio::kMixLayoutCount; layout++) {
+			for (int iter = 0; iter < 200; iter++) {
+				const uint frames = rnd.getRandomNumber(maxFrames);
+				const Audio::st_volume_t volL = rnd.getRandomNumber(Audio::Mixer::kMaxMixerVolume);
+				const Audio::st_volume_t volR = rnd.getRandomNumber(Audio::Mixer::kMaxMixerVolume);
+
+				// Mostly extreme values, to exercise rounding and saturation
+				for (int i = 0; i < 2 * maxFrames; i++) {
+					in[i] = (iter & 1) ? (rnd.getRandomBit() ? 32767 : -32768) : rnd.getRandomNumber(65535) - 32768;
+					expected[i] = actual[i] = rnd.getRandomNumber(65535) - 32768;
+				}
+
+				Audio::mixSamplesGenericFuncs[layout](expected, in, frames, volL, volR);
+				funcs[layout](actual, in, frames, volL, volR);
+				TS_ASSERT_EQUALS(memcmp(expected, actual, sizeof(expected)), 0);
+			}
+		}
+	}
+};
@@ -0,0 +1,212 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/flathashmap.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/debug.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class FlatHashMapTestSuite : public CxxTest::TestSuite
+{
+	static uint32 nextRandom(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	}
+
+	public:
+	void test_empty_clear() {
+		Common::FlatHashMap<int, int> container;
+		TS_ASSERT(container.empty());
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(!container.empty());
+		container.clear();
+		TS_ASSERT(container.empty());
+
+		Common::FlatHashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> container2;
+		TS_ASSERT(container2.empty());
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(!container2.empty());
+		container2.clear(true);
+		TS_ASSERT(container2.empty());
+	}
+
+	void test_contains() {
+		Common::FlatHashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> container;
+		container["foo"] = "bar";
+		container["quux"] = "blub";
+		TS_ASSERT(container.contains("foo"));
+		TS_ASSERT(container.contains("QUUX"));
+		TS_ASSERT(!container.contains("bar"));
+		TS_ASSERT(!container.contains("asdf"));
+		TS_ASSERT_EQUALS(container["Foo"], "bar");
+	}
+
+	void test_add_remove() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		TS_ASSERT(container.contains(1));
+		container.erase(1);
+		TS_ASSERT(!container.contains(1));
+		TS_ASSERT_EQUALS(container.size(), 2U);
+		container[1] = 42;
+		TS_ASSERT_EQUALS(container[1], 42);
+		container.erase(container.find(0));
+		container.erase(1);
+		container.erase(2);
+		TS_ASSERT(container.empty());
+		TS_ASSERT_EQUALS(container.find(2), container.end());
+	}
+
+	void test_lookup_with_default() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+
+		const Common::FlatHashMap<int, int> &containerRef = container;
+
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(0), 17);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(17), 0);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(17, -10), -10);
+
+		int val = 0;
+		TS_ASSERT(containerRef.tryGetVal(0, val));
+		TS_ASSERT_EQUALS(val, 17);
+		TS_ASSERT(!containerRef.tryGetVal(1, val));
+	}
+
+	void test_iterator() {
+		Common::FlatHashMap<int, int> container;
+		TS_ASSERT_EQUALS(container.begin(), container.end());
+
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		container.erase(1);
+		container[1] = 42;
+		container.erase(0);
+		container.erase(1);
+
+		int found = 0;
+		Common::FlatHashMap<int, int>::const_iterator i;
+		for (i = container.begin(); i != container.end(); ++i) {
+			int key = i->_key;
+			TS_ASSERT(key >= 0 && key <= 4);
+			TS_ASSERT(!(found & (1 << key)));
+			found |= 1 << key;
+		}
+		TS_ASSERT(found == 16+8+4);
+	}
+
+	void test_copy() {
+		Common::FlatHashMap<Common::String, int> map1, map2;
+		for (int i = 0; i < 100; i++)
+			map1[Common::String::format("key%d", i)] = i;
+		map1.erase("key50");
+
+		map2 = map1;
+		Common::FlatHashMap<Common::String, int> map3(map2);
+		TS_ASSERT_EQUALS(map3.size(), 99U);
+		TS_ASSERT_EQUALS(map3["key99"], 99);
+		TS_ASSERT(!map3.contains("key50"));
+	}
+
+	void test_against_hashmap() {
+		// Mix inserts and erases over a small key range to exercise growing,
+		// erased slots and rehashing in place
+		Common::FlatHashMap<uint32, uint32> flat;
+		Common::HashMap<uint32, uint32> reference;
+		uint32 seed = 1;
+
+		for (int i = 0; i < 20000; i++) {
+			uint32 key = nextRandom(seed) % 1500;
+			if (nextRandom(seed) % 3) {
+				flat[key] = i;
+				reference[key] = i;
+			} else {
+				flat.erase(key);
+				reference.erase(key);
+			}
+		}
+
+		TS_ASSERT_EQUALS(flat.size(), reference.size());
+		for (Common::HashMap<uint32, uint32>::const_iterator i = reference.begin(); i != reference.end(); ++i)
+			TS_ASSERT_EQUALS(flat.getValOrDefault(i->_key, 0xFFFFFFFF), i->_value);
+
+		uint32 count = 0;
+		for (Common::FlatHashMap<uint32, uint32>::const_iterator i = flat.begin(); i != flat.end(); ++i) {
+			TS_ASSERT(reference.contains(i->_key));
+			count++;
+		}
+		TS_ASSERT_EQUALS(count, reference.size());
+	}
+
+	void test_lookup_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+		// Only builds with SLOW_TESTS run enough iterations for meaningful timings
+#ifdef SLOW_TESTS
+		const int iters = 200;
+#else
+		const int iters = 1;
+#endif
+		const int numKeys = 5000;
+
+		Common::Array<Common::String> keys;
+		for (int i = 0; i < numKeys; i++)
+			keys.push_back(Common::String::format("engines/data/file%05d.dat", i * 7919 % 100000));
+
+		Common::HashMap<Common::String, int, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> hashMap;
+		Common::FlatHashMap<Common::String, int, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> flatMap;
+
+		uint32 start = g_system->getMillis();
+		for (int i = 0; i < iters; i++) {
+			hashMap.clear();
+			for (int j = 0; j < numKeys; j++)
+				hashMap[keys[j]] = j;
+		}
+		uint32 hashInsertTime = g_system->getMillis() - start;
+
+		start = g_system->getMillis();
+		for (int i = 0; i < iters; i++) {
+			flatMap.clear();
+			for (int j = 0; j < numKeys; j++)
+				flatMap[keys[j]] = j;
+		}
+		uint32 flatInsertTime = g_system->getMillis() - start;
+
+		int hashFound = 0, flatFound = 0;
+		start = g_system->getMillis();
+		for (int i = 0; i < iters * 10; i++) {
+			for (int j = 0; j < numKeys; j++)
+				hashFound += hashMap.contains(keys[(j * 31) % numKeys]);
+		}
+		uint32 hashLookupTime = g_system->getMillis() - start;
+
+		start = g_system->getMillis();
+		for (int i = 0; i < iters * 10; i++) {
+			for (int j = 0; j < numKeys; j++)
+				flatFound += flatMap.contains(keys[(j * 31) % numKeys]);
+		}
+		uint32 flatLookupTime = g_system->getMillis() - start;
+
+		TS_ASSERT_EQUALS(hashFound, flatFound);
+
+		debug("HashMap: %d string inserts took %d ms, %d lookups took %d ms", iters * numKeys, hashInsertTime, iters * 10 * numKeys, hashLookupTime);
+		debug("FlatHashMap: %d string inserts took %d ms, %d lookups took %d ms", iters * numKeys, flatInsertTime, iters * 10 * numKeys, flatLookupTime);
+#endif
+	}
+};
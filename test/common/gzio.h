@@ -0,0 +1,353 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/crc.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
+#include "common/random.h"
+#include "common/compression/deflate.h"
+
+/**
+ * Writes deflate data made of the requested kinds of blocks. The contents of
+ * the Huffman coded blocks are random literals and back references, and
+ * every dynamic block uses other code lengths.
+ */
+class DeflateBlockWriter {
+public:
+	DeflateBlockWriter() : _bitBuffer(0), _bitCount(0) {}
+
+	void writeStoredBlocks(const byte *data, uint32 size, bool last) {
+		do {
+			const uint32 blockSize = MIN<uint32>(size, 0xFFFF);
+			putBits(last && blockSize == size, 1);
+			putBits(0, 2);
+			alignToByte();
+			putBits(blockSize, 16);
+			putBits(~blockSize & 0xFFFF, 16);
+			for (uint32 i = 0; i < blockSize; i++)
+				putBits(data[i], 8);
+
+			data += blockSize;
+			size -= blockSize;
+		} while (size > 0);
+	}
+
+	void writeFixedBlock(Common::RandomSource &rnd, Common::Array<byte> &data, uint32 size, bool last) {
+		uint8 literalLengths[288], distanceLengths[30];
+		for (uint i = 0; i < 288; i++)
+			literalLengths[i] = (i < 144 || i >= 280) ? 8 : (i < 256 ? 9 : 7);
+		for (uint i = 0; i < 30; i++)
+			distanceLengths[i] = 5;
+
+		putBits(last, 1);
+		putBits(1, 2);
+		writeCodes(rnd, data, size, literalLengths, 288, distanceLengths);
+	}
+
+	void writeDynamicBlock(Common::RandomSource &rnd, Common::Array<byte> &data, uint32 size, uint variant, bool last) {
+		// Complete codes, with a few longer literal/length codes and a few
+		// shorter distance codes picked by the variant
+		uint8 lengths[286 + 30];
+		uint8 *literalLengths = lengths, *distanceLengths = lengths + 286;
+		for (uint i = 0; i < 286; i++)
+			literalLengths[i] = (i + variant * 97) % 286 < 60 ? 9 : 8;
+		for (uint i = 0; i < 30; i++)
+			distanceLengths[i] = (i + variant * 7) % 30 < 2 ? 4 : 5;
+
+		putBits(last, 1);
+		putBits(2, 2);
+		putBits(286 - 257, 5);
+		putBits(30 - 1, 5);
+
+		// The code lengths 4, 5, 8 and 9 each get a 2 bit code, the others are unused
+		static const uint8 order[] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4 };
+		putBits(ARRAYSIZE(order) - 4, 4);
+		for (uint i = 0; i < ARRAYSIZE(order); i++) {
+			const uint8 symbol = order[i];
+			putBits((symbol == 4 || symbol == 5 || symbol == 8 || symbol == 9) ? 2 : 0, 3);
+		}
+
+		for (uint i = 0; i < ARRAYSIZE(lengths); i++) {
+			static const uint8 codes[] = { 0, 0, 0, 0, 0, 1, 0, 0, 2, 3 };
+			putCode(codes[lengths[i]], 2);
+		}
+
+		writeCodes(rnd, data, size, literalLengths, 286, distanceLengths);
+	}
+
+	/** Return the deflate data, padded to a whole byte. */
+	const Common::Array<byte> &finish() {
+		alignToByte();
+		return _output;
+	}
+
+private:
+	void putBits(uint32 value, uint count) {
+		_bitBuffer |= value << _bitCount;
+		_bitCount += count;
+		while (_bitCount >= 8) {
+			_output.push_back(_bitBuffer & 0xFF);
+			_bitBuffer >>= 8;
+			_bitCount -= 8;
+		}
+	}
+
+	/** Write a Huffman code, which is stored starting with its most significant bit. */
+	void putCode(uint32 code, uint length) {
+		uint32 reversed = 0;
+		for (uint i = 0; i < length; i++)
+			reversed |= ((code >> i) & 1) << (length - 1 - i);
+		putBits(reversed, length);
+	}
+
+	void alignToByte() {
+		if (_bitCount > 0)
+			putBits(0, 8 - _bitCount);
+	}
+
+	/** Assign the canonical codes of RFC 1951 to the given code lengths. */
+	static void buildCodes(const uint8 *lengths, uint count, uint32 *codes) {
+		uint32 lengthCount[16] = {}, nextCode[16];
+		for (uint i = 0; i < count; i++)
+			lengthCount[lengths[i]]++;
+
+		lengthCount[0] = 0;
+		uint32 code = 0;
+		for (uint bits = 1; bits < 16; bits++) {
+			code = (code + lengthCount[bits - 1]) << 1;
+			nextCode[bits] = code;
+		}
+
+		for (uint i = 0; i < count; i++)
+			if (lengths[i])
+				codes[i] = nextCode[lengths[i]]++;
+	}
+
+	/** Find the length or distance code covering @p value. */
+	static uint findCode(const uint16 *base, uint count, uint32 value) {
+		uint code = 0;
+		while (code + 1 < count && base[code + 1] <= value)
+			code++;
+		return code;
+	}
+
+	void writeCodes(Common::RandomSource &rnd, Common::Array<byte> &data, uint32 size,
+			const uint8 *literalLengths, uint literalCount, const uint8 *distanceLengths) {
+		static const uint16 lengthBase[29] = {
+			3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+			35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+		};
+		static const uint8 lengthExtra[29] = {
+			0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+			3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+		};
+		static const uint16 distanceBase[30] = {
+			1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+			257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+		};
+		static const uint8 distanceExtra[30] = {
+			0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+			7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+		};
+
+		uint32 literalCodes[288], distanceCodes[30];
+		buildCodes(literalLengths, literalCount, literalCodes);
+		buildCodes(distanceLengths, 30, distanceCodes);
+
+		const uint32 end = data.size() + size;
+		while (data.size() < end) {
+			const uint32 left = end - data.size();
+			if (data.empty() || left < 3 || rnd.getRandomBit()) {
+				const byte literal = rnd.getRandomNumber(255);
+				putCode(literalCodes[literal], literalLengths[literal]);
+				data.push_back(literal);
+				continue;
+			}
+
+			// Short and long copies, from anywhere in the window
+			uint32 length = rnd.getRandomBit() ? rnd.getRandomNumberRng(3, 10) : rnd.getRandomNumberRng(3, 258);
+			length = MIN(length, left);
+			const uint32 distance = rnd.getRandomNumberRng(1, MIN<uint32>(data.size(), 32768));
+
+			const uint lengthCode = findCode(lengthBase, 29, length);
+			putCode(literalCodes[257 + lengthCode], literalLengths[257 + lengthCode]);
+			putBits(length - lengthBase[lengthCode], lengthExtra[lengthCode]);
+
+			const uint distanceCode = findCode(distanceBase, 30, distance);
+			putCode(distanceCodes[distanceCode], distanceLengths[distanceCode]);
+			putBits(distance - distanceBase[distanceCode], distanceExtra[distanceCode]);
+
+			for (uint32 i = 0; i < length; i++) {
+				const byte value = data[data.size() - distance];
+				data.push_back(value);
+			}
+		}
+
+		putCode(literalCodes[256], literalLengths[256]);
+	}
+
+	Common::Array<byte> _output;
+	uint32 _bitBuffer;
+	uint _bitCount;
+};
+
+class GzioTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+		// The built-in inflater records a checkpoint every MiB. Blocks of
+		// each kind span one of them.
+		static const uint32 kBlockSize = 223101;
+		static const uint kBlockCount = 16;
+
+		Common::RandomSource rnd("gzio");
+		DeflateBlockWriter writer;
+
+		_data.clear();
+		_data.reserve(kBlockSize * kBlockCount);
+		for (uint i = 0; i < kBlockCount; i++) {
+			const bool last = (i == kBlockCount - 1);
+			switch (i % 3) {
+			case 0: {
+				const uint32 start = _data.size();
+				for (uint32 j = 0; j < kBlockSize; j++)
+					_data.push_back(rnd.getRandomNumber(255));
+				writer.writeStoredBlocks(&_data[start], kBlockSize, last);
+				break;
+			}
+			case 1:
+				writer.writeFixedBlock(rnd, _data, kBlockSize, last);
+				break;
+			default:
+				writer.writeDynamicBlock(rnd, _data, kBlockSize, i, last);
+				break;
+			}
+		}
+
+		const Common::Array<byte> &deflated = writer.finish();
+		static const byte header[] = { 0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 3 };
+		_gzip.clear();
+		for (uint i = 0; i < ARRAYSIZE(header); i++)
+			_gzip.push_back(header[i]);
+		_gzip.push_back(deflated);
+
+		const uint32 crc = Common::CRC32().crcFast(_data.data(), _data.size());
+		const uint32 size = _data.size();
+		for (uint i = 0; i < 4; i++)
+			_gzip.push_back((crc >> (8 * i)) & 0xFF);
+		for (uint i = 0; i < 4; i++)
+			_gzip.push_back((size >> (8 * i)) & 0xFF);
+	}
+
+	void test_linear_read() {
+		Common::ScopedPtr<Common::SeekableReadStream> stream(openStream());
+		TS_ASSERT(stream.get() != nullptr);
+		if (!stream)
+			return;
+
+		TS_ASSERT_EQUALS(stream->size(), (int64)_data.size());
+
+		Common::Array<byte> buffer(_data.size() + 100);
+		TS_ASSERT_EQUALS(stream->read(buffer.data(), buffer.size()), _data.size());
+		TS_ASSERT(stream->eos());
+		TS_ASSERT(!stream->err());
+		TS_ASSERT_EQUALS(memcmp(buffer.data(), _data.data(), _data.size()), 0);
+	}
+
+	void test_random_seeks() {
+		checkRandomSeeks(true);
+	}
+
+	void test_checkpoint_boundaries() {
+		checkCheckpointBoundaries(true);
+	}
+
+	// The same through the default decompressor, which is zlib when available
+	void test_compressed_linear_read() {
+		Common::ScopedPtr<Common::SeekableReadStream> stream(openStream(false));
+		TS_ASSERT(stream.get() != nullptr);
+		if (!stream)
+			return;
+
+		Common::Array<byte> buffer(_data.size() + 100);
+		TS_ASSERT_EQUALS(stream->read(buffer.data(), buffer.size()), _data.size());
+		TS_ASSERT(stream->eos());
+		TS_ASSERT_EQUALS(memcmp(buffer.data(), _data.data(), _data.size()), 0);
+	}
+
+	void test_compressed_random_seeks() {
+		checkRandomSeeks(false);
+	}
+
+	void test_compressed_checkpoint_boundaries() {
+		checkCheckpointBoundaries(false);
+	}
+
+private:
+	Common::SeekableReadStream *openStream(bool builtIn = true) {
+		Common::SeekableReadStream *compressed = new Common::MemoryReadStream(_gzip.data(), _gzip.size());
+		if (builtIn)
+			return Common::wrapGzioReadStream(compressed);
+		return Common::wrapCompressedReadStream(compressed);
+	}
+
+	void checkRandomSeeks(bool builtIn) {
+		// Once after a linear read, which recorded all checkpoints, and once
+		// recording them while seeking
+		for (uint pass = 0; pass < 2; pass++) {
+			Common::ScopedPtr<Common::SeekableReadStream> stream(openStream(builtIn));
+			TS_ASSERT(stream.get() != nullptr);
+			if (!stream)
+				return;
+
+			if (pass == 0) {
+				Common::Array<byte> buffer(_data.size());
+				TS_ASSERT_EQUALS(stream->read(buffer.data(), buffer.size()), _data.size());
+			}
+
+			Common::RandomSource rnd("gziopass");
+			for (uint i = 0; i < 100; i++)
+				checkRead(*stream, rnd.getRandomNumber(_data.size() - 1), rnd.getRandomNumberRng(1, 70000));
+		}
+	}
+
+	void checkCheckpointBoundaries(bool builtIn) {
+		Common::ScopedPtr<Common::SeekableReadStream> stream(openStream(builtIn));
+		TS_ASSERT(stream.get() != nullptr);
+		if (!stream)
+			return;
+
+		// Backward from the end, then forward from the start
+		for (int checkpoint = 3; checkpoint >= 1; checkpoint--) {
+			const uint32 offset = checkpoint * 0x100000;
+			checkRead(*stream, offset - 1, 2);
+			checkRead(*stream, offset, 0x8000);
+			checkRead(*stream, offset - 0x8000, 0x10000);
+		}
+
+		for (int checkpoint = 1; checkpoint <= 3; checkpoint++) {
+			const uint32 offset = checkpoint * 0x100000;
+			checkRead(*stream, offset + 0x7FFF, 3);
+			checkRead(*stream, offset - 5, 10);
+		}
+
+		TS_ASSERT(stream->seek(-10, SEEK_END));
+		byte buffer[16];
+		TS_ASSERT_EQUALS(stream->read(buffer, sizeof(buffer)), 10u);
+		TS_ASSERT(stream->eos());
+		TS_ASSERT_EQUALS(memcmp(buffer, &_data[_data.size() - 10], 10), 0);
+	}
+
+	void checkRead(Common::SeekableReadStream &stream, uint32 offset, uint32 length) {
+		const uint32 expected = MIN<uint32>(length, _data.size() - offset);
+		Common::Array<byte> buffer(length);
+
+		TS_ASSERT(stream.seek(offset, SEEK_SET));
+		TS_ASSERT_EQUALS(stream.pos(), (int64)offset);
+		TS_ASSERT_EQUALS(stream.read(buffer.data(), length), expected);
+		TS_ASSERT_EQUALS(memcmp(buffer.data(), &_data[offset], expected), 0);
+		TS_ASSERT(!stream.err());
+	}
+
+	Common::Array<byte> _data;
+	Common::Array<byte> _gzip;
+};
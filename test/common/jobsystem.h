@@ -0,0 +1,113 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/jobsystem.h"
+
+#ifdef HAS_PTHREAD
+#include "backends/jobs/pthread/pthread-jobs.h"
+#endif
+
+static void incrementJob(void *refCon, uint index) {
+	((uint *)refCon)[index]++;
+}
+
+static void spinJob(void *refCon, uint index) {
+	const volatile bool *release = (const bool *)refCon;
+	while (!*release) {
+	}
+}
+
+class JobSystemTestSuite : public CxxTest::TestSuite {
+	void checkParallelFor(Common::JobSystem &jobSystem, uint count, uint grainSize) {
+		Common::Array<uint> values(count, 0);
+		jobSystem.parallelFor(count, incrementJob, values.data(), grainSize);
+		for (uint i = 0; i < count; i++)
+			TS_ASSERT_EQUALS(values[i], 1u);
+	}
+
+	void checkGroup(Common::JobSystem &jobSystem) {
+		uint values[64] = {};
+		Common::JobSystem::JobGroup group;
+		for (uint i = 0; i < 64; i++)
+			jobSystem.submit(group, incrementJob, values, i);
+		jobSystem.wait(group);
+		for (uint i = 0; i < 64; i++)
+			TS_ASSERT_EQUALS(values[i], 1u);
+	}
+
+public:
+	void test_serial() {
+		Common::JobSystem jobSystem;
+		TS_ASSERT_EQUALS(jobSystem.getWorkerCount(), 0u);
+		TS_ASSERT_EQUALS(jobSystem.getConcurrency(), 1u);
+		checkParallelFor(jobSystem, 0, 0);
+		checkParallelFor(jobSystem, 1000, 0);
+		checkGroup(jobSystem);
+	}
+
+	void test_functor() {
+		Common::JobSystem jobSystem;
+		uint values[16] = {};
+		jobSystem.parallelFor(16, [&](uint i) { values[i] = i * 2; });
+		for (uint i = 0; i < 16; i++)
+			TS_ASSERT_EQUALS(values[i], i * 2);
+	}
+
+#ifdef HAS_PTHREAD
+	void test_pthread() {
+		Common::JobSystem *jobSystem = createPthreadJobSystem(3);
+		TS_ASSERT_EQUALS(jobSystem->getWorkerCount(), 3u);
+		checkParallelFor(*jobSystem, 1, 0);
+		checkParallelFor(*jobSystem, 1000, 0);
+		checkParallelFor(*jobSystem, 1000, 7);
+		checkGroup(*jobSystem);
+		delete jobSystem;
+	}
+
+	void test_pthread_nested() {
+		Common::JobSystem *jobSystem = createPthreadJobSystem(2);
+		Common::Array<uint> values(32 * 32, 0);
+		// Waiting from within a job must not deadlock, even with every worker busy.
+		jobSystem->parallelFor(32, [&](uint i) {
+			jobSystem->parallelFor(32, incrementJob, values.data() + i * 32, 1);
+		}, 1);
+		for (uint i = 0; i < values.size(); i++)
+			TS_ASSERT_EQUALS(values[i], 1u);
+		delete jobSystem;
+	}
+
+	void test_pthread_wait_own_group() {
+		Common::JobSystem *jobSystem = createPthreadJobSystem(1);
+		bool release = false;
+		uint values[2] = {};
+
+		// Keep the only worker busy, so that the waiting thread has to run
+		// the jobs of its group itself
+		Common::JobSystem::JobGroup busyGroup, otherGroup, group;
+		jobSystem->submit(busyGroup, spinJob, &release);
+		jobSystem->submit(otherGroup, incrementJob, values, 0);
+		jobSystem->submit(group, incrementJob, values, 1);
+		jobSystem->wait(group);
+		TS_ASSERT_EQUALS(values[0], 0u);
+		TS_ASSERT_EQUALS(values[1], 1u);
+
+		release = true;
+		jobSystem->wait(busyGroup);
+		jobSystem->wait(otherGroup);
+		TS_ASSERT_EQUALS(values[0], 1u);
+		delete jobSystem;
+	}
+
+	void test_pthread_shutdown() {
+		Common::JobSystem *jobSystem = createPthreadJobSystem(2);
+		Common::Array<uint> values(1000, 0);
+		// The queued jobs still run when the job system is destroyed.
+		Common::JobSystem::JobGroup group;
+		for (uint i = 0; i < values.size(); i++)
+			jobSystem->submit(group, incrementJob, values.data(), i);
+		delete jobSystem;
+		for (uint i = 0; i < values.size(); i++)
+			TS_ASSERT_EQUALS(values[i], 1u);
+	}
+#endif
+};
@@ -104,4 +104,23 @@ class MemoryReadStreamTestSuite : public CxxTest::TestSuite {
 		ms.seek(0, SEEK_SET);
 		TS_ASSERT(!ms.eos());
 	}
+
+	void test_contiguous_view() {
+		byte contents[] = { 1, 2, 3, 4, 5, 6, 7 };
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+
+		ms.seek(2);
+		const byte *view = ms.tryGetContiguousView(3);
+		TS_ASSERT_EQUALS(view, contents + 2);
+		TS_ASSERT_EQUALS(ms.pos(), 5);
+
+		// Requests past the end fail and leave the position alone
+		TS_ASSERT(!ms.tryGetContiguousView(3));
+		TS_ASSERT_EQUALS(ms.pos(), 5);
+		TS_ASSERT(!ms.eos());
+
+		TS_ASSERT_EQUALS(ms.tryGetContiguousView(2), contents + 5);
+		TS_ASSERT_EQUALS(ms.readByte(), 0);
+		TS_ASSERT(ms.eos());
+	}
 };
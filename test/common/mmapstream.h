@@ -0,0 +1,130 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#if defined(POSIX) && defined(HAS_MMAP)
+
+#include "backends/fs/posix/posix-mmapstream.h"
+#include "common/fs.h"
+
+#include "../null_osystem.h"
+
+class PosixMmapStreamTestSuite : public CxxTest::TestSuite {
+public:
+	void test_seek_and_read() {
+		Common::install_null_g_system();
+
+		const char *path = "mmapstream-test-large.bin";
+		const uint32 size = 1024 * 1024 + 123;
+		writeFile(path, size);
+
+		PosixMmapStream *stream = PosixMmapStream::makeFromPath(path);
+		TS_ASSERT(stream != nullptr);
+		if (stream) {
+			TS_ASSERT_EQUALS(stream->size(), (int64)size);
+			for (uint32 i = 0; i < size; i += 4099)
+				TS_ASSERT_EQUALS(stream->getData()[i], patternByte(i));
+
+			byte buffer[16];
+			TS_ASSERT(stream->seek(500000, SEEK_SET));
+			TS_ASSERT_EQUALS(stream->read(buffer, 16), 16u);
+			checkPattern(buffer, 500000, 16);
+
+			TS_ASSERT(stream->seek(-1000, SEEK_CUR));
+			TS_ASSERT_EQUALS(stream->pos(), (int64)(500000 + 16 - 1000));
+			TS_ASSERT_EQUALS(stream->read(buffer, 16), 16u);
+			checkPattern(buffer, 500000 + 16 - 1000, 16);
+
+			TS_ASSERT(stream->seek(-10, SEEK_END));
+			TS_ASSERT_EQUALS(stream->read(buffer, 10), 10u);
+			checkPattern(buffer, size - 10, 10);
+			TS_ASSERT(!stream->eos());
+
+			// Reading past the end returns what is left and sets eos
+			TS_ASSERT(stream->seek(size - 5, SEEK_SET));
+			TS_ASSERT_EQUALS(stream->read(buffer, 16), 5u);
+			checkPattern(buffer, size - 5, 5);
+			TS_ASSERT(stream->eos());
+			TS_ASSERT_EQUALS(stream->read(buffer, 16), 0u);
+
+			// Seeking clears it again
+			TS_ASSERT(stream->seek(0, SEEK_SET));
+			TS_ASSERT(!stream->eos());
+			TS_ASSERT_EQUALS(stream->readByte(), patternByte(0));
+
+			delete stream;
+		}
+
+		remove(path);
+	}
+
+	void test_small_files_are_not_mapped() {
+		Common::install_null_g_system();
+
+		const char *emptyPath = "mmapstream-test-empty.bin";
+		const char *smallPath = "mmapstream-test-small.bin";
+		writeFile(emptyPath, 0);
+		writeFile(smallPath, 1000);
+
+		TS_ASSERT(PosixMmapStream::makeFromPath(emptyPath) == nullptr);
+		TS_ASSERT(PosixMmapStream::makeFromPath(smallPath) == nullptr);
+		TS_ASSERT(PosixMmapStream::makeFromPath("mmapstream-test-missing.bin") == nullptr);
+
+		// The nodes fall back to reading them
+		Common::SeekableReadStream *stream = Common::FSNode(emptyPath).createMappedReadStream();
+		TS_ASSERT(stream != nullptr);
+		if (stream) {
+			byte buffer[16];
+			TS_ASSERT_EQUALS(stream->size(), 0);
+			TS_ASSERT_EQUALS(stream->read(buffer, 16), 0u);
+			TS_ASSERT(stream->eos());
+			delete stream;
+		}
+
+		stream = Common::FSNode(smallPath).createMappedReadStream();
+		TS_ASSERT(stream != nullptr);
+		if (stream) {
+			byte buffer[16];
+			TS_ASSERT_EQUALS(stream->size(), 1000);
+			TS_ASSERT(stream->seek(990, SEEK_SET));
+			TS_ASSERT_EQUALS(stream->read(buffer, 16), 10u);
+			checkPattern(buffer, 990, 10);
+			TS_ASSERT(stream->eos());
+			delete stream;
+		}
+
+		remove(emptyPath);
+		remove(smallPath);
+	}
+
+private:
+	static byte patternByte(uint32 pos) {
+		return (byte)(pos * 7 + (pos >> 8));
+	}
+
+	void checkPattern(const byte *buffer, uint32 pos, uint32 count) {
+		for (uint32 i = 0; i < count; i++)
+			TS_ASSERT_EQUALS(buffer[i], patternByte(pos + i));
+	}
+
+	void writeFile(const char *path, uint32 size) {
+		Common::SeekableWriteStream *out = Common::FSNode(path).createWriteStream();
+		TS_ASSERT(out != nullptr);
+		if (!out)
+			return;
+
+		byte buffer[4096];
+		for (uint32 pos = 0; pos < size; pos += sizeof(buffer)) {
+			const uint32 count = MIN<uint32>(size - pos, sizeof(buffer));
+			for (uint32 i = 0; i < count; i++)
+				buffer[i] = patternByte(pos + i);
+			out->write(buffer, count);
+		}
+		out->finalize();
+		delete out;
+	}
+};
+
+#endif
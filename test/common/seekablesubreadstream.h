@@ -70,4 +70,32 @@ class SeekableSubReadStreamTestSuite : public CxxTest::TestSuite {
 		b = ssrs.readByte();
 		TS_ASSERT_EQUALS(b, 1);
 	}
+
+	void test_contiguous_view() {
+		byte contents[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		Common::MemoryReadStream ms(contents, 10);
+
+		Common::SeekableSubReadStream ssrs(&ms, 2, 8);
+
+		ssrs.seek(1);
+		const byte *view = ssrs.tryGetContiguousView(4);
+		TS_ASSERT_EQUALS(view, contents + 3);
+		TS_ASSERT_EQUALS(ssrs.pos(), 5);
+		TS_ASSERT_EQUALS(ssrs.readByte(), 7);
+
+		// The view must not extend past the end of the substream
+		TS_ASSERT(!ssrs.tryGetContiguousView(3));
+		TS_ASSERT_EQUALS(ssrs.pos(), 6);
+
+		// Views are passed through nested substreams
+		Common::SeekableSubReadStream nested(&ssrs, 1, 6);
+		TS_ASSERT_EQUALS(nested.tryGetContiguousView(2), contents + 3);
+		TS_ASSERT_EQUALS(nested.pos(), 2);
+
+		// Safe substreams reposition the parent first
+		Common::SafeSeekableSubReadStream safe(&ms, 4, 10);
+		ms.seek(0);
+		TS_ASSERT_EQUALS(safe.tryGetContiguousView(6), contents + 4);
+		TS_ASSERT_EQUALS(safe.pos(), 6);
+	}
 };
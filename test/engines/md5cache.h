@@ -0,0 +1,125 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "engines/md5cache.h"
+
+class PersistentMD5CacheTestSuite : public CxxTest::TestSuite {
+public:
+	void test_round_trip() {
+		PersistentMD5Cache cache(100);
+		TS_ASSERT(!cache.isDirty());
+
+		cache.store("d:/games/monkey/000.lfl:0", 1234, 1700000000, 1234, "0123456789abcdef0123456789abcdef");
+		cache.store("t:/games/with\ttab/data.bin:5000", 5000000000ULL, -5, 5000, "fedcba9876543210fedcba9876543210");
+		TS_ASSERT(cache.isDirty());
+		TS_ASSERT_EQUALS(cache.size(), 2u);
+
+		// Lines can't hold line breaks
+		cache.store("d:/games/bad\nname:0", 1, 1, 1, "00000000000000000000000000000000");
+		TS_ASSERT_EQUALS(cache.size(), 2u);
+
+		PersistentMD5Cache loaded(100);
+		reload(cache, loaded);
+		TS_ASSERT(!cache.isDirty());
+		TS_ASSERT(!loaded.isDirty());
+		TS_ASSERT_EQUALS(loaded.size(), 2u);
+
+		const PersistentMD5Cache::Entry *entry = loaded.find("d:/games/monkey/000.lfl:0", 1234, 1700000000);
+		TS_ASSERT(entry != nullptr);
+		if (entry) {
+			TS_ASSERT_EQUALS(entry->size, 1234);
+			TS_ASSERT_EQUALS(entry->md5, "0123456789abcdef0123456789abcdef");
+		}
+
+		entry = loaded.find("t:/games/with\ttab/data.bin:5000", 5000000000ULL, -5);
+		TS_ASSERT(entry != nullptr);
+		if (entry) {
+			TS_ASSERT_EQUALS(entry->size, 5000);
+			TS_ASSERT_EQUALS(entry->md5, "fedcba9876543210fedcba9876543210");
+		}
+
+		// Storing the same properties again changes nothing
+		loaded.store("d:/games/monkey/000.lfl:0", 1234, 1700000000, 1234, "0123456789abcdef0123456789abcdef");
+		TS_ASSERT(loaded.use("d:/games/monkey/000.lfl:0", 1234, 1700000000) != nullptr);
+		TS_ASSERT(!loaded.isDirty());
+	}
+
+	void test_invalidation() {
+		PersistentMD5Cache cache(100);
+		cache.store("d:/games/monkey/000.lfl:0", 1234, 1700000000, 1234, "0123456789abcdef0123456789abcdef");
+
+		// A changed size or modification time hides the entry
+		TS_ASSERT(cache.find("d:/games/monkey/000.lfl:0", 1234, 1700000000) != nullptr);
+		TS_ASSERT(cache.find("d:/games/monkey/000.lfl:0", 1235, 1700000000) == nullptr);
+		TS_ASSERT(cache.find("d:/games/monkey/000.lfl:0", 1234, 1700000001) == nullptr);
+		TS_ASSERT(cache.use("d:/games/monkey/000.lfl:0", 1234, 1700000001) == nullptr);
+		TS_ASSERT(cache.find("d:/games/monkey/001.lfl:0", 1234, 1700000000) == nullptr);
+
+		// Until the file is hashed again
+		PersistentMD5Cache loaded(100);
+		reload(cache, loaded);
+		loaded.store("d:/games/monkey/000.lfl:0", 1234, 1700000001, 1234, "00112233445566778899aabbccddeeff");
+		TS_ASSERT(loaded.isDirty());
+		TS_ASSERT(loaded.find("d:/games/monkey/000.lfl:0", 1234, 1700000000) == nullptr);
+		const PersistentMD5Cache::Entry *entry = loaded.find("d:/games/monkey/000.lfl:0", 1234, 1700000001);
+		TS_ASSERT(entry != nullptr);
+		if (entry)
+			TS_ASSERT_EQUALS(entry->md5, "00112233445566778899aabbccddeeff");
+
+		// Files of another format or version are ignored
+		static const char oldCache[] = "# ScummVM detection MD5 cache v1\n"
+			"0123456789abcdef0123456789abcdef\t1234\t1234\t1700000000\td:/games/monkey/000.lfl:0\n";
+		Common::MemoryReadStream stream((const byte *)oldCache, sizeof(oldCache) - 1);
+		TS_ASSERT(!loaded.load(stream));
+		TS_ASSERT_EQUALS(loaded.size(), 0u);
+
+		// As are broken lines
+		static const char brokenCache[] = "# ScummVM detection MD5 cache v2\n"
+			"0123456789abcdef0123456789abcdef\t1234\tx\t1700000000\t1\td:/games/monkey/000.lfl:0\n"
+			"0123456789abcdef0123456789abcdef\t1234\t1234\t1700000000\t1\n"
+			"0123456789abcdef0123456789abcdef\t1234\t1234\t1700000000\t1\td:/games/monkey/001.lfl:0\n";
+		Common::MemoryReadStream brokenStream((const byte *)brokenCache, sizeof(brokenCache) - 1);
+		TS_ASSERT(loaded.load(brokenStream));
+		TS_ASSERT_EQUALS(loaded.size(), 1u);
+		TS_ASSERT(loaded.find("d:/games/monkey/001.lfl:0", 1234, 1700000000) != nullptr);
+	}
+
+	void test_lru_eviction() {
+		PersistentMD5Cache cache(3);
+		for (int i = 0; i < 3; i++)
+			cache.store(Common::String::format("file%d", i), i, i, i, "0123456789abcdef0123456789abcdef");
+
+		// file0 was used last, so file1 is the least recently used entry
+		TS_ASSERT(cache.use("file0", 0, 0) != nullptr);
+		cache.store("file3", 3, 3, 3, "0123456789abcdef0123456789abcdef");
+		TS_ASSERT_EQUALS(cache.size(), 4u);
+
+		PersistentMD5Cache loaded(3);
+		reload(cache, loaded);
+		TS_ASSERT_EQUALS(cache.size(), 3u);
+		TS_ASSERT_EQUALS(loaded.size(), 3u);
+		TS_ASSERT(loaded.find("file0", 0, 0) != nullptr);
+		TS_ASSERT(loaded.find("file1", 1, 1) == nullptr);
+		TS_ASSERT(loaded.find("file2", 2, 2) != nullptr);
+		TS_ASSERT(loaded.find("file3", 3, 3) != nullptr);
+
+		// The use order survives the round trip
+		TS_ASSERT(loaded.use("file2", 2, 2) != nullptr);
+		loaded.store("file4", 4, 4, 4, "0123456789abcdef0123456789abcdef");
+		PersistentMD5Cache reloaded(3);
+		reload(loaded, reloaded);
+		TS_ASSERT(reloaded.find("file0", 0, 0) == nullptr);
+		TS_ASSERT(reloaded.find("file2", 2, 2) != nullptr);
+		TS_ASSERT(reloaded.find("file3", 3, 3) != nullptr);
+		TS_ASSERT(reloaded.find("file4", 4, 4) != nullptr);
+	}
+
+private:
+	void reload(PersistentMD5Cache &from, PersistentMD5Cache &to) {
+		Common::MemoryWriteStreamDynamic out(DisposeAfterUse::YES);
+		from.save(out);
+
+		Common::MemoryReadStream in(out.getData(), out.size());
+		TS_ASSERT(to.load(in));
+	}
+};
@@ -0,0 +1,68 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#ifdef USE_TINYGL
+
+#include "common/random.h"
+#include "graphics/tinygl/zbuffer.h"
+
+class TinyGLDepthSpanTestSuite : public CxxTest::TestSuite {
+public:
+	void test_depth_span_kernels() {
+#ifdef SCUMMVM_NEON
+		checkKernel(TinyGL::FrameBuffer::depthSpanNEON);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			checkKernel(TinyGL::FrameBuffer::depthSpanSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			checkKernel(TinyGL::FrameBuffer::depthSpanAVX2);
+#endif
+	}
+
+	void checkKernel(TinyGL::FrameBuffer::DepthSpanFunc kernel) {
+		static const int depthFuncs[] = {
+			TGL_NEVER, TGL_LESS, TGL_EQUAL, TGL_LEQUAL,
+			TGL_GREATER, TGL_NOTEQUAL, TGL_GEQUAL, TGL_ALWAYS
+		};
+
+		Common::RandomSource rnd("depthspan");
+		uint zbuf[32], expected[32], actual[32];
+
+		for (uint f = 0; f < ARRAYSIZE(depthFuncs); f++) {
+			for (int count = 1; count <= 32; count++) {
+				for (int depthWrite = 0; depthWrite < 2; depthWrite++) {
+					// Values close to the source depth make EQUAL and the
+					// boundaries of the other tests come up. Large steps make
+					// the source depth wrap around, and the top bit is set to
+					// catch signed comparisons.
+					const uint z = rnd.getRandomNumber(0xffffffff);
+					const int dzdx = (count & 1) ? (int)rnd.getRandomNumber(64) - 32 : (int)rnd.getRandomNumber(0xffffffff);
+					uint zSrc = z;
+					for (int i = 0; i < 32; i++) {
+						zbuf[i] = rnd.getRandomBit() ? zSrc : rnd.getRandomNumber(0xffffffff);
+						if ((i % 5) == 0)
+							zbuf[i] ^= 0x80000000;
+						zSrc += dzdx;
+					}
+
+					memcpy(expected, zbuf, sizeof(zbuf));
+					memcpy(actual, zbuf, sizeof(zbuf));
+					const uint32 expectedMask = TinyGL::FrameBuffer::depthSpanGeneric(expected, z, dzdx, count, depthFuncs[f], depthWrite);
+					const uint32 actualMask = kernel(actual, z, dzdx, count, depthFuncs[f], depthWrite);
+
+					TS_ASSERT_EQUALS(actualMask, expectedMask);
+					TS_ASSERT_EQUALS(memcmp(actual, expected, sizeof(zbuf)), 0);
+				}
+			}
+		}
+	}
+};
+
+#endif
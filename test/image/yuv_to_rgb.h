@@ -0,0 +1,85 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/random.h"
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include "../null_osystem.h"
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite {
+public:
+	void test_row_kernels() {
+		Common::install_null_g_system();
+
+#ifdef SCUMMVM_NEON
+		checkKernels(&Graphics::yuvToRGBNEONFuncs);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			checkKernels(&Graphics::yuvToRGBSSE2Funcs);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			checkKernels(&Graphics::yuvToRGBAVX2Funcs);
+#endif
+
+		Graphics::yuvToRGBFuncs = nullptr;
+	}
+
+	void checkKernels(const Graphics::YUVToRGBFuncs *funcs) {
+		static const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 0, 8, 16, 0)
+		};
+
+		// Odd sizes leave a tail to the lookup tables
+		const int width = 54, height = 6, pitch = 59;
+		byte y[pitch * height], u[pitch * height], v[pitch * height];
+
+		Common::RandomSource rnd("yuv");
+		for (int i = 0; i < pitch * height; i++) {
+			// Include the extremes, where the sums are clipped
+			y[i] = (i & 7) ? rnd.getRandomNumber(255) : (i & 8) * 255 / 8;
+			u[i] = (i % 5) ? rnd.getRandomNumber(255) : (i & 16) * 255 / 16;
+			v[i] = (i % 3) ? rnd.getRandomNumber(255) : (i & 32) * 255 / 32;
+		}
+
+		for (uint f = 0; f < ARRAYSIZE(formats); f++) {
+			for (int scale = 0; scale < 2; scale++) {
+				for (int subsampling = 0; subsampling < 3; subsampling++) {
+					Graphics::Surface expected, actual;
+					expected.create(width, height, formats[f]);
+					actual.create(width, height, formats[f]);
+
+					Graphics::yuvToRGBFuncs = &Graphics::yuvToRGBGenericFuncs;
+					convert(&expected, (Graphics::YUVToRGBManager::LuminanceScale)scale, subsampling, y, u, v, width, height, pitch);
+					Graphics::yuvToRGBFuncs = funcs;
+					convert(&actual, (Graphics::YUVToRGBManager::LuminanceScale)scale, subsampling, y, u, v, width, height, pitch);
+
+					TS_ASSERT_EQUALS(memcmp(expected.getPixels(), actual.getPixels(), height * expected.pitch), 0);
+
+					expected.free();
+					actual.free();
+				}
+			}
+		}
+	}
+
+	void convert(Graphics::Surface *dst, Graphics::YUVToRGBManager::LuminanceScale scale, int subsampling,
+			const byte *y, const byte *u, const byte *v, int width, int height, int pitch) {
+		if (subsampling == 0)
+			YUVToRGBMan.convert444(dst, scale, y, u, v, width, height, pitch, pitch);
+		else if (subsampling == 1)
+			YUVToRGBMan.convert422(dst, scale, y, u, v, width, height, pitch, pitch);
+		else
+			YUVToRGBMan.convert420(dst, scale, y, u, v, width, height, pitch, pitch);
+	}
+};
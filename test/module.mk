@@ -5,8 +5,8 @@
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/common/formats/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h $(srcdir)/test/image/*.h
-TEST_LIBS    :=
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/common/formats/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h $(srcdir)/test/image/*.h $(srcdir)/test/video/*.h $(srcdir)/test/engines/*.h
+TEST_LIBS    := engines/md5cache.o
 
 ifdef POSIX
 TEST_LIBS += test/null_osystem.o \
@@ -16,6 +16,12 @@ TEST_LIBS += test/null_osystem.o \
 	backends/fs/abstract-fs.o \
 	backends/fs/stdiostream.o \
 	backends/modular-backend.o
+ifdef HAS_PTHREAD
+TEST_LIBS += backends/jobs/pthread/pthread-jobs.o
+endif
+ifdef HAS_MMAP
+TEST_LIBS += backends/fs/posix/posix-mmapstream.o
+endif
 endif
 
 ifdef WIN32
@@ -28,7 +34,7 @@ TEST_LIBS += test/null_osystem.o \
 	backends/platform/sdl/win32/win32_wrapper.o
 endif
 
-TEST_LIBS +=	audio/libaudio.a math/libmath.a common/formats/libformats.a common/compression/libcompression.a common/libcommon.a image/libimage.a graphics/libgraphics.a
+TEST_LIBS +=	video/libvideo.a audio/libaudio.a math/libmath.a common/formats/libformats.a common/compression/libcompression.a common/libcommon.a image/libimage.a graphics/libgraphics.a
 
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
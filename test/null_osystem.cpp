@@ -17,6 +17,27 @@ void Common::install_null_g_system() {
 	g_system = OSystem_NULL_create(silenceLogs);
 }
 
+namespace {
+
+class OSystem_NULL_WithJobSystem : public OSystem_NULL {
+public:
+	OSystem_NULL_WithJobSystem(bool silenceLogs, Common::JobSystem *jobSystem) : OSystem_NULL(silenceLogs) {
+		_jobSystem = jobSystem;
+	}
+};
+
+} // End of anonymous namespace
+
+void Common::install_null_g_system(Common::JobSystem *jobSystem) {
+#ifdef DISPLAY_ERROR_MESSAGES
+	const bool silenceLogs = false;
+#else
+	const bool silenceLogs = true;
+#endif
+
+	g_system = new OSystem_NULL_WithJobSystem(silenceLogs, jobSystem);
+}
+
 void OSystem_NULL::quit() {
 	abort();
 }
@@ -1,8 +1,12 @@
 #ifndef TEST_NULL_OSYSTEM
 #define TEST_NULL_OSYSTEM 1
 namespace Common {
+class JobSystem;
+
 #if defined(POSIX) || defined(WIN32)
 void install_null_g_system();
+// Like install_null_g_system(), g_system then owns jobSystem and returns it from getJobSystem()
+void install_null_g_system(JobSystem *jobSystem);
 #define NULL_OSYSTEM_IS_AVAILABLE 1
 #else
 #define NULL_OSYSTEM_IS_AVAILABLE 0
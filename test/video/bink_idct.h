@@ -0,0 +1,95 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#ifdef USE_BINK
+
+#include "common/random.h"
+#include "video/bink_decoder_intern.h"
+
+class BinkIDCTTestSuite : public CxxTest::TestSuite {
+public:
+	void test_idct_kernels() {
+#ifdef SCUMMVM_NEON
+		checkKernels(Video::binkIDCTNEONFuncs);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			checkKernels(Video::binkIDCTSSE2Funcs);
+#endif
+	}
+
+private:
+	enum {
+		kPitch = 24
+	};
+
+	void checkKernels(const Video::BinkIDCTFuncs &funcs) {
+		const Video::BinkIDCTFuncs &generic = Video::binkIDCTGenericFuncs;
+		Common::RandomSource rnd("binkidct");
+
+		int32 coefs[64], expected[64], actual[64];
+		byte expectedPixels[8 * kPitch], actualPixels[8 * kPitch];
+
+		for (int iter = 0; iter < 2000; iter++) {
+			makeBlock(rnd, iter, coefs);
+
+			memcpy(expected, coefs, sizeof(coefs));
+			memcpy(actual, coefs, sizeof(coefs));
+			generic.idct(expected);
+			funcs.idct(actual);
+			TS_ASSERT_EQUALS(memcmp(actual, expected, sizeof(expected)), 0);
+
+			// The pixels around the block must stay untouched
+			for (int i = 0; i < ARRAYSIZE(expectedPixels); i++)
+				expectedPixels[i] = actualPixels[i] = rnd.getRandomNumber(255);
+
+			memcpy(expected, coefs, sizeof(coefs));
+			memcpy(actual, coefs, sizeof(coefs));
+			generic.put(expectedPixels + 8, kPitch, expected);
+			funcs.put(actualPixels + 8, kPitch, actual);
+			TS_ASSERT_EQUALS(memcmp(actualPixels, expectedPixels, sizeof(expectedPixels)), 0);
+
+			memcpy(expected, coefs, sizeof(coefs));
+			memcpy(actual, coefs, sizeof(coefs));
+			generic.add(expectedPixels + 8, kPitch, expected);
+			funcs.add(actualPixels + 8, kPitch, actual);
+			TS_ASSERT_EQUALS(memcmp(actualPixels, expectedPixels, sizeof(expectedPixels)), 0);
+		}
+	}
+
+	/**
+	 * Fill a block with coefficients. Most blocks are sparse, like the ones
+	 * in actual videos, which takes the shortcut for columns without AC
+	 * coefficients. Others use the full range of dequantized values.
+	 */
+	void makeBlock(Common::RandomSource &rnd, int iter, int32 *coefs) {
+		memset(coefs, 0, 64 * sizeof(int32));
+
+		switch (iter % 4) {
+		case 0:
+			// DC only
+			coefs[0] = (int32)rnd.getRandomNumber(4095) - 2048;
+			break;
+		case 1:
+			// A few coefficients
+			for (int i = rnd.getRandomNumber(5); i >= 0; i--)
+				coefs[rnd.getRandomNumber(63)] = (int32)rnd.getRandomNumber(1023) - 512;
+			break;
+		case 2:
+			// Only the first row, which leaves every column without AC
+			for (int i = 0; i < 8; i++)
+				coefs[i] = (int32)rnd.getRandomNumber(4095) - 2048;
+			break;
+		default:
+			for (int i = 0; i < 64; i++)
+				coefs[i] = (int32)rnd.getRandomNumber(65535) - 32768;
+			break;
+		}
+	}
+};
+
+#endif
@@ -0,0 +1,238 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/jobsystem.h"
+#include "graphics/surface.h"
+#include "video/video_decoder.h"
+
+#include "../null_osystem.h"
+
+/**
+ * A job system with one pretend worker, which only runs the submitted jobs
+ * when told to. This makes the jobs of the read-ahead queue observable
+ * while they would still be running.
+ */
+class DeferredJobSystem : public Common::JobSystem {
+public:
+	uint getWorkerCount() const override { return 1; }
+
+	void submit(JobGroup &group, JobProc proc, void *refCon, uint index = 0) override {
+		Job job;
+		job.proc = proc;
+		job.refCon = refCon;
+		job.index = index;
+		_jobs.push_back(job);
+	}
+
+	void wait(JobGroup &group) override {
+		runPending();
+	}
+
+	void runPending() {
+		while (!_jobs.empty()) {
+			Job job = _jobs.front();
+			_jobs.remove_at(0);
+			job.proc(job.refCon, job.index);
+		}
+	}
+
+	bool hasPending() const { return !_jobs.empty(); }
+
+private:
+	struct Job {
+		JobProc proc;
+		void *refCon;
+		uint index;
+	};
+
+	Common::Array<Job> _jobs;
+};
+
+/**
+ * A decoder for a seekable video whose frames are filled with their number.
+ * Its track records whether it was changed while a read-ahead job was still
+ * pending.
+ */
+class ReadAheadTestDecoder : public Video::VideoDecoder {
+public:
+	ReadAheadTestDecoder(const DeferredJobSystem &jobs) : _jobs(jobs), _track(nullptr), _changedWhileDecoding(false) {}
+	~ReadAheadTestDecoder() override { close(); }
+
+	bool loadStream(Common::SeekableReadStream *stream) override {
+		close();
+		_track = new CounterVideoTrack(*this);
+		addTrack(_track);
+		return true;
+	}
+
+	void close() override {
+		VideoDecoder::close();
+		_track = nullptr;
+	}
+
+	uint getDecodeCount() const { return _track ? _track->getDecodeCount() : 0; }
+	bool isTrackPaused() const { return _track && _track->isPaused(); }
+	bool changedWhileDecoding() const { return _changedWhileDecoding; }
+
+protected:
+	bool supportsReadAhead() const override { return true; }
+
+private:
+	void trackChanged() {
+		if (_jobs.hasPending())
+			_changedWhileDecoding = true;
+	}
+
+	class CounterVideoTrack : public FixedRateVideoTrack {
+	public:
+		CounterVideoTrack(ReadAheadTestDecoder &decoder) : _decoder(decoder), _curFrame(-1), _decodeCount(0), _reversed(false) {
+			_surface.create(4, 4, Graphics::PixelFormat::createFormatCLUT8());
+		}
+		~CounterVideoTrack() override {
+			_decoder.trackChanged();
+			_surface.free();
+		}
+
+		bool isSeekable() const override { return true; }
+		bool seek(const Audio::Timestamp &time) override {
+			_decoder.trackChanged();
+			_curFrame = getFrameAtTime(time) - 1;
+			return true;
+		}
+
+		uint16 getWidth() const override { return _surface.w; }
+		uint16 getHeight() const override { return _surface.h; }
+		Graphics::PixelFormat getPixelFormat() const override { return _surface.format; }
+		int getCurFrame() const override { return _curFrame; }
+		int getFrameCount() const override { return 20; }
+
+		bool setReverse(bool reverse) override {
+			_decoder.trackChanged();
+			_reversed = reverse;
+			return true;
+		}
+		bool isReversed() const override { return _reversed; }
+
+		const Graphics::Surface *decodeNextFrame() override {
+			_curFrame += _reversed ? -1 : 1;
+			_decodeCount++;
+			_surface.fillRect(Common::Rect(_surface.w, _surface.h), _curFrame);
+			return &_surface;
+		}
+
+		uint getDecodeCount() const { return _decodeCount; }
+
+	protected:
+		Common::Rational getFrameRate() const override { return 10; }
+		void pauseIntern(bool shouldPause) override { _decoder.trackChanged(); }
+
+	private:
+		ReadAheadTestDecoder &_decoder;
+		Graphics::Surface _surface;
+		int _curFrame;
+		uint _decodeCount;
+		bool _reversed;
+	};
+
+	const DeferredJobSystem &_jobs;
+	CounterVideoTrack *_track;
+	bool _changedWhileDecoding;
+};
+
+class VideoReadAheadTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+		_jobs = new DeferredJobSystem();
+		Common::install_null_g_system(_jobs);
+	}
+
+	void tearDown() {
+		Common::install_null_g_system();
+	}
+
+	void test_pause_seek_close() {
+		ReadAheadTestDecoder decoder(*_jobs);
+		TS_ASSERT(decoder.loadStream(nullptr));
+		TS_ASSERT(decoder.setReadAhead(4));
+
+		// The first frame is decoded right away, the worker fills the queue
+		checkFrame(decoder, 0);
+		TS_ASSERT(_jobs->hasPending());
+		_jobs->runPending();
+		TS_ASSERT_EQUALS(decoder.getDecodeCount(), 5u);
+
+		checkFrame(decoder, 1);
+		TS_ASSERT(_jobs->hasPending());
+
+		// Pausing waits for the worker and keeps the queued frames
+		decoder.pauseVideo(true);
+		TS_ASSERT(decoder.isTrackPaused());
+		decoder.pauseVideo(false);
+		TS_ASSERT(!decoder.isTrackPaused());
+		TS_ASSERT_EQUALS(decoder.getDecodeCount(), 5u);
+
+		checkFrame(decoder, 2);
+		checkFrame(decoder, 3);
+		TS_ASSERT_EQUALS(decoder.getDecodeCount(), 5u);
+
+		// Seeking drops them
+		TS_ASSERT(decoder.seekToFrame(10));
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 9);
+		checkFrame(decoder, 10);
+		_jobs->runPending();
+		checkFrame(decoder, 11);
+		TS_ASSERT(_jobs->hasPending());
+
+		// The worker must not run on closed tracks
+		decoder.close();
+		TS_ASSERT(!_jobs->hasPending());
+		TS_ASSERT(!decoder.changedWhileDecoding());
+	}
+
+	void test_end_of_video() {
+		ReadAheadTestDecoder decoder(*_jobs);
+		TS_ASSERT(decoder.loadStream(nullptr));
+		TS_ASSERT(decoder.setReadAhead(4));
+
+		for (int i = 0; i < 20; i++) {
+			TS_ASSERT(!decoder.endOfVideo());
+			checkFrame(decoder, i);
+			_jobs->runPending();
+		}
+
+		TS_ASSERT(decoder.endOfVideo());
+		TS_ASSERT_EQUALS(decoder.getDecodeCount(), 20u);
+		TS_ASSERT(!decoder.changedWhileDecoding());
+	}
+
+	void test_reverse() {
+		ReadAheadTestDecoder decoder(*_jobs);
+		TS_ASSERT(decoder.loadStream(nullptr));
+		TS_ASSERT(decoder.setReadAhead(4));
+
+		checkFrame(decoder, 0);
+		_jobs->runPending();
+		checkFrame(decoder, 1);
+		checkFrame(decoder, 2);
+
+		// The frames decoded ahead are dropped, and the track goes back to
+		// the last frame returned
+		TS_ASSERT(decoder.setReverse(true));
+		TS_ASSERT(!_jobs->hasPending());
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 2);
+		checkFrame(decoder, 1);
+		checkFrame(decoder, 0);
+		TS_ASSERT(!decoder.changedWhileDecoding());
+	}
+
+private:
+	void checkFrame(ReadAheadTestDecoder &decoder, int frame) {
+		const Graphics::Surface *surface = decoder.decodeNextFrame();
+		TS_ASSERT(surface != nullptr);
+		if (surface)
+			TS_ASSERT_EQUALS(*(const byte *)surface->getPixels(), (byte)frame);
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), frame);
+	}
+
+	DeferredJobSystem *_jobs;
+};
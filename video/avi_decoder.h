@@ -103,6 +103,7 @@ protected:
 	void readNextPacket();
 	bool seekIntern(const Audio::Timestamp &time);
 	bool supportsAudioTrackSwitching() const { return true; }
+	bool supportsReadAhead() const { return !_transparencyTrack.track; }
 	AudioTrack *getAudioTrack(int index);
 
 	/**
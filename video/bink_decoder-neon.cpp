@@ -0,0 +1,167 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "video/bink_decoder_intern.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+namespace Video {
+
+// One-dimensional transform of four lanes at once, see IDCT_TRANSFORM.
+static FORCEINLINE void neon_transform(int32x4_t *s) {
+	const int32x4_t a0 = vaddq_s32(s[0], s[4]);
+	const int32x4_t a1 = vsubq_s32(s[0], s[4]);
+	const int32x4_t a2 = vaddq_s32(s[2], s[6]);
+	const int32x4_t a3 = vshrq_n_s32(vmulq_n_s32(vsubq_s32(s[2], s[6]), 2896), 11);
+	const int32x4_t a4 = vaddq_s32(s[5], s[3]);
+	const int32x4_t a5 = vsubq_s32(s[5], s[3]);
+	const int32x4_t a6 = vaddq_s32(s[1], s[7]);
+	const int32x4_t a7 = vsubq_s32(s[1], s[7]);
+	const int32x4_t b0 = vaddq_s32(a4, a6);
+	const int32x4_t b1 = vshrq_n_s32(vmulq_n_s32(vaddq_s32(a5, a7), 3784), 11);
+	const int32x4_t b2 = vaddq_s32(vsubq_s32(vshrq_n_s32(vmulq_n_s32(a5, -5352), 11), b0), b1);
+	const int32x4_t b3 = vsubq_s32(vshrq_n_s32(vmulq_n_s32(vsubq_s32(a6, a4), 2896), 11), b2);
+	const int32x4_t b4 = vsubq_s32(vaddq_s32(vshrq_n_s32(vmulq_n_s32(a7, 2217), 11), b3), b1);
+	const int32x4_t c0 = vaddq_s32(a0, a2);
+	const int32x4_t c1 = vsubq_s32(a0, a2);
+	const int32x4_t c2 = vsubq_s32(vaddq_s32(a1, a3), a2);
+	const int32x4_t c3 = vaddq_s32(vsubq_s32(a1, a3), a2);
+	s[0] = vaddq_s32(c0, b0);
+	s[1] = vaddq_s32(c2, b2);
+	s[2] = vaddq_s32(c3, b3);
+	s[3] = vsubq_s32(c1, b4);
+	s[4] = vaddq_s32(c1, b4);
+	s[5] = vsubq_s32(c3, b3);
+	s[6] = vsubq_s32(c2, b2);
+	s[7] = vsubq_s32(c0, b0);
+}
+
+static FORCEINLINE void neon_transpose(int32x4_t *r) {
+	const int32x4x2_t t0 = vtrnq_s32(r[0], r[1]);
+	const int32x4x2_t t1 = vtrnq_s32(r[2], r[3]);
+	r[0] = vcombine_s32(vget_low_s32(t0.val[0]), vget_low_s32(t1.val[0]));
+	r[1] = vcombine_s32(vget_low_s32(t0.val[1]), vget_low_s32(t1.val[1]));
+	r[2] = vcombine_s32(vget_high_s32(t0.val[0]), vget_high_s32(t1.val[0]));
+	r[3] = vcombine_s32(vget_high_s32(t0.val[1]), vget_high_s32(t1.val[1]));
+}
+
+// Runs the column pass, then transposes the block so that the row pass is
+// done across lanes as well. On return, out[2 * i] and out[2 * i + 1] hold
+// the left and right half of row i.
+static FORCEINLINE void neon_idct(const int32 *block, int32x4_t *out) {
+	int32x4_t left[8], right[8];
+	for (int i = 0; i < 8; i++) {
+		left[i]  = vld1q_s32(block + 8 * i);
+		right[i] = vld1q_s32(block + 8 * i + 4);
+	}
+
+	neon_transform(left);
+	neon_transform(right);
+
+	// top[j] and bottom[j] hold column j of rows 0-3 and 4-7
+	int32x4_t top[8] = { left[0], left[1], left[2], left[3], right[0], right[1], right[2], right[3] };
+	int32x4_t bottom[8] = { left[4], left[5], left[6], left[7], right[4], right[5], right[6], right[7] };
+	neon_transpose(top);
+	neon_transpose(top + 4);
+	neon_transpose(bottom);
+	neon_transpose(bottom + 4);
+
+	neon_transform(top);
+	neon_transform(bottom);
+
+	const int32x4_t round = vdupq_n_s32(0x7F);
+	for (int i = 0; i < 8; i++) {
+		top[i]    = vshrq_n_s32(vaddq_s32(top[i], round), 8);
+		bottom[i] = vshrq_n_s32(vaddq_s32(bottom[i], round), 8);
+	}
+
+	neon_transpose(top);
+	neon_transpose(top + 4);
+	neon_transpose(bottom);
+	neon_transpose(bottom + 4);
+
+	for (int i = 0; i < 4; i++) {
+		out[2 * i]           = top[i];
+		out[2 * i + 1]       = top[i + 4];
+		out[2 * (i + 4)]     = bottom[i];
+		out[2 * (i + 4) + 1] = bottom[i + 4];
+	}
+}
+
+// The low byte of each of the 8 values, like the implicit conversion to byte.
+static FORCEINLINE uint8x8_t neon_toBytes(int32x4_t lo, int32x4_t hi) {
+	return vreinterpret_u8_s8(vmovn_s16(vcombine_s16(vmovn_s32(lo), vmovn_s32(hi))));
+}
+
+static void IDCTNEON(int32 *block) {
+	int32x4_t rows[16];
+	neon_idct(block, rows);
+
+	for (int i = 0; i < 16; i++)
+		vst1q_s32(block + 4 * i, rows[i]);
+}
+
+static void IDCTPutNEON(byte *dest, uint32 pitch, int32 *block) {
+	int32x4_t rows[16];
+	neon_idct(block, rows);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		vst1_u8(dest, neon_toBytes(rows[2 * i], rows[2 * i + 1]));
+}
+
+static void IDCTAddNEON(byte *dest, uint32 pitch, int32 *block) {
+	int32x4_t rows[16];
+	neon_idct(block, rows);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		vst1_u8(dest, vadd_u8(vld1_u8(dest), neon_toBytes(rows[2 * i], rows[2 * i + 1])));
+}
+
+const BinkIDCTFuncs binkIDCTNEONFuncs = { IDCTNEON, IDCTPutNEON, IDCTAddNEON };
+
+} // End of namespace Video
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,181 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "video/bink_decoder_intern.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace Video {
+
+// The low 32 bits of x * c for each lane, as SSE2 has no 32-bit mullo.
+static FORCEINLINE __m128i sse2_mul(__m128i x, int32 c) {
+	const __m128i vc = _mm_set1_epi32(c);
+	const __m128i even = _mm_mul_epu32(x, vc);
+	const __m128i odd  = _mm_mul_epu32(_mm_srli_epi64(x, 32), vc);
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static FORCEINLINE __m128i sse2_mulShift(__m128i x, int32 c) {
+	return _mm_srai_epi32(sse2_mul(x, c), 11);
+}
+
+// One-dimensional transform of four lanes at once, see IDCT_TRANSFORM.
+static FORCEINLINE void sse2_transform(__m128i *s) {
+	const __m128i a0 = _mm_add_epi32(s[0], s[4]);
+	const __m128i a1 = _mm_sub_epi32(s[0], s[4]);
+	const __m128i a2 = _mm_add_epi32(s[2], s[6]);
+	const __m128i a3 = sse2_mulShift(_mm_sub_epi32(s[2], s[6]), 2896);
+	const __m128i a4 = _mm_add_epi32(s[5], s[3]);
+	const __m128i a5 = _mm_sub_epi32(s[5], s[3]);
+	const __m128i a6 = _mm_add_epi32(s[1], s[7]);
+	const __m128i a7 = _mm_sub_epi32(s[1], s[7]);
+	const __m128i b0 = _mm_add_epi32(a4, a6);
+	const __m128i b1 = sse2_mulShift(_mm_add_epi32(a5, a7), 3784);
+	const __m128i b2 = _mm_add_epi32(_mm_sub_epi32(sse2_mulShift(a5, -5352), b0), b1);
+	const __m128i b3 = _mm_sub_epi32(sse2_mulShift(_mm_sub_epi32(a6, a4), 2896), b2);
+	const __m128i b4 = _mm_sub_epi32(_mm_add_epi32(sse2_mulShift(a7, 2217), b3), b1);
+	const __m128i c0 = _mm_add_epi32(a0, a2);
+	const __m128i c1 = _mm_sub_epi32(a0, a2);
+	const __m128i c2 = _mm_sub_epi32(_mm_add_epi32(a1, a3), a2);
+	const __m128i c3 = _mm_add_epi32(_mm_sub_epi32(a1, a3), a2);
+	s[0] = _mm_add_epi32(c0, b0);
+	s[1] = _mm_add_epi32(c2, b2);
+	s[2] = _mm_add_epi32(c3, b3);
+	s[3] = _mm_sub_epi32(c1, b4);
+	s[4] = _mm_add_epi32(c1, b4);
+	s[5] = _mm_sub_epi32(c3, b3);
+	s[6] = _mm_sub_epi32(c2, b2);
+	s[7] = _mm_sub_epi32(c0, b0);
+}
+
+static FORCEINLINE void sse2_transpose(__m128i *r) {
+	const __m128i t0 = _mm_unpacklo_epi32(r[0], r[1]);
+	const __m128i t1 = _mm_unpacklo_epi32(r[2], r[3]);
+	const __m128i t2 = _mm_unpackhi_epi32(r[0], r[1]);
+	const __m128i t3 = _mm_unpackhi_epi32(r[2], r[3]);
+	r[0] = _mm_unpacklo_epi64(t0, t1);
+	r[1] = _mm_unpackhi_epi64(t0, t1);
+	r[2] = _mm_unpacklo_epi64(t2, t3);
+	r[3] = _mm_unpackhi_epi64(t2, t3);
+}
+
+// Runs the column pass, then transposes the block so that the row pass is
+// done across lanes as well. On return, out[2 * i] and out[2 * i + 1] hold
+// the left and right half of row i.
+static FORCEINLINE void sse2_idct(const int32 *block, __m128i *out) {
+	__m128i left[8], right[8];
+	for (int i = 0; i < 8; i++) {
+		left[i]  = _mm_loadu_si128((const __m128i *)(block + 8 * i));
+		right[i] = _mm_loadu_si128((const __m128i *)(block + 8 * i + 4));
+	}
+
+	sse2_transform(left);
+	sse2_transform(right);
+
+	// top[j] and bottom[j] hold column j of rows 0-3 and 4-7
+	__m128i top[8] = { left[0], left[1], left[2], left[3], right[0], right[1], right[2], right[3] };
+	__m128i bottom[8] = { left[4], left[5], left[6], left[7], right[4], right[5], right[6], right[7] };
+	sse2_transpose(top);
+	sse2_transpose(top + 4);
+	sse2_transpose(bottom);
+	sse2_transpose(bottom + 4);
+
+	sse2_transform(top);
+	sse2_transform(bottom);
+
+	const __m128i round = _mm_set1_epi32(0x7F);
+	for (int i = 0; i < 8; i++) {
+		top[i]    = _mm_srai_epi32(_mm_add_epi32(top[i], round), 8);
+		bottom[i] = _mm_srai_epi32(_mm_add_epi32(bottom[i], round), 8);
+	}
+
+	sse2_transpose(top);
+	sse2_transpose(top + 4);
+	sse2_transpose(bottom);
+	sse2_transpose(bottom + 4);
+
+	for (int i = 0; i < 4; i++) {
+		out[2 * i]           = top[i];
+		out[2 * i + 1]       = top[i + 4];
+		out[2 * (i + 4)]     = bottom[i];
+		out[2 * (i + 4) + 1] = bottom[i + 4];
+	}
+}
+
+// The low byte of each of the 8 values, like the implicit conversion to byte.
+static FORCEINLINE __m128i sse2_toBytes(__m128i lo, __m128i hi) {
+	const __m128i mask = _mm_set1_epi32(0xFF);
+	const __m128i words = _mm_packs_epi32(_mm_and_si128(lo, mask), _mm_and_si128(hi, mask));
+	return _mm_packus_epi16(words, words);
+}
+
+static void IDCTSSE2(int32 *block) {
+	__m128i rows[16];
+	sse2_idct(block, rows);
+
+	for (int i = 0; i < 16; i++)
+		_mm_storeu_si128((__m128i *)(block + 4 * i), rows[i]);
+}
+
+static void IDCTPutSSE2(byte *dest, uint32 pitch, int32 *block) {
+	__m128i rows[16];
+	sse2_idct(block, rows);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		_mm_storel_epi64((__m128i *)dest, sse2_toBytes(rows[2 * i], rows[2 * i + 1]));
+}
+
+static void IDCTAddSSE2(byte *dest, uint32 pitch, int32 *block) {
+	__m128i rows[16];
+	sse2_idct(block, rows);
+
+	for (int i = 0; i < 8; i++, dest += pitch) {
+		const __m128i pixels = _mm_loadl_epi64((const __m128i *)dest);
+		_mm_storel_epi64((__m128i *)dest, _mm_add_epi8(pixels, sse2_toBytes(rows[2 * i], rows[2 * i + 1])));
+	}
+}
+
+const BinkIDCTFuncs binkIDCTSSE2Funcs = { IDCTSSE2, IDCTPutSSE2, IDCTAddSSE2 };
+
+} // End of namespace Video
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
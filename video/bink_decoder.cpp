@@ -30,12 +30,13 @@
 #include "common/textconsole.h"
 #include "common/intrinsics.h"
 #include "common/stream.h"
-#include "common/substream.h"
+#include "common/memstream.h"
 #include "common/file.h"
 #include "common/str.h"
 #include "common/bitstream.h"
 #include "common/compression/huffman.h"
 #include "common/system.h"
+#include "common/jobsystem.h"
 
 #include "graphics/yuv_to_rgb.h"
 #include "graphics/surface.h"
@@ -45,6 +46,7 @@
 
 #include "video/binkdata.h"
 #include "video/bink_decoder.h"
+#include "video/bink_decoder_intern.h"
 
 static const uint32 kBIKfID = MKTAG('B', 'I', 'K', 'f');
 static const uint32 kBIKgID = MKTAG('B', 'I', 'K', 'g');
@@ -152,6 +154,7 @@ void BinkDecoder::close() {
 
 	_audioTracks.clear();
 	_frames.clear();
+	_packet.clear();
 }
 
 void BinkDecoder::readNextPacket() {
@@ -167,11 +170,29 @@ void BinkDecoder::readNextPacket() {
 
 	uint32 frameSize = frame.size;
 
+	// Get the whole packet into memory, so that its audio and video parts
+	// can be decoded independently of each other and of the file
+	const byte *packet = _bink->tryGetContiguousView(frameSize);
+	if (!packet) {
+		_packet.resize(frameSize);
+		if (_bink->read(_packet.data(), frameSize) != frameSize)
+			error("Bink packet truncated");
+
+		packet = _packet.data();
+	}
+
+	Common::JobSystem *jobSystem = g_system->getJobSystem();
+	Common::JobSystem::JobGroup audioJobs;
+
 	for (uint32 i = 0; i < _audioTracks.size(); i++) {
 		AudioInfo &audio = _audioTracks[i];
 
-		uint32 audioPacketLength = _bink->readUint32LE();
+		if (frameSize < 4)
+			error("Bink packet too small for its audio tracks");
+
+		uint32 audioPacketLength = READ_LE_UINT32(packet);
 
+		packet    += 4;
 		frameSize -= 4;
 
 		if (frameSize < audioPacketLength)
@@ -180,36 +201,37 @@ void BinkDecoder::readNextPacket() {
 		if (audioPacketLength >= 4) {
 			// Get our track - audio index plus one as the first track is video
 			BinkAudioTrack *audioTrack = (BinkAudioTrack *)getTrack(i + 1);
-			uint32 audioPacketStart = _bink->pos();
-			uint32 audioPacketEnd   = _bink->pos() + audioPacketLength;
 
 			//                  Number of samples in bytes
-			audio.sampleCount = _bink->readUint32LE() / (2 * audio.channels);
+			audio.sampleCount = READ_LE_UINT32(packet) / (2 * audio.channels);
 
-			audio.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-					audioPacketStart + 4, audioPacketEnd), DisposeAfterUse::YES);
+			audio.bits = new Common::BitStream32LELSB(new Common::MemoryReadStream(packet + 4,
+					audioPacketLength - 4), DisposeAfterUse::YES);
 
-			audioTrack->decodePacket();
-
-			delete audio.bits;
-			audio.bits = 0;
-
-			_bink->seek(audioPacketEnd);
+			// The audio is decoded while the video frame is, the tracks
+			// only share the packet data
+			jobSystem->submit(audioJobs, [](void *track, uint) {
+				((BinkAudioTrack *)track)->decodePacket();
+			}, audioTrack);
 
+			packet    += audioPacketLength;
 			frameSize -= audioPacketLength;
 		}
 	}
 
-	uint32 videoPacketStart = _bink->pos();
-	uint32 videoPacketEnd   = _bink->pos() + frameSize;
-
-	frame.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-			videoPacketStart, videoPacketEnd), DisposeAfterUse::YES);
+	frame.bits = new Common::BitStream32LELSB(new Common::MemoryReadStream(packet, frameSize), DisposeAfterUse::YES);
 
 	videoTrack->decodePacket(frame);
 
 	delete frame.bits;
 	frame.bits = 0;
+
+	jobSystem->wait(audioJobs);
+
+	for (uint32 i = 0; i < _audioTracks.size(); i++) {
+		delete _audioTracks[i].bits;
+		_audioTracks[i].bits = 0;
+	}
 }
 
 VideoDecoder::AudioTrack *BinkDecoder::getAudioTrack(int index) {
@@ -246,6 +268,8 @@ BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, uint32
 		_frameCount(frameCount), _frameRate(frameRate), _swapPlanes(swapPlanes), _hasAlpha(hasAlpha), _id(id), _surface(nullptr) {
 	_curFrame = -1;
 
+	_idct = getBinkIDCTFuncs();
+
 	for (int i = 0; i < 16; i++)
 		_huffman[i] = 0;
 
@@ -1461,7 +1485,7 @@ static inline void IDCTCol(int32 *dest, const int32 *src) {
 	}
 }
 
-void BinkDecoder::BinkVideoTrack::IDCT(int32 *block) {
+static void IDCTGeneric(int32 *block) {
 	int i;
 	int32 temp[64];
 
@@ -1472,26 +1496,55 @@ void BinkDecoder::BinkVideoTrack::IDCT(int32 *block) {
 	}
 }
 
-void BinkDecoder::BinkVideoTrack::IDCTAdd(DecodeContext &ctx, int32 *block) {
+static void IDCTAddGeneric(byte *dest, uint32 pitch, int32 *block) {
 	int i, j;
 
-	IDCT(block);
-	byte *dest = ctx.dest;
-	for (i = 0; i < 8; i++, dest += ctx.pitch, block += 8)
+	IDCTGeneric(block);
+	for (i = 0; i < 8; i++, dest += pitch, block += 8)
 		for (j = 0; j < 8; j++)
 			 dest[j] += block[j];
 }
 
-void BinkDecoder::BinkVideoTrack::IDCTPut(DecodeContext &ctx, int32 *block) {
+static void IDCTPutGeneric(byte *dest, uint32 pitch, int32 *block) {
 	int i;
 	int32 temp[64];
 	for (i = 0; i < 8; i++)
 		IDCTCol(&temp[i], &block[i]);
 	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&ctx.dest[i*ctx.pitch]), (&temp[8*i]) );
+		IDCT_ROW( (&dest[i*pitch]), (&temp[8*i]) );
 	}
 }
 
+const BinkIDCTFuncs binkIDCTGenericFuncs = { IDCTGeneric, IDCTPutGeneric, IDCTAddGeneric };
+
+const BinkIDCTFuncs *binkIDCTFuncs = nullptr;
+
+const BinkIDCTFuncs *getBinkIDCTFuncs() {
+	if (binkIDCTFuncs)
+		return binkIDCTFuncs;
+
+	binkIDCTFuncs = &binkIDCTGenericFuncs;
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) binkIDCTFuncs = &binkIDCTNEONFuncs;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) binkIDCTFuncs = &binkIDCTSSE2Funcs;
+#endif
+	return binkIDCTFuncs;
+}
+
+void BinkDecoder::BinkVideoTrack::IDCT(int32 *block) {
+	_idct->idct(block);
+}
+
+void BinkDecoder::BinkVideoTrack::IDCTAdd(DecodeContext &ctx, int32 *block) {
+	_idct->add(ctx.dest, ctx.pitch, block);
+}
+
+void BinkDecoder::BinkVideoTrack::IDCTPut(DecodeContext &ctx, int32 *block) {
+	_idct->put(ctx.dest, ctx.pitch, block);
+}
+
 BinkDecoder::BinkAudioTrack::BinkAudioTrack(BinkDecoder::AudioInfo &audio, Audio::Mixer::SoundType soundType) :
 		AudioTrack(soundType),
 		_audioInfo(&audio) {
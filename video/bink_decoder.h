@@ -60,6 +60,8 @@ struct Surface;
 
 namespace Video {
 
+struct BinkIDCTFuncs;
+
 /**
  * Decoder for Bink videos.
  *
@@ -79,6 +81,7 @@ public:
 protected:
 	void readNextPacket();
 	bool supportsAudioTrackSwitching() const { return true; }
+	bool supportsReadAhead() const { return true; }
 	AudioTrack *getAudioTrack(int index);
 	bool seekIntern(const Audio::Timestamp &time);
 	uint32 findKeyFrame(uint32 frame) const;
@@ -281,6 +284,8 @@ private:
 		byte *_curPlanes[4]; ///< The 4 color planes, YUVA, current frame.
 		byte *_oldPlanes[4]; ///< The 4 color planes, YUVA, last frame.
 
+		const BinkIDCTFuncs *_idct; ///< The IDCT kernels to use.
+
 		/** Initialize the bundles. */
 		void initBundles();
 		/** Deinitialize the bundles. */
@@ -381,6 +386,7 @@ private:
 
 	Common::Array<AudioInfo> _audioTracks; ///< All audio tracks.
 	Common::Array<VideoFrame> _frames;      ///< All video frames.
+	Common::Array<byte> _packet;            ///< Current packet, when the stream can't be viewed directly.
 
 	void initAudioTrack(AudioInfo &audio);
 };
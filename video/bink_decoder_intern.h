@@ -0,0 +1,60 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef VIDEO_BINK_DECODER_INTERN_H
+#define VIDEO_BINK_DECODER_INTERN_H
+
+#include "common/scummsys.h"
+
+namespace Video {
+
+/**
+ * The 8x8 inverse DCT kernels of the Bink video decoder. The coefficients
+ * are in row-major order, and the kernels may clobber them.
+ */
+struct BinkIDCTFuncs {
+	/** Transform @p block in place. */
+	void (*idct)(int32 *block);
+	/** Transform @p block and store it into the 8x8 pixels at @p dest. */
+	void (*put)(byte *dest, uint32 pitch, int32 *block);
+	/** Transform @p block and add it to the 8x8 pixels at @p dest. */
+	void (*add)(byte *dest, uint32 pitch, int32 *block);
+};
+
+extern const BinkIDCTFuncs binkIDCTGenericFuncs;
+#ifdef SCUMMVM_NEON
+extern const BinkIDCTFuncs binkIDCTNEONFuncs;
+#endif
+#ifdef SCUMMVM_SSE2
+extern const BinkIDCTFuncs binkIDCTSSE2Funcs;
+#endif
+
+/**
+ * The IDCT kernels used by new Bink video tracks.
+ * If unset, the first track picks the ones best suited to the CPU.
+ */
+extern const BinkIDCTFuncs *binkIDCTFuncs;
+
+const BinkIDCTFuncs *getBinkIDCTFuncs();
+
+} // End of namespace Video
+
+#endif
@@ -28,8 +28,26 @@
 #include "common/file.h"
 #include "common/system.h"
 
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+
 namespace Video {
 
+struct VideoDecoder::ReadAheadFrame {
+	ReadAheadFrame() : hasSurface(false), dirtyPalette(false), curFrame(-1), nextFrameStartTime(0), endOfTrack(false) {}
+	~ReadAheadFrame() { surface.free(); }
+
+	Graphics::Surface surface;
+	bool hasSurface;
+	bool dirtyPalette;
+	byte palette[256 * 3];
+
+	// The state of the track after decoding the frame
+	int curFrame;
+	uint32 nextFrameStartTime;
+	bool endOfTrack;
+};
+
 VideoDecoder::VideoDecoder() {
 	_startTime = 0;
 	_dirtyPalette = false;
@@ -48,9 +66,32 @@ VideoDecoder::VideoDecoder() {
 	_canSetDither = true;
 	_canSetDefaultFormat = true;
 	_videoCodecAccuracy = Image::CodecAccuracy::Default;
+	_readAheadFrames = nullptr;
+	_readAheadFrameCount = 0;
+	_readAheadHead = 0;
+	_readAheadQueued = 0;
+	_readAheadActive = false;
+	_readAheadRunning = false;
+	_readAheadStop = false;
+	_readAheadEnd = false;
+	_readAheadTrack = nullptr;
+	_readAheadCurFrame = -1;
+	_readAheadNextFrameStartTime = 0;
+	_readAheadEndOfTrack = false;
+}
+
+VideoDecoder::~VideoDecoder() {
+	// Subclasses are expected to close the video, which stops the worker
+	flushReadAhead();
+	delete[] _readAheadFrames;
 }
 
 void VideoDecoder::close() {
+	flushReadAhead();
+	delete[] _readAheadFrames;
+	_readAheadFrames = nullptr;
+	_readAheadFrameCount = 0;
+
 	if (isPlaying())
 		stop();
 
@@ -121,6 +162,10 @@ void VideoDecoder::delayMillis(uint msecs) {
 }
 
 void VideoDecoder::pauseVideo(bool pause) {
+	// The worker reads the tracks, so it has to stop before they change.
+	// The frames already decoded ahead are kept.
+	stopReadAheadJob();
+
 	if (pause) {
 		_pauseLevel++;
 
@@ -152,6 +197,8 @@ void VideoDecoder::resetPauseStartTime() {
 }
 
 void VideoDecoder::setVolume(byte volume) {
+	stopReadAheadJob();
+
 	_audioVolume = volume;
 
 	for (auto &track : _tracks)
@@ -160,6 +207,8 @@ void VideoDecoder::setVolume(byte volume) {
 }
 
 void VideoDecoder::setBalance(int8 balance) {
+	stopReadAheadJob();
+
 	_audioBalance = balance;
 
 	for (auto &track : _tracks)
@@ -172,6 +221,8 @@ Audio::Mixer::SoundType VideoDecoder::getSoundType() const {
 }
 
 void VideoDecoder::setSoundType(Audio::Mixer::SoundType soundType) {
+	stopReadAheadJob();
+
 	_soundType = soundType;
 
 	for (auto &track : _tracks)
@@ -212,6 +263,15 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	_canSetDither = false;
 	_canSetDefaultFormat = false;
 
+	if (_readAheadActive || startReadAhead()) {
+		const Graphics::Surface *frame = nextReadAheadFrame();
+		if (_readAheadActive)
+			return frame;
+
+		// All frames decoded ahead were returned and the track has ended,
+		// continue like without read-ahead
+	}
+
 	readNextPacket();
 
 	// If we have no next video track at this point, there shouldn't be
@@ -240,6 +300,10 @@ bool VideoDecoder::setReverse(bool reverse) {
 	// Attempt to make sure all the tracks are in the requested direction
 	for (auto &track : _tracks) {
 		if (track->getTrackType() == Track::kTrackTypeVideo && ((VideoTrack *)track)->isReversed() != reverse) {
+			// Reversing starts from the last frame returned, not from the
+			// last one decoded ahead
+			flushReadAhead(true);
+
 			if (!((VideoTrack *)track)->setReverse(reverse))
 				return false;
 
@@ -257,6 +321,9 @@ const byte *VideoDecoder::getPalette() {
 }
 
 int VideoDecoder::getCurFrame() const {
+	if (_readAheadActive)
+		return _readAheadCurFrame;
+
 	int32 frame = -1;
 
 	for (const auto &track : _tracks)
@@ -302,7 +369,7 @@ uint32 VideoDecoder::getTimeToNextFrame() const {
 		return 0;
 
 	uint32 currentTime = getTime();
-	uint32 nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
+	uint32 nextFrameStartTime = getNextFrameStartTime(_nextVideoTrack);
 
 	if (_nextVideoTrack->isReversed()) {
 		// For reversed videos, we need to handle the time difference the opposite way.
@@ -321,8 +388,16 @@ uint32 VideoDecoder::getTimeToNextFrame() const {
 
 bool VideoDecoder::endOfVideo() const {
 	for (const auto &track : _tracks) {
-		bool videoEndTimeReached = _endTimeSet && track->getTrackType() == Track::kTrackTypeVideo && ((const VideoTrack *)track)->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
+		bool endReached;
+
+		if (track->getTrackType() == Track::kTrackTypeVideo) {
+			const VideoTrack *videoTrack = (const VideoTrack *)track;
+			bool videoEndTimeReached = _endTimeSet && getNextFrameStartTime(videoTrack) >= (uint)_endTime.msecs();
+			endReached = isTrackAtEnd(videoTrack) || (isPlaying() && videoEndTimeReached);
+		} else {
+			endReached = track->endOfTrack();
+		}
+
 		if (!endReached)
 			return false;
 	}
@@ -345,6 +420,8 @@ bool VideoDecoder::rewind() {
 	if (!isRewindable())
 		return false;
 
+	flushReadAhead();
+
 	// Stop all tracks so they can be rewound
 	if (isPlaying())
 		stopAudio();
@@ -379,6 +456,8 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 	if (!isSeekable())
 		return false;
 
+	flushReadAhead();
+
 	// Stop all tracks so they can be seek'ed
 	if (isPlaying())
 		stopAudio();
@@ -445,6 +524,8 @@ void VideoDecoder::stop() {
 	if (!isPlaying())
 		return;
 
+	stopReadAheadJob();
+
 	// Stop audio here so we don't have it affect getTime()
 	stopAudio();
 
@@ -477,6 +558,8 @@ void VideoDecoder::setRate(const Common::Rational &rate) {
 		return;
 	}
 
+	stopReadAheadJob();
+
 	Common::Rational targetRate = rate;
 
 	if (hasAudio()) {
@@ -577,12 +660,37 @@ bool VideoDecoder::setOutputPixelFormats(const Common::List<Graphics::PixelForma
 void VideoDecoder::setVideoCodecAccuracy(Image::CodecAccuracy accuracy) {
 	_videoCodecAccuracy = accuracy;
 
+	// The frames already decoded ahead are kept
+	stopReadAheadJob();
+
 	for (Track *track : _tracks) {
 		if (track->getTrackType() == Track::kTrackTypeVideo)
 			static_cast<VideoTrack *>(track)->setCodecAccuracy(accuracy);
 	}
 }
 
+bool VideoDecoder::setReadAhead(uint frames) {
+	// If a frame was already decoded, we can't set it now.
+	if (!_canSetDefaultFormat)
+		return false;
+
+	if (frames != 0) {
+		if (!supportsReadAhead() || g_system->getJobSystem()->getWorkerCount() == 0)
+			return false;
+
+		uint videoTracks = 0;
+		for (const auto &track : _tracks)
+			if (track->getTrackType() == Track::kTrackTypeVideo)
+				videoTracks++;
+
+		if (videoTracks != 1)
+			return false;
+	}
+
+	_readAheadFrameCount = frames;
+	return true;
+}
+
 VideoDecoder::Track::Track() {
 	_paused = false;
 }
@@ -806,6 +914,8 @@ bool VideoDecoder::StreamFileAudioTrack::loadFromFile(const Common::Path &baseNa
 }
 
 void VideoDecoder::addTrack(Track *track, bool isExternal) {
+	stopReadAheadJob();
+
 	_tracks.push_back(track);
 
 	if (isExternal)
@@ -882,6 +992,8 @@ bool VideoDecoder::setAudioTrack(int index) {
 	if (_mainAudioTrack == audioTrack)
 		return true;
 
+	stopReadAheadJob();
+
 	_mainAudioTrack->setMute(true);
 	audioTrack->setMute(false);
 	_mainAudioTrack = audioTrack;
@@ -899,6 +1011,8 @@ uint VideoDecoder::getAudioTrackCount() const {
 }
 
 void VideoDecoder::setEndTime(const Audio::Timestamp &endTime) {
+	stopReadAheadJob();
+
 	Audio::Timestamp startTime = 0;
 
 	if (isPlaying()) {
@@ -948,7 +1062,8 @@ void VideoDecoder::setEndFrame(uint frame) {
 
 void VideoDecoder::resetStartTime() {
 	if (_nextVideoTrack) {
-		Audio::Timestamp curTime = _nextVideoTrack->getFrameTime(_nextVideoTrack->getCurFrame());
+		int curFrame = _readAheadActive ? _readAheadCurFrame : _nextVideoTrack->getCurFrame();
+		Audio::Timestamp curTime = _nextVideoTrack->getFrameTime(curFrame);
 		if (isPlaying()) {
 			_startTime = g_system->getMillis() - (curTime.msecs() / _playbackRate).toInt();
 		}
@@ -971,7 +1086,7 @@ const VideoDecoder::Track *VideoDecoder::getTrack(uint track) const {
 
 bool VideoDecoder::endOfVideoTracks() const {
 	for (const auto &track : _tracks)
-		if (track->getTrackType() == Track::kTrackTypeVideo && !track->endOfTrack())
+		if (track->getTrackType() == Track::kTrackTypeVideo && !isTrackAtEnd((const VideoTrack *)track))
 			return false;
 
 	return true;
@@ -1038,8 +1153,8 @@ bool VideoDecoder::hasFramesLeft() const {
 
 		const VideoTrack *videoTrack = (const VideoTrack *)track;
 
-		bool videoEndTimeReached = _endTimeSet && videoTrack->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = videoTrack->endOfTrack() || (isPlaying() && videoEndTimeReached);
+		bool videoEndTimeReached = _endTimeSet && getNextFrameStartTime(videoTrack) >= (uint)_endTime.msecs();
+		bool endReached = isTrackAtEnd(videoTrack) || (isPlaying() && videoEndTimeReached);
 		if (!endReached)
 			return true;
 	}
@@ -1056,6 +1171,11 @@ bool VideoDecoder::hasAudio() const {
 }
 
 void VideoDecoder::eraseTrack(Track *track) {
+	if (track == _readAheadTrack)
+		flushReadAhead();
+	else
+		stopReadAheadJob();
+
 	for (uint idx = 0; idx < _externalTracks.size(); ++idx) {
 		if (_externalTracks[idx] == track)
 			_externalTracks.remove_at(idx);
@@ -1072,4 +1192,174 @@ void VideoDecoder::eraseTrack(Track *track) {
 	}
 }
 
+bool VideoDecoder::startReadAhead() {
+	if (_readAheadFrameCount == 0 || !_nextVideoTrack || _nextVideoTrack->isReversed())
+		return false;
+
+	if (!_readAheadFrames)
+		_readAheadFrames = new ReadAheadFrame[_readAheadFrameCount + 1];
+
+	// The job decodes the frames, so set up the conversion of YUV frames
+	// here, on the main thread
+	YUVToRGBMan.prepare(_nextVideoTrack->getPixelFormat());
+
+	_readAheadTrack = _nextVideoTrack;
+	_readAheadCurFrame = _readAheadTrack->getCurFrame();
+	_readAheadNextFrameStartTime = _readAheadTrack->getNextFrameStartTime();
+	_readAheadEndOfTrack = _readAheadTrack->endOfTrack();
+	_readAheadHead = 0;
+	_readAheadQueued = 0;
+	_readAheadEnd = _readAheadEndOfTrack;
+	_readAheadActive = true;
+	return true;
+}
+
+const Graphics::Surface *VideoDecoder::nextReadAheadFrame() {
+	_readAheadMutex.lock();
+	uint queued = _readAheadQueued;
+	_readAheadMutex.unlock();
+
+	if (queued == 0) {
+		// The worker is behind, let it finish its current frame or decode one here
+		stopReadAheadJob();
+
+		if (_readAheadQueued == 0 && !_readAheadEnd) {
+			ReadAheadFrame &frame = _readAheadFrames[_readAheadHead];
+			decodeReadAheadFrame(frame);
+			_readAheadQueued = 1;
+			_readAheadEnd = frame.endOfTrack;
+		}
+
+		if (_readAheadQueued == 0) {
+			// Everything was returned, the view of the track is current again
+			_readAheadActive = false;
+			return nullptr;
+		}
+	}
+
+	ReadAheadFrame &frame = _readAheadFrames[_readAheadHead];
+
+	_readAheadCurFrame = frame.curFrame;
+	_readAheadNextFrameStartTime = frame.nextFrameStartTime;
+	_readAheadEndOfTrack = frame.endOfTrack;
+	_nextVideoTrack = frame.endOfTrack ? nullptr : _readAheadTrack;
+
+	if (frame.dirtyPalette) {
+		memcpy(_readAheadPalette, frame.palette, sizeof(_readAheadPalette));
+		_palette = _readAheadPalette;
+		_dirtyPalette = true;
+	}
+
+	// Keep the returned frame out of the ring until the next call, and
+	// restart the worker if it stopped on a full ring
+	bool startJob;
+
+	_readAheadMutex.lock();
+	_readAheadHead = (_readAheadHead + 1) % (_readAheadFrameCount + 1);
+	_readAheadQueued--;
+	startJob = !_readAheadRunning && !_readAheadEnd;
+	if (startJob)
+		_readAheadRunning = true;
+	_readAheadMutex.unlock();
+
+	if (startJob)
+		g_system->getJobSystem()->submit(_readAheadJobs, readAheadProc, this);
+
+	return frame.hasSurface ? &frame.surface : nullptr;
+}
+
+void VideoDecoder::decodeReadAheadFrame(ReadAheadFrame &frame) {
+	readNextPacket();
+
+	const Graphics::Surface *surface = _readAheadTrack->decodeNextFrame();
+
+	frame.hasSurface = (surface != nullptr);
+	if (surface) {
+		if (frame.surface.w == surface->w && frame.surface.h == surface->h && frame.surface.format == surface->format)
+			frame.surface.copyRectToSurface(*surface, 0, 0, Common::Rect(surface->w, surface->h));
+		else
+			frame.surface.copyFrom(*surface);
+	}
+
+	frame.dirtyPalette = _readAheadTrack->hasDirtyPalette();
+	if (frame.dirtyPalette)
+		memcpy(frame.palette, _readAheadTrack->getPalette(), sizeof(frame.palette));
+
+	frame.curFrame = _readAheadTrack->getCurFrame();
+	frame.nextFrameStartTime = _readAheadTrack->getNextFrameStartTime();
+	frame.endOfTrack = _readAheadTrack->endOfTrack();
+}
+
+void VideoDecoder::readAheadFrames() {
+	for (;;) {
+		uint index;
+
+		{
+			Common::StackLock lock(_readAheadMutex);
+			if (_readAheadStop || _readAheadEnd || _readAheadQueued >= _readAheadFrameCount) {
+				_readAheadRunning = false;
+				return;
+			}
+
+			index = (_readAheadHead + _readAheadQueued) % (_readAheadFrameCount + 1);
+		}
+
+		ReadAheadFrame &frame = _readAheadFrames[index];
+		decodeReadAheadFrame(frame);
+
+		Common::StackLock lock(_readAheadMutex);
+		_readAheadQueued++;
+		_readAheadEnd = frame.endOfTrack;
+	}
+}
+
+void VideoDecoder::readAheadProc(void *refCon, uint index) {
+	((VideoDecoder *)refCon)->readAheadFrames();
+}
+
+void VideoDecoder::stopReadAheadJob() {
+	if (!_readAheadActive)
+		return;
+
+	_readAheadMutex.lock();
+	_readAheadStop = true;
+	_readAheadMutex.unlock();
+
+	g_system->getJobSystem()->wait(_readAheadJobs);
+	_readAheadStop = false;
+}
+
+void VideoDecoder::flushReadAhead(bool seekTrack) {
+	stopReadAheadJob();
+
+	// The track is ahead by the frames still queued. When no seek follows,
+	// bring it back to the frame after the last one returned.
+	if (seekTrack && _readAheadActive && _readAheadTrack->getCurFrame() != _readAheadCurFrame) {
+		Audio::Timestamp time = _readAheadTrack->getFrameTime(_readAheadCurFrame + 1);
+		if (time < 0)
+			time = Audio::Timestamp(_readAheadNextFrameStartTime, 1000);
+
+		if (!seekIntern(time))
+			warning("Could not seek the video track back to frame %d", _readAheadCurFrame + 1);
+	}
+
+	_readAheadActive = false;
+	_readAheadQueued = 0;
+	_readAheadEnd = false;
+}
+
+bool VideoDecoder::isTrackAtEnd(const VideoTrack *track) const {
+	if (_readAheadActive && track == _readAheadTrack)
+		return _readAheadEndOfTrack;
+
+	return track->endOfTrack();
+}
+
+uint32 VideoDecoder::getNextFrameStartTime(const VideoTrack *track) const {
+	if (_readAheadActive && track == _readAheadTrack)
+		return _readAheadNextFrameStartTime;
+
+	return track->getNextFrameStartTime();
+}
+
 } // End of namespace Video
@@ -25,6 +25,8 @@
 #include "audio/mixer.h"
 #include "audio/timestamp.h"	// TODO: Move this to common/ ?
 #include "common/array.h"
+#include "common/jobsystem.h"
+#include "common/mutex.h"
 #include "common/path.h"
 #include "common/rational.h"
 #include "common/str.h"
@@ -53,7 +55,7 @@ namespace Video {
 class VideoDecoder {
 public:
 	VideoDecoder();
-	virtual ~VideoDecoder() {}
+	virtual ~VideoDecoder();
 
 	/////////////////////////////////////////
 	// Opening/Closing a Video
@@ -419,6 +421,29 @@ public:
 	 */
 	bool setOutputPixelFormats(const Common::List<Graphics::PixelFormat> &formatList);
 
+	/**
+	 * Decode up to the given number of frames ahead of playback on a worker
+	 * thread.
+	 *
+	 * decodeNextFrame() then returns frames which are already decoded, so
+	 * that expensive frames do not stall the caller. The timing, the current
+	 * frame and the palette still follow the frames returned by
+	 * decodeNextFrame().
+	 *
+	 * This only works for decoders supporting it, with a single video track
+	 * played forward, and when the backend provides worker threads. Seeking,
+	 * rewinding or reversing the video drops the frames decoded ahead.
+	 * Pausing the video or changing its audio or rate keeps them, but waits
+	 * for the frame being decoded.
+	 *
+	 * This should be called after loadStream(), but before a decodeNextFrame()
+	 * call. This is enforced.
+	 *
+	 * @param frames The number of frames to decode ahead, 0 to disable
+	 * @return true on success, false otherwise
+	 */
+	bool setReadAhead(uint frames);
+
 	/**
 	 * Set the accuracy of the video decoder
 	 */
@@ -914,6 +939,15 @@ protected:
 	 */
 	virtual bool useAudioSync() const { return true; }
 
+	/**
+	 * Whether readNextPacket() and the video track may decode frames on a
+	 * worker thread, while the main thread keeps querying the tracks and
+	 * playing the audio. See setReadAhead().
+	 *
+	 * A subclass can override this to enable the feature.
+	 */
+	virtual bool supportsReadAhead() const { return false; }
+
 	/**
 	 * Get the given track based on its index.
 	 *
@@ -1038,6 +1072,36 @@ private:
 	Audio::Mixer::SoundType _soundType;
 
 	AudioTrack *_mainAudioTrack;
+
+	// Frames decoded ahead on a worker thread, see setReadAhead()
+	struct ReadAheadFrame;
+	ReadAheadFrame *_readAheadFrames; ///< Ring of the queued frames, plus the one last returned
+	uint _readAheadFrameCount;        ///< Number of queued frames wanted
+	uint _readAheadHead;              ///< Index of the next frame to return
+	uint _readAheadQueued;            ///< Number of decoded frames not returned yet
+	bool _readAheadActive;            ///< Whether the caller's view of the video track lags behind it
+	bool _readAheadRunning;           ///< Whether a worker job is decoding frames
+	bool _readAheadStop;              ///< Whether the worker job should stop after the current frame
+	bool _readAheadEnd;               ///< Whether the last frame of the track was decoded
+	VideoTrack *_readAheadTrack;
+	int _readAheadCurFrame;
+	uint32 _readAheadNextFrameStartTime;
+	bool _readAheadEndOfTrack;
+	byte _readAheadPalette[256 * 3];
+	Common::Mutex _readAheadMutex;
+	Common::JobSystem::JobGroup _readAheadJobs;
+
+	bool startReadAhead();
+	const Graphics::Surface *nextReadAheadFrame();
+	void decodeReadAheadFrame(ReadAheadFrame &frame);
+	void readAheadFrames();
+	void stopReadAheadJob();
+	void flushReadAhead(bool seekTrack = false);
+	static void readAheadProc(void *refCon, uint index);
+
+	// The state of a video track as last returned by decodeNextFrame()
+	bool isTrackAtEnd(const VideoTrack *track) const;
+	uint32 getNextFrameStartTime(const VideoTrack *track) const;
 };
 
 } // End of namespace Video